@@ -0,0 +1,122 @@
+// 学生缓存值编码基准：对比二进制编码与JSON（SAX读取器、nlohmann DOM）的编码、解码耗时与值大小。
+// 用法：codec_bench [迭代次数]，建议以Release构建运行
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "student.h"
+#include "student_codec.h"
+#include "student_json.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // 防止被优化掉的累加结果
+    volatile size_t sink = 0;
+
+    template <typename Body>
+    double nanosPerCall(size_t iterations, Body body)
+    {
+        body();
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            body();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(iterations);
+    }
+
+    void report(const char *format, size_t bytes, double encodeNanos, double decodeNanos)
+    {
+        std::printf("%-16s %5zu B  编码 %8.1f ns  解码 %8.1f ns\n", format, bytes, encodeNanos, decodeNanos);
+    }
+
+    // 二进制编码上线前的JSON缓存值：学生对象末尾附带_soft、_cost刷新字段
+    void appendJsonCacheValue(std::string &out, const Student &student, const CacheStamp &stamp)
+    {
+        appendStudentJson(out, -1, student.getName(), student.getAge(), student.getClassId());
+        out.pop_back();
+        out += ",\"_soft\":";
+        out += std::to_string(stamp.softExpiresAt);
+        out += ",\"_cost\":";
+        out += std::to_string(stamp.loadMillis);
+        out += '}';
+    }
+
+    nlohmann::json toDom(const Student &student, const CacheStamp &stamp)
+    {
+        nlohmann::json value;
+        value["name"] = student.getName();
+        value["age"] = student.getAge();
+        value["className"] = student.getClassName();
+        value["_soft"] = stamp.softExpiresAt;
+        value["_cost"] = stamp.loadMillis;
+        return value;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t iterations = argc > 1 ? static_cast<size_t>(std::stoul(argv[1])) : 1000000;
+
+    const Student student("张三丰", 20, "计算机科学与技术一班");
+    CacheStamp stamp;
+    stamp.softExpiresAt = 1700000000000;
+    stamp.loadMillis = 3;
+
+    std::string out;
+    out.reserve(256);
+    Student decoded;
+    CacheStamp decodedStamp;
+
+    // 二进制编码
+    std::string binary;
+    encodeStudentCache(binary, student.getName(), student.getAge(), student.getClassId(), stamp);
+    double binaryEncode = nanosPerCall(iterations, [&]()
+                                       {
+        out.clear();
+        encodeStudentCache(out, student.getName(), student.getAge(), student.getClassId(), stamp);
+        sink = sink + out.size(); });
+    double binaryDecode = nanosPerCall(iterations, [&]()
+                                       {
+        decodeStudentCache(binary, decoded, &decodedStamp);
+        sink = sink + decoded.getName().size(); });
+    report("binary", binary.size(), binaryEncode, binaryDecode);
+
+    // JSON：拼接写出，旧值经decodeStudentCache交给SAX读取器
+    std::string json;
+    appendJsonCacheValue(json, student, stamp);
+    double jsonEncode = nanosPerCall(iterations, [&]()
+                                     {
+        out.clear();
+        appendJsonCacheValue(out, student, stamp);
+        sink = sink + out.size(); });
+    double jsonDecode = nanosPerCall(iterations, [&]()
+                                     {
+        decodeStudentCache(json, decoded, &decodedStamp);
+        sink = sink + decoded.getName().size(); });
+    report("json (SAX)", json.size(), jsonEncode, jsonDecode);
+
+    // JSON：构建nlohmann::json对象后dump，解析为DOM后取字段
+    std::string dumped = toDom(student, stamp).dump();
+    double domEncode = nanosPerCall(iterations, [&]()
+                                    {
+        std::string text = toDom(student, stamp).dump();
+        sink = sink + text.size(); });
+    double domDecode = nanosPerCall(iterations, [&]()
+                                    {
+        nlohmann::json value = nlohmann::json::parse(dumped);
+        decoded = Student(value["name"].get<std::string>(), value["age"].get<int>(), value["className"].get<std::string>());
+        decodedStamp.softExpiresAt = value["_soft"].get<long long>();
+        decodedStamp.loadMillis = value["_cost"].get<int>();
+        sink = sink + decoded.getName().size(); });
+    report("json (nlohmann)", dumped.size(), domEncode, domDecode);
+
+    if (decoded.getName() != student.getName() || decodedStamp.softExpiresAt != stamp.softExpiresAt)
+    {
+        std::fprintf(stderr, "解码结果与原值不一致\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+// PostgreSQL批量操作基准：对比逐条执行与流水线批量（getStudents/addStudents/deleteStudents）的耗时。
+// 用法：pipeline_bench [配置文件] [行数]，配置文件中database.type应为postgresql。
+// 在本地回环网卡上注入延迟以模拟广域网链路：
+//   sudo tc qdisc add dev lo root netem delay 5ms
+//   sudo tc qdisc del dev lo root   # 测试结束后删除
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "config_manager.h"
+#include "postgresql_database.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMillis(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void report(const char *operation, size_t rows, double singleMillis, double batchMillis)
+    {
+        std::printf("%-8s %6zu 行  逐条 %10.2f ms  批量 %10.2f ms  加速 %6.1fx\n",
+                    operation, rows, singleMillis, batchMillis,
+                    batchMillis > 0 ? singleMillis / batchMillis : 0.0);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string configPath = argc > 1 ? argv[1] : "config.json";
+    size_t rows = argc > 2 ? static_cast<size_t>(std::stoul(argv[2])) : 200;
+
+    ConfigManager configManager(configPath);
+    PostgreSQLDatabase database(configManager);
+    if (!database.open())
+    {
+        std::fprintf(stderr, "无法连接PostgreSQL，请检查 %s 中的database.postgresql配置\n", configPath.c_str());
+        return 1;
+    }
+
+    std::vector<Student> students;
+    students.reserve(rows);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        students.emplace_back("bench_" + std::to_string(i), 18 + static_cast<int>(i % 5), "基准班");
+    }
+
+    // 插入：逐条与单次流水线
+    auto start = Clock::now();
+    std::vector<int> singleIds;
+    singleIds.reserve(rows);
+    for (const Student &student : students)
+    {
+        singleIds.push_back(database.addStudent(student));
+    }
+    double singleInsert = elapsedMillis(start);
+
+    start = Clock::now();
+    std::vector<int> batchIds = database.addStudents(students);
+    double batchInsert = elapsedMillis(start);
+    report("insert", rows, singleInsert, batchInsert);
+
+    // 读取：逐条与多键读取
+    start = Clock::now();
+    for (int id : batchIds)
+    {
+        database.getStudent(id);
+    }
+    double singleGet = elapsedMillis(start);
+
+    start = Clock::now();
+    StudentBatch loaded = database.getStudents(batchIds);
+    double batchGet = elapsedMillis(start);
+    report("get", rows, singleGet, batchGet);
+    if (loaded.size() != rows)
+    {
+        std::fprintf(stderr, "批量读取返回 %zu 行，预期 %zu 行\n", loaded.size(), rows);
+    }
+
+    // 删除：逐条删除第一组，批量删除第二组
+    start = Clock::now();
+    for (int id : singleIds)
+    {
+        database.deleteStudent(id);
+    }
+    double singleDelete = elapsedMillis(start);
+
+    start = Clock::now();
+    int deleted = database.deleteStudents(batchIds);
+    double batchDelete = elapsedMillis(start);
+    report("delete", rows, singleDelete, batchDelete);
+    if (deleted != static_cast<int>(rows))
+    {
+        std::fprintf(stderr, "批量删除 %d 行，预期 %zu 行\n", deleted, rows);
+    }
+
+    database.close();
+    return 0;
+}
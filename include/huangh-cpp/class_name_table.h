@@ -0,0 +1,61 @@
+#ifndef CLASS_NAME_TABLE_H
+#define CLASS_NAME_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <shared_mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+// 进程级班级名称字典：每个班级名称只保存一份，Student、批量结果与快照只保存紧凑的班级id。
+// id 0 固定为空字符串；按id取名称无锁，登记新名称时加锁。
+// id只在本进程内有效，写入Redis或文件时仍使用名称
+class ClassNameTable
+{
+public:
+    static ClassNameTable &instance();
+
+    // 返回班级名称对应的id，首次出现时登记；用于已持久化的名称（数据库、快照、缓存），字典已满时返回0
+    uint32_t intern(std::string_view className);
+
+    // 客户端写请求使用：名称未登记且字典已用量达到kWriteLimit时不登记并返回false，
+    // 剩余容量留给已持久化的名称，客户端提交的大量不同名称不能占满字典
+    bool internForWrite(std::string_view className, uint32_t &id);
+
+    // 返回id对应的名称，引用在进程生命周期内有效；未知id返回空字符串
+    const std::string &name(uint32_t id) const;
+
+    // 预先转义的JSON字符串（含引号），序列化时直接拼接
+    const std::string &json(uint32_t id) const;
+
+    size_t size() const { return count.load(std::memory_order_acquire); }
+
+private:
+    struct Entry
+    {
+        std::string name;
+        std::string json;
+    };
+
+    static constexpr size_t kBlockBits = 10;
+    static constexpr size_t kBlockSize = size_t(1) << kBlockBits;
+    static constexpr size_t kMaxBlocks = 4096;
+    static constexpr size_t kCapacity = kMaxBlocks * kBlockSize;
+    static constexpr size_t kWriteLimit = kCapacity - kCapacity / 4;
+
+    ClassNameTable();
+
+    // 条目按块分配且从不移动，读取方只需原子地读取块指针
+    std::unique_ptr<std::atomic<Entry *>[]> blocks;
+    std::atomic<uint32_t> count;
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string_view, uint32_t> index;
+
+    const Entry &entry(uint32_t id) const;
+    bool tryIntern(std::string_view className, uint32_t &id, size_t limit);
+};
+
+#endif // CLASS_NAME_TABLE_H
@@ -2,10 +2,22 @@
 #define CONFIG_MANAGER_H
 
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
+// PostgreSQL只读副本配置，未配置的字段沿用主库配置
+struct PostgresqlReplicaConfig
+{
+    std::string host;
+    int port;
+    std::string database;
+    std::string username;
+    std::string password;
+    int connectionPoolSize;
+};
+
 class ConfigManager
 {
 private:
@@ -24,6 +36,18 @@ public:
     // SQLite配置
     std::string getSqliteDatabasePath() const;
 
+    // 内存引擎配置
+    std::string getMemoryWalPath() const;
+    std::string getMemorySnapshotPath() const;
+    int getMemorySnapshotInterval() const;
+    int getMemoryGroupCommitWindowUs() const;
+    bool getMemorySyncWrites() const;
+
+    // 分片SQLite配置
+    std::string getShardedDirectory() const;
+    int getShardCount() const;
+    int getShardThreads() const;
+
     // PostgreSQL配置
     std::string getPostgresqlHost() const;
     int getPostgresqlPort() const;
@@ -32,21 +56,67 @@ public:
     std::string getPostgresqlPassword() const;
     int getPostgresqlConnectionPoolSize() const;
     int getPostgresqlConnectionTimeout() const;
+    int getPostgresqlMinPoolSize() const;
+    int getPostgresqlAcquireTimeoutMs() const;
+    int getPostgresqlMaxLifetime() const;
+    int getPostgresqlHealthCheckInterval() const;
+    int getPostgresqlAsyncConnections() const;
+    std::vector<PostgresqlReplicaConfig> getPostgresqlReplicas() const;
+    bool getPostgresqlHedgedReads() const;
+    int getPostgresqlHedgeMinDelayMs() const;
+    bool getPostgresqlListenNotify() const;
+    int getReadYourWritesWindowMs() const;
+
+    // 异步I/O执行器配置
+    int getIoThreads() const;
+    int getIoQueueCapacity() const;
+    int getIoDefaultTimeoutMs() const;
+
+    // 启动快照配置
+    std::string getSnapshotPath() const;
+    int getSnapshotServeWindow() const;
+    int getSnapshotMaxAge() const; // 启动时快照早于该秒数则不使用，0表示不限制
+    int getSnapshotRefreshInterval() const;
 
     // Redis配置
     std::string getRedisHost() const;
     int getRedisPort() const;
     std::string getRedisPassword() const;
     double getRedisTimeout() const;
+    int getRedisPoolSize() const;
+    int getRedisAcquireTimeoutMs() const;
+    bool getRedisAutoPipeline() const;
+    int getRedisPipelineConnections() const;
+    int getRedisPipelineMaxBatch() const;
+    int getRedisBreakerFailureThreshold() const;
+    int getRedisBreakerInitialBackoffMs() const;
+    int getRedisBreakerMaxBackoffMs() const;
+    std::string getRedisClientTracking() const;
+    std::string getRedisTrackingPrefix() const;
 
     // 服务器配置
     std::string getServerHost() const;
     int getServerPort() const;
+    int getCoroutineThreads() const;
+    std::string getServerFrontend() const;
+    int getMaxRequestBytes() const;
+    int getIdleTimeoutSeconds() const; // epoll前端空闲连接超时，0表示不超时
 
     // 缓存配置
     int getStudentCacheExpire() const;
     int getStudentsListCacheExpire() const;
     int getCountCacheExpire() const;
+    int getLocalCacheCapacityMb() const;
+    int getLocalCacheShards() const;
+    int getLocalCacheTtlSeconds() const;
+    double getCacheSoftTtlRatio() const;
+    double getCacheXfetchBeta() const;
+    int getNegativeCacheExpire() const;
+    bool getExistenceFilterEnabled() const;
+    int getWarmupCount() const;
+    int getWarmupBatchSize() const;
+    int getWarmupBudgetMs() const;
+    std::string getWarmupHotIdsPath() const;
 
     // 检查配置是否加载成功
     bool isLoaded() const { return loaded; }
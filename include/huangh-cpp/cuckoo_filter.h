@@ -0,0 +1,50 @@
+#ifndef CUCKOO_FILTER_H
+#define CUCKOO_FILTER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 布谷鸟过滤器：每个桶4个16位指纹，元素可能位于两个候选桶之一。
+// 查询不存在的元素有约万分之一的误判，已插入的元素不会漏判；支持删除，
+// 但只能删除确实插入过的元素，否则可能误删指纹相同的其他元素。
+// 非线程安全，由调用方加锁
+class CuckooFilter
+{
+public:
+    // capacity为预计元素数，桶数按95%装载率向上取整为2的幂
+    explicit CuckooFilter(size_t capacity);
+
+    // 表已满（踢出次数超过上限）时返回false，此时过滤器内容不变
+    bool insert(uint64_t key);
+    bool contains(uint64_t key) const;
+    bool erase(uint64_t key);
+
+    size_t size() const { return count; }
+    size_t capacity() const { return table.size(); }
+    size_t memoryBytes() const { return table.size() * sizeof(uint16_t); }
+
+private:
+    static constexpr size_t kBucketSize = 4;
+    static constexpr int kMaxKicks = 500;
+
+    std::vector<uint16_t> table; // 0表示空位
+    size_t bucketMask;
+    size_t count;
+    uint64_t randomState;
+
+    struct Position
+    {
+        uint16_t fingerprint;
+        size_t first;
+        size_t second;
+    };
+
+    Position locate(uint64_t key) const;
+    size_t alternate(size_t bucket, uint16_t fingerprint) const;
+    bool hasFingerprint(size_t bucket, uint16_t fingerprint) const;
+    bool place(size_t bucket, uint16_t fingerprint);
+    bool remove(size_t bucket, uint16_t fingerprint);
+};
+
+#endif // CUCKOO_FILTER_H
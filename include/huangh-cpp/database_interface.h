@@ -3,7 +3,57 @@
 
 #include <string>
 #include <vector>
+#include <functional>
+#include <nlohmann/json.hpp>
 #include "student.h"
+#include "student_batch.h"
+
+using json = nlohmann::json;
+
+// 学生数据变更事件（由后端变更通知产生）
+struct StudentChangeEvent
+{
+    enum class Operation
+    {
+        Insert,
+        Update,
+        Delete,
+        Resync // 变更可能丢失（监听断开或批量导入），id无意义，需整体失效
+    };
+
+    Operation operation;
+    int id;
+    std::string origin; // 写入方标识
+    bool fromPeer;      // 写入方是否为其他服务实例
+};
+
+using StudentChangeListener = std::function<void(const StudentChangeEvent &)>;
+
+// 批量导入数据源：填充下一条学生记录，返回false表示没有更多数据
+using StudentSource = std::function<bool(Student &student)>;
+
+// 批量导出接收方：返回false表示停止接收
+using StudentSink = std::function<bool(int id, const Student &student)>;
+
+// 读路由提示：作用域内当前线程的读操作应发往主库（用于读己之写）
+class PrimaryReadScope
+{
+public:
+    PrimaryReadScope() { ++depth(); }
+    ~PrimaryReadScope() { --depth(); }
+
+    PrimaryReadScope(const PrimaryReadScope &) = delete;
+    PrimaryReadScope &operator=(const PrimaryReadScope &) = delete;
+
+    static bool active() { return depth() > 0; }
+
+private:
+    static int &depth()
+    {
+        static thread_local int value = 0;
+        return value;
+    }
+};
 
 class DatabaseInterface
 {
@@ -19,11 +69,123 @@ public:
     virtual bool updateStudent(int id, const Student &student) = 0;
     virtual bool deleteStudent(int id) = 0;
     virtual Student getStudent(int id) = 0;
-    virtual std::vector<std::pair<int, Student>> getAllStudents() = 0;
+    virtual StudentBatch getAllStudents() = 0;
     virtual int getStudentCount() = 0;
 
+    // 批量操作（默认逐条执行，后端可覆盖为批量实现）
+    virtual StudentBatch getStudents(const std::vector<int> &ids)
+    {
+        StudentBatch students;
+        students.reserve(ids.size());
+        for (int id : ids)
+        {
+            Student student = getStudent(id);
+            if (student.getName() != "" || student.getAge() > 0 || student.getClassName() != "")
+            {
+                students.add(id, student);
+            }
+        }
+        return students;
+    }
+
+    virtual std::vector<int> addStudents(const std::vector<Student> &students)
+    {
+        std::vector<int> ids;
+        ids.reserve(students.size());
+        for (const auto &student : students)
+        {
+            ids.push_back(addStudent(student));
+        }
+        return ids;
+    }
+
+    virtual int deleteStudents(const std::vector<int> &ids)
+    {
+        int deleted = 0;
+        for (int id : ids)
+        {
+            if (deleteStudent(id))
+            {
+                ++deleted;
+            }
+        }
+        return deleted;
+    }
+
+    // 最大的学生id（表为空时为0），用于校验启动快照；后端未实现或查询失败时返回-1
+    virtual long long getMaxStudentId() { return -1; }
+
     // 表创建
     virtual bool createStudentTable() = 0;
+
+    // 批量导入导出（流式处理，返回处理的记录数，失败返回-1）
+    virtual long long importStudents(const StudentSource &source)
+    {
+        long long imported = 0;
+        Student student;
+        while (source(student))
+        {
+            if (addStudent(student) <= 0)
+            {
+                return -1;
+            }
+            ++imported;
+        }
+        return imported;
+    }
+
+    virtual long long exportStudents(const StudentSink &sink)
+    {
+        long long exported = 0;
+        StudentBatch students = getAllStudents();
+        for (size_t i = 0; i < students.size(); ++i)
+        {
+            ++exported;
+            if (!sink(students.id(i), students.student(i)))
+                break;
+        }
+        return exported;
+    }
+
+    // 异步操作（默认同步执行后立即回调，后端可覆盖为非阻塞实现）
+    virtual void getStudentAsync(int id, std::function<void(Student)> callback)
+    {
+        callback(getStudent(id));
+    }
+
+    virtual void addStudentAsync(const Student &student, std::function<void(int)> callback)
+    {
+        callback(addStudent(student));
+    }
+
+    virtual void updateStudentAsync(int id, const Student &student, std::function<void(bool)> callback)
+    {
+        callback(updateStudent(id, student));
+    }
+
+    virtual void deleteStudentAsync(int id, std::function<void(bool)> callback)
+    {
+        callback(deleteStudent(id));
+    }
+
+    virtual void getAllStudentsAsync(std::function<void(StudentBatch)> callback)
+    {
+        callback(getAllStudents());
+    }
+
+    virtual void getStudentCountAsync(std::function<void(int)> callback)
+    {
+        callback(getStudentCount());
+    }
+
+    // 变更通知（默认不支持，后端可覆盖）
+    virtual void setChangeListener(StudentChangeListener) {}
+
+    // 运行指标（默认无）
+    virtual json getMetrics() const
+    {
+        return json::object();
+    }
 };
 
 #endif // DATABASE_INTERFACE_H
@@ -2,8 +2,21 @@
 #define DATABASE_MANAGER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <future>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <optional>
+#include <chrono>
+#include <atomic>
+#include <array>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <condition_variable>
 #include "student.h"
 #include "logger.h"
 #include "redis_manager.h"
@@ -11,20 +24,212 @@
 #include "database_interface.h"
 #include "sqlite_database.h"
 #include "postgresql_database.h"
+#include "memory_database.h"
+#include "sharded_database.h"
+#include "student_snapshot.h"
+#include "student_cache.h"
+#include "cuckoo_filter.h"
+#include "student_json.h"
+#include "io_executor.h"
+#include "thread_pool.h"
+#include "task.h"
+
+// 学生列表响应缓存的查询结果：generation为查询时的表代数，-1表示不可缓存（Redis不可用或处于读己之写窗口）
+struct StudentListCache
+{
+    bool hit = false;
+    long long generation = -1;
+    std::string body;
+};
 
 class DatabaseManager
 {
 private:
     std::unique_ptr<DatabaseInterface> database;
+    // Redis之前的进程内一级缓存，写路径、变更通知与Redis失效推送负责失效；
+    // 声明在redisManager之前，保证跟踪线程停止前缓存仍然有效
+    StudentCache localCache;
     RedisManager redisManager;
     const ConfigManager *configManager;
 
-    // 缓存相关方法
+    // 缓存相关方法：缓存值带软过期时间，读取到软过期（或按XFetch提前）的值时照常返回并安排后台刷新
     std::string studentToCacheString(const Student &student) const;
-    Student studentFromCacheString(const std::string &cacheStr) const;
+    // 负缓存值解析为空Student并返回true；值损坏时返回false
+    bool studentFromCacheString(int id, std::string_view cacheStr, Student &student);
+    std::string countToCacheString(int count) const;
+    bool countFromCacheString(std::string_view cacheStr, int &count);
+    // 读取并解析单个学生的缓存：未命中时返回空值，命中负缓存时返回空Student
+    std::optional<Student> readStudentCache(int id);
     void clearStudentsCache();
     void clearStudentCache(int id);
+    // 写入Redis缓存，同时失效一级缓存中的旧值
     void updateStudentCache(int id, const Student &student);
+    // 读路径回填Redis与一级缓存：sequence为读取前该id的版本（studentVersion），期间该id有写入或失效时不回填
+    void fillStudentCache(int id, const Student &student, uint64_t sequence);
+    // 将未经Redis GET读取的值（数据库、快照、预热）写入一级缓存；Default跟踪模式下不写入，
+    // 只有GET读取过的键才会收到失效推送
+    void admitLocal(int id, const Student &student, uint64_t sequence);
+
+    // 写路径与失效通知：失效一级缓存，并使进行中的后台刷新放弃回写
+    void forgetStudent(int id);
+    void forgetAllStudents();
+
+    // 处理后端推送的变更事件（其他实例或外部写入方）
+    void onStudentChanged(const StudentChangeEvent &event);
+    // 通知可能丢失（监听重连、批量导入）时整体失效
+    void onStudentsResync(const StudentChangeEvent &event);
+
+    // 处理Redis客户端缓存跟踪推送的失效键
+    void onCacheInvalidated(const std::vector<std::string_view> &keys);
+
+    // 读己之写：记录各客户端最近一次写入时间，窗口内的读请求固定走主库
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> recentWrites;
+    std::mutex recentWritesMutex;
+    std::chrono::milliseconds readYourWritesWindow;
+
+    void recordWrite(const std::string &clientId);
+    bool shouldReadPrimary(const std::string &clientId);
+
+    // 启动快照：冷启动后的服务窗口内由mmap快照提供读取和扫描，
+    // 本地写入或变更通知涉及的id不再从快照读取
+    StudentSnapshot snapshot;
+    std::string snapshotPath;
+    std::chrono::steady_clock::time_point snapshotServeUntil;
+    std::unordered_set<int> snapshotDirty;
+    bool snapshotMembershipChanged;
+    bool snapshotStale;
+    std::mutex snapshotDirtyMutex;
+
+    // 后台定期从数据库导出并重写快照文件
+    std::thread snapshotWriter;
+    std::mutex snapshotWriterMutex;
+    std::condition_variable snapshotWriterCv;
+    bool snapshotWriterRunning;
+
+    void openSnapshot();
+    // 以数据库的记录数与最大id校验快照，不一致或无法校验时快照只用于点查，不用于列表与计数
+    void validateSnapshot();
+    bool servesFromSnapshot() const;
+    bool snapshotClean();
+    bool readFromSnapshot(int id, Student &student);
+    void markSnapshotDirty(int id, bool membershipChanged);
+    void markSnapshotStale();
+    void snapshotWriterLoop();
+    void refreshSnapshot();
+
+    // 软过期后台刷新：Redis TTL为硬过期，软过期为其softTtlRatio；每个键同时只有一个刷新在I/O执行器上运行
+    double softTtlRatio;
+    double xfetchBeta;
+    std::unordered_set<int> refreshingStudents;
+    std::mutex refreshMutex;
+    std::atomic<bool> refreshingCount;
+    // 缓存版本：学生按id哈希分条，写入或失效时先递增对应条目再删除缓存，回填前比较读取前的版本；
+    // 不同id的写入只在落入同一条目时互相影响。数量缓存使用单独的版本
+    static constexpr size_t kCacheVersionStripes = 1024;
+    std::array<std::atomic<uint64_t>, kCacheVersionStripes> studentVersions;
+    std::atomic<uint64_t> countVersion;
+    std::atomic<uint64_t> &studentVersion(int id);
+    std::atomic<int> loadMillis; // 数据库加载耗时的滑动平均
+    std::atomic<uint64_t> cacheRefreshCount;
+
+    CacheStamp makeCacheStamp(int expireSeconds) const;
+    void recordLoadTime(std::chrono::steady_clock::duration elapsed);
+    // observed为触发刷新时读到的缓存值，回写时比较Redis中的当前值，已被其他实例或写路径改写时放弃
+    void scheduleStudentRefresh(int id, std::string_view observed);
+    void scheduleCountRefresh(std::string_view observed);
+    bool refreshStudent(int id, const std::string &observed);
+    bool refreshCount(const std::string &observed);
+
+    // 负缓存与存在性过滤器：数据库确认不存在的id写入短过期的负缓存值；布谷鸟过滤器保存所有存在的id，
+    // 过滤器确定不存在的请求直接返回，不访问Redis与数据库。过滤器在open()后于后台从后端构建，
+    // 由写路径与变更通知维护，只在后端能通知所有写入时启用；构建期间为空，放行所有请求。
+    // 通知可能丢失时（监听重连、批量导入）丢弃过滤器重新构建
+    int negativeExpireSeconds;
+    bool existenceFilterEnabled;
+    std::unique_ptr<CuckooFilter> existenceFilter;
+    mutable std::shared_mutex existenceFilterMutex;
+    bool existenceFilterRebuilding;
+    std::vector<int> existenceFilterPending; // 重建期间新增的id，构建完成后补入
+    uint64_t existenceFilterGeneration;      // 每次请求重建加一，进行中的构建据此判断扫描结果是否已过时
+    std::atomic<uint64_t> filterRejectCount;
+    std::atomic<uint64_t> negativeHitCount;
+
+    bool mayExist(int id);
+    void noteStudentAdded(int id);
+    // 只能对确实存在过的id调用，否则可能误删指纹相同的其他id
+    void noteStudentDeleted(int id);
+    // 立即停用过滤器并在后台重建；已有构建进行中时令其重新扫描
+    void rebuildExistenceFilter();
+    void scheduleExistenceFilterBuild();
+    void buildExistenceFilter();
+    // 数据库未找到学生时写入负缓存；sequence为查询前该id的版本，期间该id有写入时不写
+    void cacheStudentMissing(int id, uint64_t sequence);
+
+    // 启动预热：open()后在后台线程加载上次关闭时记录的热点id（一级缓存中的条目），
+    // 没有记录时加载id最大（最近新增）的warmupCount条；按批读取数据库，以流水线SET NX EX写入Redis
+    // 并填充一级缓存。预热完成或超出时间预算后才报告就绪
+    size_t warmupCount; // 0表示不预热
+    size_t warmupBatchSize;
+    std::chrono::milliseconds warmupBudget;
+    std::string warmupHotIdsPath;
+    std::thread warmupThread;
+    std::atomic<bool> warmupStopping;
+    std::atomic<bool> ready;
+    std::atomic<const char *> warmupSource;
+    std::atomic<uint64_t> warmupLoaded;
+    std::atomic<uint64_t> warmupSkipped;
+    std::atomic<long long> warmupMillis;
+
+    void warmUpCache();
+    std::vector<int> loadHotIds() const;
+    std::vector<int> recentIds(std::chrono::steady_clock::time_point deadline);
+    // 读取一批学生并写入缓存；期间有写入时整批放弃，避免覆盖写路径的更新
+    void warmUpBatch(const std::vector<int> &ids);
+    void saveHotIds() const;
+
+    // 学生列表响应缓存：值为完整的HTTP响应体，键为students:all:<代数>。每次写入提交后代数加一即完成失效，
+    // 旧代数的条目不再被读取，随过期时间清除；代数递增失败时本实例在一个过期周期内不使用列表缓存
+    int listCacheExpire; // 0表示禁用
+    std::atomic<long long> listCacheBypassUntil;
+    std::atomic<uint64_t> listCacheHits;
+    std::atomic<uint64_t> listCacheMisses;
+
+    void bumpStudentListGeneration();
+    StudentListCache readStudentListCache();
+
+    // 异步API使用的有界I/O执行器，线程数按后端类型确定
+    std::unique_ptr<IoExecutor> ioExecutor;
+    size_t defaultIoThreads() const;
+
+    // 后端异步回调可能位于数据库事件循环线程，其中阻塞的Redis维护交给I/O执行器执行；执行器拒绝时就地执行
+    void postCacheWork(std::function<void()> work);
+
+    // 协程调度线程池：可等待操作完成后在此恢复协程
+    std::unique_ptr<ThreadPool> coroutineScheduler;
+
+    // 在I/O执行器上执行work并等待其结果，被拒绝或超时时返回fallback；
+    // 调用线程在syncWait中等待时直接在本线程执行，不经过执行器
+    template <typename T>
+    CallbackAwaitable<T> awaitIo(std::function<void(std::function<void(T)>)> work, T fallback,
+                                 OperationOptions options = OperationOptions());
+    // 写操作使用：不设截止时间
+    static OperationOptions noDeadline();
+
+    // Redis与数据库后端的可等待包装
+    CallbackAwaitable<std::string> redisGet(std::string key);
+    CallbackAwaitable<std::optional<Student>> redisGetStudent(int id);
+    CallbackAwaitable<bool> redisCacheMissing(int id, uint64_t sequence);
+    CallbackAwaitable<StudentListCache> redisGetStudentList();
+    CallbackAwaitable<bool> redisBumpListGeneration();
+    CallbackAwaitable<bool> redisSet(std::string key, std::string value, int expireSeconds);
+    CallbackAwaitable<bool> redisDel(std::string key);
+    CallbackAwaitable<int> databaseAdd(const Student &student);
+    CallbackAwaitable<bool> databaseUpdate(int id, const Student &student);
+    CallbackAwaitable<bool> databaseDelete(int id);
+    // 点查与计数的结果会写入共享缓存，固定读取主库
+    CallbackAwaitable<Student> databaseGet(int id);
+    CallbackAwaitable<int> databaseCount();
+    CallbackAwaitable<long long> databaseScan(const StudentVisitor &visitor, const std::string &clientId, bool forCache);
 
     // 根据配置创建数据库实例
     std::unique_ptr<DatabaseInterface> createDatabase();
@@ -43,16 +248,66 @@ public:
     bool open();
     void close();
 
-    // 学生信息操作（带缓存）
-    int addStudent(const Student &student);
-    bool updateStudent(int id, const Student &student);
-    bool deleteStudent(int id);
-    Student getStudent(int id);
-    std::vector<std::pair<int, Student>> getAllStudents();
-    int getStudentCount();
+    // 启动预热完成（或超出时间预算）后为true，用于就绪检查
+    bool isReady() const { return ready.load(); }
+
+    // 学生信息操作（带缓存），clientId用于读己之写
+    int addStudent(const Student &student, const std::string &clientId = "");
+    bool updateStudent(int id, const Student &student, const std::string &clientId = "");
+    bool deleteStudent(int id, const std::string &clientId = "");
+    Student getStudent(int id, const std::string &clientId = "");
+    StudentBatch getAllStudents(const std::string &clientId = "");
+    int getStudentCount(const std::string &clientId = "");
+
+    // 批量操作（带缓存）
+    StudentBatch getStudents(const std::vector<int> &ids);
+    std::vector<int> addStudents(const std::vector<Student> &students);
+    int deleteStudents(const std::vector<int> &ids);
+
+    // 批量导入导出（绕过缓存，导入后清除学生数量缓存）
+    long long importStudents(const StudentSource &source);
+    long long exportStudents(const StudentSink &sink);
+
+    // 全表扫描：快照可用时零拷贝遍历，否则流式读取数据库；返回访问的记录数。
+    // forCache表示结果将写入共享缓存，此时固定读取主库
+    long long scanStudents(const StudentVisitor &visitor, const std::string &clientId = "", bool forCache = false);
+
+    // 异步操作（带缓存）：缓存与数据库访问在I/O执行器上完成，调用线程不阻塞；clientId用于读己之写。
+    // 支持按操作的超时与取消，回调恰好执行一次，可能位于执行器、定时器或数据库事件循环线程
+    void getStudentAsync(int id, std::function<void(AsyncResult<Student>)> callback, const OperationOptions &options = {}, const std::string &clientId = "");
+    void addStudentAsync(const Student &student, std::function<void(AsyncResult<int>)> callback, const OperationOptions &options = {}, const std::string &clientId = "");
+    void updateStudentAsync(int id, const Student &student, std::function<void(AsyncResult<bool>)> callback, const OperationOptions &options = {}, const std::string &clientId = "");
+    void deleteStudentAsync(int id, std::function<void(AsyncResult<bool>)> callback, const OperationOptions &options = {}, const std::string &clientId = "");
+    void getAllStudentsAsync(std::function<void(AsyncResult<StudentBatch>)> callback, const OperationOptions &options = {}, const std::string &clientId = "");
+    void getStudentCountAsync(std::function<void(AsyncResult<int>)> callback, const OperationOptions &options = {}, const std::string &clientId = "");
+
+    // 基于future的异步操作
+    std::future<AsyncResult<Student>> getStudentAsync(int id, const OperationOptions &options = {}, const std::string &clientId = "");
+    std::future<AsyncResult<int>> addStudentAsync(const Student &student, const OperationOptions &options = {}, const std::string &clientId = "");
+    std::future<AsyncResult<bool>> updateStudentAsync(int id, const Student &student, const OperationOptions &options = {}, const std::string &clientId = "");
+    std::future<AsyncResult<bool>> deleteStudentAsync(int id, const OperationOptions &options = {}, const std::string &clientId = "");
+    std::future<AsyncResult<StudentBatch>> getAllStudentsAsync(const OperationOptions &options = {}, const std::string &clientId = "");
+    std::future<AsyncResult<int>> getStudentCountAsync(const OperationOptions &options = {}, const std::string &clientId = "");
+
+    // 协程操作（带缓存）：每个Redis与数据库步骤都以co_await挂起，
+    // 不占用调用线程，完成后在协程调度线程池上继续执行
+    Task<int> addStudentTask(Student student, std::string clientId = "");
+    Task<bool> updateStudentTask(int id, Student student, std::string clientId = "");
+    Task<bool> deleteStudentTask(int id, std::string clientId = "");
+    Task<Student> getStudentTask(int id, std::string clientId = "");
+    Task<int> getStudentCountTask(std::string clientId = "");
+    Task<long long> scanStudentsTask(StudentVisitor visitor, std::string clientId = "", bool forCache = false);
+
+    // 学生列表响应缓存：未命中时调用方生成响应体，再以查询到的代数写回（generation为-1时不写）；
+    // 写回在I/O执行器上异步完成，body在此期间不得修改
+    Task<StudentListCache> getStudentListCacheTask(std::string clientId = "");
+    void storeStudentListCache(long long generation, std::shared_ptr<const std::string> body);
 
     // 获取当前数据库类型
     std::string getDatabaseType() const;
+
+    // 运行指标
+    json getMetrics() const;
 };
 
 #endif // DATABASE_MANAGER_H
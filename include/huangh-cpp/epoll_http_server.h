@@ -0,0 +1,75 @@
+#ifndef EPOLL_HTTP_SERVER_H
+#define EPOLL_HTTP_SERVER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "database_manager.h"
+#include "student_routes.h"
+
+// 基于边沿触发epoll的HTTP/1.1前端：单个事件循环线程负责所有连接的读写与解析，
+// 请求在连接自有的缓冲区上原地解析，仅数据库相关工作交给协程与I/O执行器；
+// 空闲的keep-alive连接只占用一个文件描述符和缓冲区，不占用线程，超过空闲时限后关闭
+class EpollHttpServer
+{
+public:
+    // idleTimeoutSeconds为0表示不关闭空闲连接
+    EpollHttpServer(DatabaseManager &dbManager, size_t maxRequestBytes, int idleTimeoutSeconds);
+    ~EpollHttpServer();
+
+    EpollHttpServer(const EpollHttpServer &) = delete;
+    EpollHttpServer &operator=(const EpollHttpServer &) = delete;
+
+    // 绑定并运行事件循环，直到stop()被调用；失败返回false
+    bool listen(const std::string &host, int port);
+    void stop();
+
+private:
+    struct Connection;
+    struct Request;
+    struct CompletionQueue;
+    enum class ParseResult;
+
+    DatabaseManager &dbManager;
+    size_t maxRequestBytes;
+    std::chrono::seconds idleTimeout;
+    std::chrono::steady_clock::time_point lastIdleSweep;
+
+    int epollFd;
+    int listenFd;
+    int wakeFd;
+    std::atomic<bool> running;
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    uint64_t nextConnectionId;
+
+    // 协程完成后由调度线程投递响应，事件循环线程取回并写出
+    std::shared_ptr<CompletionQueue> completions;
+
+    bool bindListener(const std::string &host, int port);
+    void acceptConnections();
+
+    // 返回false表示连接需要关闭
+    bool handleReadable(Connection &connection);
+    // 输入缓冲超过maxRequestBytes时调用：处理可处理的请求后仍超限则回复413或断开，返回false表示关闭连接
+    bool limitInput(Connection &connection);
+    bool handleWritable(Connection &connection);
+    void drainCompletions();
+    void closeConnection(int fd);
+    // 关闭超过空闲时限、且没有处理中请求的连接
+    void closeIdleConnections();
+
+    // 解析缓冲区中的下一个完整请求并分派；返回false表示连接需要关闭
+    bool processRequests(Connection &connection);
+    ParseResult parseRequest(const Connection &connection, Request &request) const;
+    void dispatch(Connection &connection, const Request &request);
+    void queueResponse(Connection &connection, const RouteResponse &response);
+    bool flush(Connection &connection);
+};
+
+#endif // EPOLL_HTTP_SERVER_H
@@ -0,0 +1,235 @@
+#ifndef IO_EXECUTOR_H
+#define IO_EXECUTOR_H
+
+#include <vector>
+#include <queue>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#include "thread_pool.h"
+
+// 异步操作的完成状态
+enum class AsyncStatus
+{
+    Ok,        // 正常完成
+    Timeout,   // 超过截止时间
+    Cancelled, // 被调用方取消
+    Rejected,  // 执行器队列已满或已停止
+    Failed     // 执行过程中抛出异常
+};
+
+const char *asyncStatusName(AsyncStatus status);
+
+template <typename T>
+struct AsyncResult
+{
+    AsyncStatus status = AsyncStatus::Failed;
+    T value{};
+
+    bool ok() const { return status == AsyncStatus::Ok; }
+};
+
+// 取消令牌：拷贝共享同一状态，cancel()后已注册的回调立即执行
+class CancellationToken
+{
+public:
+    CancellationToken();
+
+    void cancel() const;
+    bool isCancelled() const;
+
+    // 注册取消回调，令牌已取消时立即在当前线程执行
+    void onCancel(std::function<void()> callback) const;
+
+private:
+    struct State
+    {
+        std::mutex mutex;
+        bool cancelled = false;
+        std::vector<std::function<void()>> callbacks;
+    };
+
+    std::shared_ptr<State> state;
+};
+
+// 单次操作的选项：timeout为0时使用执行器的默认超时，为负时不设截止时间
+struct OperationOptions
+{
+    std::chrono::milliseconds timeout{0};
+    CancellationToken token;
+};
+
+// 有界I/O执行器：固定线程数与队列上限，支持按操作的截止时间与取消。
+// 超时或取消时立即以对应状态回调，已开始执行的后端调用在后台完成后结果被丢弃
+class IoExecutor
+{
+public:
+    struct Stats
+    {
+        size_t threads = 0;
+        size_t queued = 0;
+        size_t capacity = 0;
+        uint64_t completed = 0;
+        uint64_t timeouts = 0;
+        uint64_t cancelled = 0;
+        uint64_t rejected = 0;
+        uint64_t failed = 0;
+    };
+
+    IoExecutor(size_t threadCount, size_t queueCapacity, std::chrono::milliseconds defaultTimeout);
+    ~IoExecutor();
+
+    IoExecutor(const IoExecutor &) = delete;
+    IoExecutor &operator=(const IoExecutor &) = delete;
+
+    // 提交操作：work在执行器线程上运行，通过done交付结果（可在其他线程稍后调用）；
+    // callback恰好被调用一次，可能位于执行器线程、定时器线程或调用cancel()的线程
+    template <typename T>
+    void submit(std::function<void(std::function<void(T)>)> work,
+                const OperationOptions &options,
+                std::function<void(AsyncResult<T>)> callback);
+
+    void shutdown();
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // 保证回调只执行一次，先到的结果生效
+    template <typename T>
+    class Completion
+    {
+    public:
+        explicit Completion(std::function<void(AsyncResult<T>)> callback) : callback(std::move(callback)), done(false) {}
+
+        bool complete(AsyncStatus status, T value = T())
+        {
+            if (done.exchange(true))
+                return false;
+
+            AsyncResult<T> result;
+            result.status = status;
+            result.value = std::move(value);
+            callback(std::move(result));
+            callback = nullptr;
+            return true;
+        }
+
+        bool isDone() const { return done.load(); }
+
+    private:
+        std::function<void(AsyncResult<T>)> callback;
+        std::atomic<bool> done;
+    };
+
+    struct Timer
+    {
+        Clock::time_point deadline;
+        std::function<void()> action;
+
+        bool operator>(const Timer &other) const { return deadline > other.deadline; }
+    };
+
+    ThreadPool pool;
+    std::chrono::milliseconds defaultTimeout;
+
+    std::mutex timerMutex;
+    std::condition_variable timerCv;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::thread timerThread;
+    bool running;
+
+    std::atomic<uint64_t> completedCount;
+    std::atomic<uint64_t> timeoutCount;
+    std::atomic<uint64_t> cancelledCount;
+    std::atomic<uint64_t> rejectedCount;
+    std::atomic<uint64_t> failedCount;
+
+    void schedule(Clock::time_point deadline, std::function<void()> action);
+    void timerLoop();
+    void record(AsyncStatus status);
+};
+
+template <typename T>
+void IoExecutor::submit(std::function<void(std::function<void(T)>)> work,
+                        const OperationOptions &options,
+                        std::function<void(AsyncResult<T>)> callback)
+{
+    auto completion = std::make_shared<Completion<T>>(std::move(callback));
+    auto finish = [this, completion](AsyncStatus status, T value)
+    {
+        if (completion->complete(status, std::move(value)))
+        {
+            record(status);
+        }
+    };
+
+    CancellationToken token = options.token;
+    if (token.isCancelled())
+    {
+        finish(AsyncStatus::Cancelled, T());
+        return;
+    }
+
+    std::chrono::milliseconds timeout = options.timeout.count() != 0 ? options.timeout : defaultTimeout;
+    Clock::time_point deadline = timeout.count() > 0 ? Clock::now() + timeout : Clock::time_point::max();
+
+    // 定时器与取消回调只持有弱引用，操作完成后即可释放
+    std::weak_ptr<Completion<T>> weak = completion;
+    if (deadline != Clock::time_point::max())
+    {
+        schedule(deadline, [this, weak]()
+                 {
+            if (auto pending = weak.lock())
+            {
+                if (pending->complete(AsyncStatus::Timeout))
+                    record(AsyncStatus::Timeout);
+            } });
+    }
+    token.onCancel([this, weak]()
+                   {
+        if (auto pending = weak.lock())
+        {
+            if (pending->complete(AsyncStatus::Cancelled))
+                record(AsyncStatus::Cancelled);
+        } });
+
+    bool queued = pool.post([completion, finish, work = std::move(work), token, deadline]()
+                            {
+        // 排队期间已超时或取消的操作不再执行
+        if (completion->isDone())
+            return;
+        if (token.isCancelled())
+        {
+            finish(AsyncStatus::Cancelled, T());
+            return;
+        }
+        if (Clock::now() >= deadline)
+        {
+            finish(AsyncStatus::Timeout, T());
+            return;
+        }
+
+        try
+        {
+            work([finish](T value)
+                 { finish(AsyncStatus::Ok, std::move(value)); });
+        }
+        catch (const std::exception &)
+        {
+            finish(AsyncStatus::Failed, T());
+        } });
+
+    if (!queued)
+    {
+        finish(AsyncStatus::Rejected, T());
+    }
+}
+
+#endif // IO_EXECUTOR_H
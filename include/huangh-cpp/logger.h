@@ -16,44 +16,44 @@ public:
     static bool initialize(const std::string &logFile = "app.log");
     static std::shared_ptr<spdlog::logger> getLogger();
 
-    // 便捷日志方法
+    // 便捷日志方法（格式串在编译期校验）
     template <typename... Args>
-    static void trace(const char *fmt, const Args &...args)
+    static void trace(spdlog::format_string_t<const Args &...> fmt, const Args &...args)
     {
         if (logger)
             logger->trace(fmt, args...);
     }
 
     template <typename... Args>
-    static void debug(const char *fmt, const Args &...args)
+    static void debug(spdlog::format_string_t<const Args &...> fmt, const Args &...args)
     {
         if (logger)
             logger->debug(fmt, args...);
     }
 
     template <typename... Args>
-    static void info(const char *fmt, const Args &...args)
+    static void info(spdlog::format_string_t<const Args &...> fmt, const Args &...args)
     {
         if (logger)
             logger->info(fmt, args...);
     }
 
     template <typename... Args>
-    static void warn(const char *fmt, const Args &...args)
+    static void warn(spdlog::format_string_t<const Args &...> fmt, const Args &...args)
     {
         if (logger)
             logger->warn(fmt, args...);
     }
 
     template <typename... Args>
-    static void error(const char *fmt, const Args &...args)
+    static void error(spdlog::format_string_t<const Args &...> fmt, const Args &...args)
     {
         if (logger)
             logger->error(fmt, args...);
     }
 
     template <typename... Args>
-    static void critical(const char *fmt, const Args &...args)
+    static void critical(spdlog::format_string_t<const Args &...> fmt, const Args &...args)
     {
         if (logger)
             logger->critical(fmt, args...);
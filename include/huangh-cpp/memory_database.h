@@ -0,0 +1,116 @@
+#ifndef MEMORY_DATABASE_H
+#define MEMORY_DATABASE_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "database_interface.h"
+#include "config_manager.h"
+
+// 内存存储引擎：记录区 + 开放寻址哈希索引，读路径无锁（两阶段宽限期回收），
+// 写入经组提交的追加式WAL持久化，并定期生成快照截断WAL
+class MemoryDatabase : public DatabaseInterface
+{
+private:
+    struct Record;
+    struct IndexTable;
+    class RecordArena;
+    class ReadDomain;
+    struct WalOp;
+
+    std::string walPath;
+    std::string snapshotPath;
+    std::chrono::seconds snapshotInterval;
+    std::chrono::microseconds groupCommitWindow;
+    bool syncWrites;
+
+    // 读侧：当前索引表与宽限期
+    std::atomic<IndexTable *> index;
+    std::unique_ptr<ReadDomain> readDomain;
+    std::atomic<long long> recordCount;
+
+    // 写侧：仅由组提交的leader访问
+    std::unique_ptr<RecordArena> arena;
+    int walFd;
+
+    // 统计（供getMetrics并发读取）
+    std::atomic<uint64_t> walBytes;
+    std::atomic<size_t> arenaLiveBytes;
+    std::atomic<size_t> arenaGarbageBytes;
+
+    // 组提交队列
+    std::mutex commitMutex;
+    std::condition_variable commitCv;
+    std::deque<WalOp *> commitQueue;
+    bool leaderActive;
+    int nextId;
+    std::atomic<uint64_t> groupCommits;
+    std::atomic<uint64_t> committedOps;
+
+    // 快照线程
+    std::thread snapshotThread;
+    std::mutex snapshotMutex;
+    std::condition_variable snapshotCv;
+    bool running;
+
+    // 组提交：排队等待，由leader统一写WAL、同步并应用到内存
+    void submit(const std::vector<WalOp *> &ops);
+    bool writeWal(const std::vector<WalOp *> &batch);
+    // 将WAL截断回最后一次成功提交的位置（walBytes）
+    void truncateWal();
+    void apply(WalOp &op);
+
+    // 索引写操作（调用方须为当前leader）
+    void upsertRecord(int id, int age, const std::string &name, uint32_t classId);
+    bool eraseRecord(int id);
+    void rebuildIndex(size_t capacity);
+    void compactArena();
+    void publishArenaStats();
+
+    // 持久化
+    bool loadSnapshot();
+    bool replayWal();
+    bool writeSnapshot();
+    void snapshotLoop();
+    void releaseStorage();
+
+    // 获取/释放leader身份（快照期间阻止组提交）
+    void becomeLeader();
+    void resignLeader();
+
+public:
+    MemoryDatabase(const ConfigManager &configManager);
+    ~MemoryDatabase();
+
+    // 数据库连接管理
+    bool open() override;
+    void close() override;
+
+    // 学生信息操作
+    int addStudent(const Student &student) override;
+    bool updateStudent(int id, const Student &student) override;
+    bool deleteStudent(int id) override;
+    Student getStudent(int id) override;
+    StudentBatch getAllStudents() override;
+    int getStudentCount() override;
+    long long getMaxStudentId() override;
+
+    // 批量操作（同一组提交）
+    std::vector<int> addStudents(const std::vector<Student> &students) override;
+    int deleteStudents(const std::vector<int> &ids) override;
+
+    // 表创建（内存引擎无需建表）
+    bool createStudentTable() override;
+
+    // 运行指标
+    json getMetrics() const override;
+};
+
+#endif // MEMORY_DATABASE_H
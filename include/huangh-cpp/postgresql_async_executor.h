@@ -0,0 +1,108 @@
+#ifndef POSTGRESQL_ASYNC_EXECUTOR_H
+#define POSTGRESQL_ASYNC_EXECUTOR_H
+
+#include <libpq-fe.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <chrono>
+
+// 基于epoll的非阻塞PostgreSQL执行器：
+// 少量连接处于pipeline模式，由单个事件循环线程通过
+// PQsendQueryPrepared/PQconsumeInput/PQisBusy复用大量并发查询。
+// 断开的连接由事件循环按定时用PQconnectStart/PQconnectPoll非阻塞重连
+class PostgreSQLAsyncExecutor
+{
+public:
+    // 查询完成回调，result为nullptr表示执行失败；
+    // 回调在事件循环线程执行，返回后result即被释放，不应阻塞
+    using ResultCallback = std::function<void(PGresult *result)>;
+
+    PostgreSQLAsyncExecutor(const std::string &connectionString, size_t connectionCount);
+    ~PostgreSQLAsyncExecutor();
+
+    PostgreSQLAsyncExecutor(const PostgreSQLAsyncExecutor &) = delete;
+    PostgreSQLAsyncExecutor &operator=(const PostgreSQLAsyncExecutor &) = delete;
+
+    // 注册预编译语句，需在start()之前调用
+    void prepare(const std::string &name, const std::string &sql);
+
+    bool start();
+    void stop();
+    bool isRunning() const { return running; }
+
+    // 提交预编译语句，线程安全；返回false表示执行器未运行
+    bool submit(const std::string &statementName, std::vector<std::string> params, ResultCallback callback);
+
+    // 已提交但尚未完成的查询数
+    size_t inFlight() const { return inFlightCount.load(); }
+
+private:
+    struct Request
+    {
+        std::string statementName;
+        std::vector<std::string> params;
+        ResultCallback callback;
+    };
+
+    struct Pending
+    {
+        ResultCallback callback;
+        PGresult *result = nullptr;
+        bool awaitingSync = false;
+    };
+
+    struct Connection
+    {
+        PGconn *conn = nullptr;
+        int socket = -1;
+        bool writeWatched = false;
+        bool connecting = false; // 非阻塞握手中，尚不能分发查询
+        bool broken = false;     // 处理结果时发现连接不可用，处理完后重连
+        // 断开时为下次重连时间，握手中为超时时间
+        std::chrono::steady_clock::time_point deadline;
+        std::deque<Pending> pending;
+    };
+
+    std::string connectionString;
+    size_t connectionCount;
+    std::vector<std::pair<std::string, std::string>> statements;
+
+    std::vector<std::unique_ptr<Connection>> connections;
+    int epollFd;
+    int wakeFd;
+    std::thread loopThread;
+    std::atomic<bool> running;
+    std::atomic<size_t> inFlightCount;
+
+    std::mutex queueMutex;
+    std::deque<Request> queue;
+
+    bool openConnection(Connection &connection);
+    void closeConnection(Connection &connection);
+    void reconnect(Connection &connection);
+    void beginConnect(Connection &connection);
+    void advanceConnect(Connection &connection);
+    bool finishConnect(Connection &connection);
+    void retryLater(Connection &connection);
+    void maintainConnections();
+    bool watchSocket(Connection &connection, uint32_t events);
+
+    void eventLoop();
+    void dispatchQueued();
+    void dispatch(Connection &connection, Request &request);
+    void flush(Connection &connection);
+    void handleReadable(Connection &connection);
+    void processResults(Connection &connection);
+    void complete(Pending &pending);
+    void failAll(Connection &connection);
+    void updateWatch(Connection &connection, bool watchWrite);
+};
+
+#endif // POSTGRESQL_ASYNC_EXECUTOR_H
@@ -0,0 +1,107 @@
+#ifndef POSTGRESQL_CONNECTION_POOL_H
+#define POSTGRESQL_CONNECTION_POOL_H
+
+#include <libpq-fe.h>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+// 有界PostgreSQL连接池：最小/最大连接数、等待队列与获取超时、
+// 锁外建连、后台健康检查以及按最大存活时间回收连接
+class PostgreSQLConnectionPool
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        std::string connectionString;
+        size_t minSize = 1;
+        size_t maxSize = 5;
+        std::chrono::milliseconds acquireTimeout{5000};
+        std::chrono::seconds maxLifetime{1800};
+        std::chrono::seconds healthCheckInterval{30};
+    };
+
+    struct Stats
+    {
+        size_t total = 0;   // 已建立及正在建立的连接数
+        size_t idle = 0;    // 空闲连接数
+        size_t inUse = 0;   // 借出连接数
+        size_t waiters = 0; // 正在等待连接的线程数
+        uint64_t acquired = 0;
+        uint64_t timeouts = 0;
+        uint64_t created = 0;
+        uint64_t retired = 0;
+        double avgWaitMs = 0.0;
+        double maxWaitMs = 0.0;
+    };
+
+    explicit PostgreSQLConnectionPool(const Options &options);
+    ~PostgreSQLConnectionPool();
+
+    PostgreSQLConnectionPool(const PostgreSQLConnectionPool &) = delete;
+    PostgreSQLConnectionPool &operator=(const PostgreSQLConnectionPool &) = delete;
+
+    // 建立最小连接数并启动健康检查线程
+    bool start();
+    void stop();
+
+    // 获取连接，超时或建连失败返回nullptr
+    PGconn *acquire();
+
+    // 归还连接，损坏或超过存活时间的连接会被关闭
+    void release(PGconn *conn);
+
+    // 关闭调用方持有的连接（如协议状态未知），不再放回空闲队列
+    void discard(PGconn *conn);
+
+    Stats getStats() const;
+
+private:
+    struct IdleConnection
+    {
+        PGconn *conn;
+        Clock::time_point idleSince;
+    };
+
+    Options options;
+
+    mutable std::mutex mutex;
+    std::condition_variable available;
+    std::deque<IdleConnection> idle;
+    std::unordered_map<PGconn *, Clock::time_point> createdAt;
+    size_t total;
+    size_t waiters;
+    bool running;
+
+    // 统计
+    uint64_t acquiredCount;
+    uint64_t timeoutCount;
+    uint64_t createdCount;
+    uint64_t retiredCount;
+    double totalWaitMs;
+    double maxWaitMs;
+
+    std::thread healthThread;
+    std::condition_variable healthCv;
+
+    // 在锁外建立新连接
+    PGconn *createConnection();
+
+    // 关闭连接并更新计数（调用时不持有锁）
+    void retire(PGconn *conn);
+
+    bool isExpired(PGconn *conn, Clock::time_point now) const;
+    bool isHealthy(PGconn *conn) const;
+
+    void healthCheckLoop();
+    void runHealthCheck();
+};
+
+#endif // POSTGRESQL_CONNECTION_POOL_H
@@ -5,23 +5,60 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <chrono>
+#include <thread>
+#include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include "database_interface.h"
 #include "config_manager.h"
+#include "postgresql_connection_pool.h"
+#include "postgresql_async_executor.h"
 
 class PostgreSQLDatabase : public DatabaseInterface
 {
 private:
     // 连接池
-    struct ConnectionPool
+    std::unique_ptr<PostgreSQLConnectionPool> connectionPool;
+
+    // 只读副本（各自独立连接池），读请求按在途请求数均衡
+    struct Replica;
+    std::vector<std::unique_ptr<Replica>> replicas;
+    bool hedgedReads;
+    std::chrono::milliseconds hedgeMinDelay;
+
+    // 只读查询类型：各副本按类型分别统计延迟
+    enum class ReadKind
+    {
+        Point,
+        Scan,
+        Count
+    };
+
+    // 对冲落败的请求由后台线程取消并归还连接（PQcancel会新建连接，阻塞到服务端响应）
+    struct PendingCancel
     {
-        std::vector<PGconn *> connections;
-        std::mutex mutex;
-        size_t maxSize;
-        std::string connectionString;
+        PGconn *conn;
+        Replica *replica;
     };
+    std::thread cancelThread;
+    std::mutex cancelMutex;
+    std::condition_variable cancelCv;
+    std::vector<PendingCancel> pendingCancels;
+    bool cancelRunning;
 
-    std::shared_ptr<ConnectionPool> connectionPool;
+    void cancelLater(PGconn *conn, Replica *replica);
+    void cancelLoop();
+
+    // 变更通知：本实例标识（写入application_name）、监听连接与回调
+    std::string instanceName;
+    std::thread listenerThread;
+    std::atomic<bool> listening;
+    std::mutex changeListenerMutex;
+    StudentChangeListener changeListener;
+
+    // 非阻塞执行器（未启用时异步操作退化为同步执行）
+    std::unique_ptr<PostgreSQLAsyncExecutor> asyncExecutor;
     const ConfigManager *configManager;
 
     // 获取连接
@@ -29,13 +66,55 @@ private:
 
     // 释放连接
     void releaseConnection(PGconn *conn);
+    // 关闭连接而不归还，用于状态未知的连接
+    void discardConnection(PGconn *conn);
+
+    // 构建连接字符串
+    std::string buildConnectionString() const;
+    std::string buildConnectionString(const PostgresqlReplicaConfig &endpoint) const;
 
     // 创建连接池
     bool createConnectionPool();
 
+    // 创建只读副本连接池
+    bool createReplicaPools();
+
+    // 选择在途请求最少的副本，exclude用于对冲请求时排除首个副本
+    Replica *pickReplica(const Replica *exclude = nullptr);
+
+    // 执行只读查询：无副本或处于PrimaryReadScope时走主库，否则走副本（可选对冲）
+    PGresult *executeRead(ReadKind kind, const std::string &sql, const std::vector<std::string> &params = {});
+    // 为流式/pipeline读取借出连接：规则同executeRead，replica为nullptr表示主库连接
+    PGconn *acquireReadConnection(Replica *&replica);
+    void releaseReadConnection(PGconn *conn, Replica *replica, bool reusable = true);
+    PGresult *executeOnReplica(Replica &replica, ReadKind kind, const std::string &sql, const std::vector<std::string> &params);
+    PGresult *executeHedged(Replica &first, ReadKind kind, const std::string &sql, const std::vector<std::string> &params);
+
+    // 创建异步执行器
+    bool createAsyncExecutor();
+
+    // 创建变更通知触发器
+    bool createNotifyTrigger();
+
+    // LISTEN连接线程
+    void startChangeListener();
+    void stopChangeListener();
+    void changeListenerLoop();
+    void dispatchNotification(const std::string &payload);
+    void notifyChangeListener(const StudentChangeEvent &event);
+    // 结束批量导入事务：提交时附带一条resync通知；失败时丢弃连接
+    bool finishImportTransaction(PGconn *conn, bool commit);
+
     // 执行查询
     PGresult *executeQuery(PGconn *conn, const std::string &sql, const std::vector<std::string> &params = {});
 
+    // 以pipeline模式批量执行同一条SQL（每组参数一条语句），结果与参数一一对应，失败项为nullptr；
+    // 每批语句为一个隐式事务，批内任一语句失败时整批结果均为nullptr。
+    // 返回false表示连接的协议状态未知，调用方应丢弃连接而不是归还
+    bool executePipeline(PGconn *conn, const std::string &sql,
+                         const std::vector<std::vector<std::string>> &paramsList,
+                         std::vector<PGresult *> &results);
+
 public:
     PostgreSQLDatabase(const ConfigManager &configManager);
     ~PostgreSQLDatabase();
@@ -49,11 +128,35 @@ public:
     bool updateStudent(int id, const Student &student) override;
     bool deleteStudent(int id) override;
     Student getStudent(int id) override;
-    std::vector<std::pair<int, Student>> getAllStudents() override;
+    StudentBatch getAllStudents() override;
     int getStudentCount() override;
+    long long getMaxStudentId() override;
+
+    // 批量操作（pipeline模式，N条语句约一次往返）
+    StudentBatch getStudents(const std::vector<int> &ids) override;
+    std::vector<int> addStudents(const std::vector<Student> &students) override;
+    int deleteStudents(const std::vector<int> &ids) override;
+
+    // 批量导入导出（COPY二进制格式流式传输）
+    long long importStudents(const StudentSource &source) override;
+    long long exportStudents(const StudentSink &sink) override;
+
+    // 异步操作（基于异步执行器）
+    void getStudentAsync(int id, std::function<void(Student)> callback) override;
+    void addStudentAsync(const Student &student, std::function<void(int)> callback) override;
+    void updateStudentAsync(int id, const Student &student, std::function<void(bool)> callback) override;
+    void deleteStudentAsync(int id, std::function<void(bool)> callback) override;
+    void getAllStudentsAsync(std::function<void(StudentBatch)> callback) override;
+    void getStudentCountAsync(std::function<void(int)> callback) override;
 
     // 表创建
     bool createStudentTable() override;
+
+    // 变更通知
+    void setChangeListener(StudentChangeListener listener) override;
+
+    // 运行指标（连接池状态）
+    json getMetrics() const override;
 };
 
 #endif // POSTGRESQL_DATABASE_H
@@ -2,37 +2,207 @@
 #define REDIS_MANAGER_H
 
 #include <string>
+#include <string_view>
+#include <vector>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
 #include <hiredis/hiredis.h>
 #include "logger.h"
 
+// 流水线中单条命令的结果
+struct RedisResult
+{
+    bool ok = false;        // 收到了非错误回复
+    bool nil = false;       // 空回复（键不存在）
+    long long integer = 0;  // 整数回复
+    std::string value;      // 字符串或状态回复；出错时为错误信息
+};
+
+// Redis客户端：内部为固定大小的连接池，每个命令借出一个连接独占使用。
+// 借出无锁：线程优先尝试与自己绑定的槽位，被占用时依次探测其余槽位；
+// 连接在首次借出时建立，命令失败后关闭，下次借出时重连。
+// 所有命令都以argv形式发送，键与值可包含任意字节。
+// 开启自动流水线后，各线程的单条命令进入共享队列，由刷写线程成批写到同一连接，
+// 回复按顺序交还给等待的调用方，一次往返的开销由多个请求分摊。
+// Redis不可用时熔断器打开，请求不再等待建连超时。
+// 开启客户端缓存跟踪后，一个专用的RESP3连接接收服务端推送的失效消息并转交给监听者
 class RedisManager
 {
+public:
+    // 客户端缓存跟踪（CLIENT TRACKING）：Default模式下池中连接读取过的键被跟踪，
+    // 失效消息重定向到跟踪连接；Broadcast模式按前缀订阅所有修改
+    enum class TrackingMode
+    {
+        Off,
+        Default,
+        Broadcast
+    };
+
+    // 失效监听：keys为被修改的键；为空表示应丢弃全部本地缓存（FLUSHALL或跟踪连接断开期间可能漏掉消息）
+    using InvalidationListener = std::function<void(const std::vector<std::string_view> &keys)>;
+
+    struct Options
+    {
+        std::string host = "localhost";
+        int port = 6379;
+        std::string password;
+        size_t poolSize = 0; // 0表示按CPU核数
+        std::chrono::milliseconds timeout{1500};
+        std::chrono::milliseconds acquireTimeout{1000};
+        bool autoPipeline = false;
+        size_t pipelineConnections = 1; // 自动流水线的刷写线程数，每个线程每批占用一个连接
+        size_t pipelineMaxBatch = 128;  // 每批最多写出的命令数
+        uint32_t failureThreshold = 3;  // 连续失败多少次后打开熔断器
+        std::chrono::milliseconds initialBackoff{500};
+        std::chrono::milliseconds maxBackoff{30000};
+        TrackingMode tracking = TrackingMode::Off;
+        std::string trackingPrefix = "student:"; // 仅Broadcast模式使用，空表示所有键
+    };
+
+    struct Stats
+    {
+        size_t poolSize = 0;
+        size_t inUse = 0; // 借出的连接数
+        uint64_t connects = 0;
+        uint64_t acquireTimeouts = 0;
+        uint64_t pipelineBatches = 0;   // 流水线往返次数（显式与自动）
+        uint64_t pipelinedCommands = 0; // 经流水线发送的命令数
+        bool breakerOpen = false;
+        uint32_t consecutiveFailures = 0;
+        uint64_t breakerTrips = 0;
+        uint64_t bypassed = 0; // 熔断期间直接旁路的命令数
+        bool trackingConnected = false;
+        uint64_t invalidations = 0; // 收到的失效键数
+    };
+
+    // 显式流水线：命令先缓存在本地，execute时借出一个连接一次写出，再按顺序读取全部回复
+    class Pipeline
+    {
+    public:
+        // 追加命令，返回其结果在execute返回值中的下标
+        size_t get(std::string_view key);
+        size_t set(std::string_view key, std::string_view value, int expireSeconds = 0);
+        size_t del(std::string_view key);
+        size_t command(std::initializer_list<std::string_view> args);
+
+        size_t size() const { return argc.size(); }
+        bool empty() const { return argc.empty(); }
+
+        // 执行并清空已缓存的命令；连接失败时对应结果的ok为false
+        std::vector<RedisResult> execute();
+
+    private:
+        friend class RedisManager;
+        explicit Pipeline(RedisManager &manager) : manager(&manager) {}
+
+        RedisManager *manager;
+        std::vector<std::string> arguments; // 所有命令的参数依次存放
+        std::vector<size_t> argc;           // 每条命令的参数个数
+    };
+
 private:
-    std::string host;
-    int port;
-    std::string password;
-    redisContext *context;
-    bool connected;
+    struct Slot;
+    class Connection;
+    class AutoPipeline;
 
-    // 重连机制
-    bool reconnect();
+    Options options;
+    std::unique_ptr<Slot[]> slots;
+    size_t slotCount;
+    std::atomic<bool> connected;
+    std::atomic<uint64_t> connectCount;
+    std::atomic<uint64_t> acquireTimeoutCount;
+    std::atomic<uint64_t> pipelineBatchCount;
+    std::atomic<uint64_t> pipelinedCommandCount;
+    std::unique_ptr<AutoPipeline> autoPipeline;
+
+    // 熔断器：连接或命令连续失败达到阈值后打开，期间所有命令立即失败（缓存旁路），
+    // 由后台探测线程按指数退避重连，PING成功后关闭
+    std::atomic<bool> breakerOpen;
+    std::atomic<uint32_t> consecutiveFailures;
+    std::atomic<uint64_t> breakerTripCount;
+    std::atomic<uint64_t> bypassedCount;
+    std::mutex probeMutex;
+    std::condition_variable probeCv;
+    bool probeStopping;
+    std::thread probeThread;
+
+    // 客户端缓存跟踪：专用连接由跟踪线程独占读取，其他线程只在关闭时用于唤醒
+    InvalidationListener invalidationListener;
+    std::mutex trackingMutex;
+    std::condition_variable trackingCv;
+    redisContext *trackingContext;
+    bool trackingStopping;
+    std::atomic<bool> trackingConnected;
+    std::atomic<long long> trackingClientId;
+    std::atomic<uint64_t> trackingGeneration; // 跟踪连接每次重建后递增，Default模式下池中连接随之重连
+    std::atomic<uint64_t> invalidationCount;
+    std::thread trackingThread;
+
+    // 借出一个连接，熔断、池繁忙超时或建连失败时返回空连接
+    Connection acquire();
+
+    // 建立并认证一个新连接，失败返回nullptr
+    redisContext *connectContext();
+
+    // 为槽位建立连接（调用方已独占该槽位）
+    bool open(Slot &slot);
+
+    void recordSuccess();
+    void recordFailure();
+    void openBreaker();
+    bool probe();
+    void probeLoop();
+
+    redisContext *openTrackingContext();
+    void trackingLoop();
+    void handlePush(redisReply *reply);
+
+    // 执行一条argv命令，失败返回nullptr；调用方负责freeReplyObject
+    redisReply *command(std::initializer_list<std::string_view> args);
+    redisReply *command(int argc, const char **argv, const size_t *argvlen);
 
 public:
     RedisManager(const std::string &host = "localhost", int port = 6379, const std::string &password = "");
+    explicit RedisManager(const Options &options);
     ~RedisManager();
 
-    // 连接管理
+    RedisManager(const RedisManager &) = delete;
+    RedisManager &operator=(const RedisManager &) = delete;
+
+    // 连接管理：connect建立一个连接以确认Redis可用，disconnect关闭所有空闲连接
     bool connect();
     void disconnect();
-    bool isConnected() const { return connected; }
+    bool isConnected() const { return connected.load(); }
+
+    Stats getStats() const;
+    TrackingMode trackingMode() const { return options.tracking; }
+
+    // 设置失效监听并启动跟踪线程（Options::tracking为Off时只保存监听者）；应在首次使用前调用一次
+    void setInvalidationListener(InvalidationListener listener);
+
+    Pipeline pipeline() { return Pipeline(*this); }
 
     // 基本操作
     bool set(const std::string &key, const std::string &value, int expireSeconds = 0);
+    // SET NX：键不存在时写入并返回true，键已存在或失败时返回false
+    bool setIfAbsent(std::string_view key, std::string_view value, int expireSeconds = 0);
+    // 比较并写入（Lua脚本，原子执行）：当前值等于expected时写入value并返回true，值已改变、键不存在或失败时返回false
+    bool compareAndSet(std::string_view key, std::string_view expected, std::string_view value, int expireSeconds = 0);
     std::string get(const std::string &key);
+    // 键存在时以回复缓冲的视图调用consumer，视图只在调用期间有效，值不经过复制
+    bool get(std::string_view key, const std::function<void(std::string_view)> &consumer);
     bool del(const std::string &key);
     bool exists(const std::string &key);
     bool expire(const std::string &key, int seconds);
+    // INCRBY：成功时写入增加后的值并返回true（计数器不存在时视为0）
+    bool incrBy(std::string_view key, long long delta, long long &value);
 
     // 哈希表操作
     bool hset(const std::string &key, const std::string &field, const std::string &value);
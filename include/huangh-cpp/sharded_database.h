@@ -0,0 +1,84 @@
+#ifndef SHARDED_DATABASE_H
+#define SHARDED_DATABASE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include "database_interface.h"
+#include "config_manager.h"
+#include "sqlite_database.h"
+#include "thread_pool.h"
+
+// 分片SQLite数据库：学生按id区间分布在多个SQLite文件中，
+// 分片k持有id区间 [k * kShardIdRange + 1, (k + 1) * kShardIdRange]，
+// 因此按id即可直接定位分片；跨分片查询在线程池上并行执行后合并
+class ShardedDatabase : public DatabaseInterface
+{
+public:
+    static constexpr int kShardIdRange = 1 << 24;
+    static constexpr size_t kMaxShards = 127;
+
+    ShardedDatabase(const ConfigManager &configManager);
+    ~ShardedDatabase();
+
+    // 数据库连接管理
+    bool open() override;
+    void close() override;
+
+    // 学生信息操作
+    int addStudent(const Student &student) override;
+    bool updateStudent(int id, const Student &student) override;
+    bool deleteStudent(int id) override;
+    Student getStudent(int id) override;
+    StudentBatch getAllStudents() override;
+    int getStudentCount() override;
+    long long getMaxStudentId() override;
+
+    // 批量操作（按分片拆分后并行执行）
+    StudentBatch getStudents(const std::vector<int> &ids) override;
+    std::vector<int> addStudents(const std::vector<Student> &students) override;
+    int deleteStudents(const std::vector<int> &ids) override;
+
+    // 批量导入导出
+    long long importStudents(const StudentSource &source) override;
+    long long exportStudents(const StudentSink &sink) override;
+
+    // 表创建
+    bool createStudentTable() override;
+
+    // 运行指标
+    json getMetrics() const override;
+
+private:
+    // 每个分片独立的连接；写操作按分片串行，保证取回的自增id属于本次插入
+    struct Shard
+    {
+        std::unique_ptr<SQLiteDatabase> database;
+        std::mutex writeMutex;
+    };
+
+    std::string directory;
+    size_t shardCount;
+    size_t threadCount;
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::unique_ptr<ThreadPool> pool;
+    std::atomic<size_t> nextShard;
+
+    // 返回id所属分片，id不在任何分片区间内时返回-1
+    int shardIndex(int id) const;
+
+    // 插入后校验id仍位于分片区间内（区间耗尽时回滚）
+    int insertInto(size_t index, const Student &student);
+
+    // 按分片对id分组
+    std::vector<std::vector<int>> groupByShard(const std::vector<int> &ids) const;
+
+    // 按分片顺序合并各分片的结果
+    static StudentBatch mergeBatches(std::vector<std::future<StudentBatch>> &futures);
+};
+
+#endif // SHARDED_DATABASE_H
@@ -4,6 +4,7 @@
 #include <sqlite3.h>
 #include <string>
 #include <vector>
+#include <mutex>
 #include "database_interface.h"
 #include "config_manager.h"
 
@@ -12,10 +13,19 @@ class SQLiteDatabase : public DatabaseInterface
 private:
     sqlite3 *db;
     std::string dbPath;
+    int idBase;
+    // 所有写入共用一个连接：写操作与批量事务串行执行，保证事务边界与取回的自增id属于本次写入
+    std::mutex writeMutex;
+
+    // 执行不带参数的语句（事务控制等），失败时记录错误
+    bool execute(const char *sql);
+    // 新建库时将自增序列设置为idBase，使分配的id从idBase + 1开始
+    bool seedIdSequence();
 
 public:
     SQLiteDatabase(const ConfigManager &configManager);
     SQLiteDatabase(const std::string &path = "../data/students.db");
+    SQLiteDatabase(const std::string &path, int idBase);
     ~SQLiteDatabase();
 
     // 数据库连接管理
@@ -27,8 +37,17 @@ public:
     bool updateStudent(int id, const Student &student) override;
     bool deleteStudent(int id) override;
     Student getStudent(int id) override;
-    std::vector<std::pair<int, Student>> getAllStudents() override;
+    StudentBatch getAllStudents() override;
     int getStudentCount() override;
+    long long getMaxStudentId() override;
+
+    // 批量操作（单事务内复用预编译语句）
+    std::vector<int> addStudents(const std::vector<Student> &students) override;
+    int deleteStudents(const std::vector<int> &ids) override;
+
+    // 批量导入导出（单事务导入，逐行流式导出）
+    long long importStudents(const StudentSource &source) override;
+    long long exportStudents(const StudentSink &sink) override;
 
     // 表创建
     bool createStudentTable() override;
@@ -3,39 +3,52 @@
 
 #include <string>
 #include <iostream>
+#include <cstdint>
+#include "class_name_table.h"
 
 class Student
 {
 private:
     std::string name;
     int age;
-    std::string className;
+    uint32_t classId; // 班级名称在ClassNameTable中的id
 
 public:
     // 构造函数
     Student(const std::string &name = "", int age = 0, const std::string &className = "")
-        : name(name), age(age), className(className) {}
+        : name(name), age(age), classId(ClassNameTable::instance().intern(className)) {}
 
-    // Getter 方法
-    std::string getName() const { return name; }
+    // 使用已登记的班级id构造，避免再次查找字典
+    static Student withClassId(std::string name, int age, uint32_t classId)
+    {
+        Student student;
+        student.name = std::move(name);
+        student.age = age;
+        student.classId = classId;
+        return student;
+    }
+
+    // Getter 方法（返回引用，序列化时不再复制字符串）
+    const std::string &getName() const { return name; }
     int getAge() const { return age; }
-    std::string getClassName() const { return className; }
+    const std::string &getClassName() const { return ClassNameTable::instance().name(classId); }
+    uint32_t getClassId() const { return classId; }
 
     // Setter 方法
     void setName(const std::string &newName) { name = newName; }
     void setAge(int newAge) { age = newAge; }
-    void setClassName(const std::string &newClassName) { className = newClassName; }
+    void setClassName(const std::string &newClassName) { classId = ClassNameTable::instance().intern(newClassName); }
 
     // 显示学生信息
     void display() const
     {
-        std::cout << "姓名: " << name << ", 年龄: " << age << ", 班级: " << className;
+        std::cout << "姓名: " << name << ", 年龄: " << age << ", 班级: " << getClassName();
     }
 
     // 重载输出运算符
     friend std::ostream &operator<<(std::ostream &os, const Student &student)
     {
-        os << "姓名: " << student.name << ", 年龄: " << student.age << ", 班级: " << student.className;
+        os << "姓名: " << student.name << ", 年龄: " << student.age << ", 班级: " << student.getClassName();
         return os;
     }
 
@@ -48,7 +61,7 @@ public:
     // 重载相等运算符
     bool operator==(const Student &other) const
     {
-        return name == other.name && age == other.age && className == other.className;
+        return name == other.name && age == other.age && classId == other.classId;
     }
 };
 
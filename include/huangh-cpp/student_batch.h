@@ -0,0 +1,108 @@
+#ifndef STUDENT_BATCH_H
+#define STUDENT_BATCH_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <iterator>
+#include "student.h"
+
+// 学生记录的只读视图，字符串指向快照映射内存或批量结果集的字符串区
+struct StudentView
+{
+    int id;
+    int age;
+    std::string_view name;
+    std::string_view className;
+    uint32_t classId; // className在ClassNameTable中的id
+
+    Student toStudent() const { return Student::withClassId(std::string(name), age, classId); }
+};
+
+// 扫描访问者：返回false表示停止扫描
+using StudentVisitor = std::function<bool(const StudentView &student)>;
+
+// 批量学生结果集：id、年龄与班级id为连续数组，姓名按块追加到字符串区中，
+// 通过string_view访问；批量读取只需少量内存分配，移动时视图保持有效
+class StudentBatch
+{
+public:
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = StudentView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = StudentView;
+
+        const_iterator(const StudentBatch *batch, size_t index) : batch(batch), index(index) {}
+
+        StudentView operator*() const { return batch->view(index); }
+        const_iterator &operator++()
+        {
+            ++index;
+            return *this;
+        }
+        bool operator==(const const_iterator &other) const { return index == other.index; }
+        bool operator!=(const const_iterator &other) const { return index != other.index; }
+
+    private:
+        const StudentBatch *batch;
+        size_t index;
+    };
+
+    StudentBatch() = default;
+    StudentBatch(const StudentBatch &other);
+    StudentBatch &operator=(const StudentBatch &other);
+    StudentBatch(StudentBatch &&) noexcept = default;
+    StudentBatch &operator=(StudentBatch &&) noexcept = default;
+
+    // 预留行数与字符串字节数，已知结果规模时整个结果集只需几次分配
+    void reserve(size_t rows, size_t textBytes = 0);
+
+    void add(int id, int age, std::string_view name, std::string_view className);
+    void add(int id, int age, std::string_view name, uint32_t classId);
+    void add(int id, const Student &student);
+    void append(const StudentBatch &other);
+
+    // 按id升序重排
+    void sortById();
+    void clear();
+
+    size_t size() const { return ids.size(); }
+    bool empty() const { return ids.empty(); }
+
+    int id(size_t index) const { return ids[index]; }
+    int age(size_t index) const { return ages[index]; }
+    std::string_view name(size_t index) const { return names[index]; }
+    std::string_view className(size_t index) const { return ClassNameTable::instance().name(classIds[index]); }
+    uint32_t classId(size_t index) const { return classIds[index]; }
+    StudentView view(size_t index) const { return StudentView{ids[index], ages[index], names[index], className(index), classIds[index]}; }
+    Student student(size_t index) const { return view(index).toStudent(); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, ids.size()); }
+
+    // 依次访问每一行，返回访问的行数
+    long long forEach(const StudentVisitor &visitor) const;
+
+private:
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    std::vector<int> ids;
+    std::vector<int> ages;
+    std::vector<std::string_view> names;
+    std::vector<uint32_t> classIds;
+
+    // 字符串区：只追加的内存块，块地址在移动后不变
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t chunkUsed = 0;
+    size_t chunkCapacity = 0;
+
+    std::string_view store(std::string_view text);
+};
+
+#endif // STUDENT_BATCH_H
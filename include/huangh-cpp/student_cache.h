@@ -0,0 +1,79 @@
+#ifndef STUDENT_CACHE_H
+#define STUDENT_CACHE_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include "student.h"
+
+// 进程内学生缓存（位于Redis之前的一级缓存）：保存已解码的Student，命中时不经过网络与JSON解析。
+// 按id分片，每个分片一把锁；分片内按字节预算容纳条目，超出时用CLOCK算法淘汰
+// （命中只置访问位，淘汰指针扫过时清除访问位，再次扫到仍未访问的条目被淘汰）。
+// 每个条目带过期时间，过期条目在查找或扫描时移除
+class StudentCache
+{
+public:
+    struct Options
+    {
+        size_t capacityBytes = 16 * 1024 * 1024; // 0表示禁用
+        size_t shards = 16;                      // 向上取整为2的幂
+        std::chrono::milliseconds ttl{30000};
+    };
+
+    struct Stats
+    {
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t capacityBytes = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+    };
+
+    StudentCache();
+    explicit StudentCache(const Options &options);
+    ~StudentCache();
+
+    StudentCache(const StudentCache &) = delete;
+    StudentCache &operator=(const StudentCache &) = delete;
+
+    bool enabled() const { return shardCount > 0; }
+
+    // 命中且未过期时写入student并返回true
+    bool find(int id, Student &student);
+    void insert(int id, const Student &student);
+    // 带栅栏的插入：在分片锁内确认version仍为expected才写入，返回是否写入。
+    // 失效方先递增version再erase/clear，读取期间发生的失效因此不会被读到的旧值覆盖
+    bool insert(int id, const Student &student, const std::atomic<uint64_t> &version, uint64_t expected);
+    void erase(int id);
+    void clear();
+
+    // 返回最多limit个未过期条目的id，访问位已置位（插入后再次命中）的条目优先，用于记录热点列表
+    std::vector<int> hotIds(size_t limit) const;
+
+    Stats getStats() const;
+
+private:
+    struct Shard;
+
+    Options options;
+    size_t shardCount;
+    size_t shardBudget;
+    std::unique_ptr<Shard[]> shards;
+
+    std::atomic<uint64_t> hitCount;
+    std::atomic<uint64_t> missCount;
+    std::atomic<uint64_t> evictionCount;
+    std::atomic<uint64_t> expirationCount;
+
+    Shard &shardFor(int id) const;
+    // 调用方持有分片锁
+    void insertLocked(Shard &shard, int id, const Student &student, size_t bytes);
+};
+
+#endif // STUDENT_CACHE_H
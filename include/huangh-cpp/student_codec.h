@@ -0,0 +1,64 @@
+#ifndef STUDENT_CODEC_H
+#define STUDENT_CODEC_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "student.h"
+#include "student_json.h"
+
+// 学生缓存值的紧凑二进制编码（版本1）：
+//   0x81 | varint(zigzag(age)) | varint(姓名长度) 姓名 | varint(班级长度) 班级 | varint(软过期时刻) | varint(加载耗时)
+// 首字节最高位为1，不会与JSON文本（以'{'开头）混淆；解码直接读取输入缓冲，只在构造Student时复制姓名。
+// 班级以名称存储，各进程的字典id互不相同
+constexpr unsigned char kStudentCodecV1 = 0x81;
+
+// 负缓存值：单字节0x80表示数据库中确认不存在该学生，以较短的过期时间写入
+constexpr unsigned char kStudentCodecMissing = 0x80;
+
+inline std::string_view studentCacheMissingValue()
+{
+    static constexpr char value[] = {static_cast<char>(kStudentCodecMissing)};
+    return std::string_view(value, 1);
+}
+
+inline bool isStudentCacheMissing(std::string_view data)
+{
+    return data.size() == 1 && static_cast<unsigned char>(data.front()) == kStudentCodecMissing;
+}
+
+namespace student_codec_detail
+{
+    template <typename String>
+    void appendVarint(String &out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+}
+
+template <typename String>
+void encodeStudentCache(String &out, std::string_view name, int age, uint32_t classId, const CacheStamp &stamp)
+{
+    using student_codec_detail::appendVarint;
+    const std::string &className = ClassNameTable::instance().name(classId);
+
+    out += static_cast<char>(kStudentCodecV1);
+    appendVarint(out, (static_cast<uint64_t>(static_cast<int64_t>(age)) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(age) >> 63));
+    appendVarint(out, name.size());
+    out.append(name.data(), name.size());
+    appendVarint(out, className.size());
+    out.append(className.data(), className.size());
+    appendVarint(out, static_cast<uint64_t>(stamp.softExpiresAt > 0 ? stamp.softExpiresAt : 0));
+    appendVarint(out, static_cast<uint64_t>(stamp.loadMillis > 0 ? stamp.loadMillis : 0));
+}
+
+// 解码缓存值：二进制编码按版本解析，以'{'开头的旧JSON值交给parseStudentJson；
+// 数据截断、版本未知或格式错误时返回false，error非空时写入错误描述
+bool decodeStudentCache(std::string_view data, Student &student, CacheStamp *stamp = nullptr, std::string *error = nullptr);
+
+#endif // STUDENT_CODEC_H
@@ -0,0 +1,104 @@
+#ifndef STUDENT_JSON_H
+#define STUDENT_JSON_H
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstdint>
+#include "student.h"
+#include "class_name_table.h"
+
+// 学生记录与JSON文本之间的直接转换：写出时按字段拼接到调用方的字符串，
+// 读取时使用SAX解析，均不构建json DOM
+
+// 追加JSON转义后的字符串（含引号）
+template <typename String>
+void appendJsonString(String &out, std::string_view text)
+{
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\b':
+            out += "\\b";
+            break;
+        case '\f':
+            out += "\\f";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                out += "\\u00";
+                out += hex[(c >> 4) & 0x0f];
+                out += hex[c & 0x0f];
+            }
+            else
+            {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+template <typename String>
+void appendJsonInt(String &out, int value)
+{
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+// 追加一个学生对象，字段顺序与nlohmann::json输出一致；id为-1时不输出id字段。
+// 班级名称直接使用字典中预先转义的JSON片段
+template <typename String>
+void appendStudentJson(String &out, int id, std::string_view name, int age, uint32_t classId)
+{
+    out += "{\"age\":";
+    appendJsonInt(out, age);
+    out += ",\"className\":";
+    out += ClassNameTable::instance().json(classId);
+    if (id != -1)
+    {
+        out += ",\"id\":";
+        appendJsonInt(out, id);
+    }
+    out += ",\"name\":";
+    appendJsonString(out, name);
+    out += '}';
+}
+
+// 缓存条目附带的刷新信息：软过期时刻（Unix毫秒，0表示无）与从数据库加载一次的耗时（毫秒），
+// 读取方据此在软过期后或按XFetch提前触发后台刷新
+struct CacheStamp
+{
+    long long softExpiresAt = 0;
+    int loadMillis = 0;
+};
+
+// 解析{"name":..., "age":..., "className":...}格式的学生对象，缺失字段取默认值；
+// 格式错误或字段类型不符时返回false，error非空时写入错误描述；stamp非空时读取刷新信息
+bool parseStudentJson(std::string_view text, Student &student, std::string *error = nullptr, CacheStamp *stamp = nullptr);
+
+// 解析客户端写请求中的学生对象，格式错误时同parseStudentJson返回false；
+// 新的班级名称经ClassNameTable::internForWrite登记，达到上限时抛出std::length_error，不以空班级名称写入
+bool parseStudentRequestJson(std::string_view text, Student &student, std::string *error = nullptr);
+
+#endif // STUDENT_JSON_H
@@ -0,0 +1,36 @@
+#ifndef STUDENT_ROUTES_H
+#define STUDENT_ROUTES_H
+
+#include <string>
+#include "student.h"
+#include "task.h"
+#include "database_manager.h"
+
+// 路由处理结果，与具体的HTTP服务器实现无关
+struct RouteResponse
+{
+    int status = 200;
+    std::string body;
+};
+
+// 生成{"error": message}格式的错误响应
+RouteResponse errorResponse(int status, const std::string &message);
+
+// 解析JSON格式的学生信息，格式错误时抛出std::runtime_error，班级名称数量达到上限时抛出std::length_error
+Student parseStudentFromJson(const std::string &jsonStr);
+
+// 将Student对象转换为JSON字符串，id为-1时不输出id字段
+std::string studentToJson(const Student &student, int id = -1);
+
+// 学生相关接口的协程处理函数：参数按值传入，协程挂起期间不依赖调用方的请求对象
+Task<RouteResponse> handleAddStudent(DatabaseManager &dbManager, std::string body, std::string clientId);
+Task<RouteResponse> handleListStudents(DatabaseManager &dbManager, std::string clientId);
+Task<RouteResponse> handleGetStudent(DatabaseManager &dbManager, int studentId, std::string clientId);
+Task<RouteResponse> handleUpdateStudent(DatabaseManager &dbManager, int studentId, std::string body, std::string clientId);
+Task<RouteResponse> handleDeleteStudent(DatabaseManager &dbManager, int studentId, std::string clientId);
+Task<RouteResponse> handleHealth(DatabaseManager &dbManager, std::string clientId);
+
+// 就绪检查：启动预热完成前返回503，负载均衡据此决定是否转发流量
+RouteResponse handleReady(const DatabaseManager &dbManager);
+
+#endif // STUDENT_ROUTES_H
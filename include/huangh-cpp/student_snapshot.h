@@ -0,0 +1,79 @@
+#ifndef STUDENT_SNAPSHOT_H
+#define STUDENT_SNAPSHOT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <ctime>
+#include "student.h"
+#include "student_batch.h"
+
+// 列式学生快照文件：按id排序的id列、年龄列、字典编码的班级列以及姓名字符串堆，
+// 以mmap方式只读打开，查询和扫描均不复制数据
+class StudentSnapshot
+{
+public:
+    // 快照构建器：收集行后一次性写出，先写临时文件再重命名保证原子替换
+    class Builder
+    {
+    public:
+        void add(int id, const Student &student);
+        size_t size() const { return ids.size(); }
+        bool write(const std::string &path) const;
+
+    private:
+        std::vector<int32_t> ids;
+        std::vector<int32_t> ages;
+        std::vector<uint32_t> classCodes;
+        std::vector<uint64_t> nameOffsets{0};
+        std::string nameHeap;
+        std::unordered_map<uint32_t, uint32_t> dictionaryIndex; // 班级id -> 文件内字典编码
+        std::vector<std::string> dictionary;
+    };
+
+    StudentSnapshot();
+    ~StudentSnapshot();
+
+    StudentSnapshot(const StudentSnapshot &) = delete;
+    StudentSnapshot &operator=(const StudentSnapshot &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    size_t size() const { return rowCount; }
+    // 最大的id（id列有序，即最后一行），空快照为0
+    long long maxId() const { return rowCount > 0 ? ids[rowCount - 1] : 0; }
+    std::time_t createdAt() const { return created; }
+
+    // 按id二分查找
+    bool find(int id, StudentView &view) const;
+
+    // 按id顺序扫描全部记录，返回访问的记录数
+    long long forEach(const StudentVisitor &visitor) const;
+
+private:
+    const char *data;
+    size_t length;
+    size_t rowCount;
+    size_t dictionaryCount;
+    std::time_t created;
+
+    const int32_t *ids;
+    const int32_t *ages;
+    const uint32_t *classCodes;
+    const uint64_t *nameOffsets;
+    const char *nameHeap;
+    const uint64_t *dictionaryOffsets;
+    const char *dictionaryHeap;
+
+    // 文件内字典编码 -> 进程内班级id，打开时登记一次
+    std::vector<uint32_t> classIds;
+
+    StudentView viewAt(size_t row) const;
+};
+
+#endif // STUDENT_SNAPSHOT_H
@@ -0,0 +1,206 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <optional>
+#include <utility>
+#include "thread_pool.h"
+
+template <typename T>
+class Task;
+
+namespace detail
+{
+    // 协程结束时转回等待者，没有等待者则直接挂起等待销毁
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            std::coroutine_handle<> continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    // 当前线程是否正在syncWait中等待
+    inline thread_local bool syncWaiting = false;
+
+    // 分离执行的协程，结束后自动销毁
+    struct DetachedTask
+    {
+        struct promise_type
+        {
+            DetachedTask get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+}
+
+// 惰性协程任务：co_await时才开始执行，完成后通过对称转移恢复等待者
+template <typename T>
+class Task
+{
+public:
+    struct promise_type
+    {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+        std::optional<T> value;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        detail::FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_value(T result) { value = std::move(result); }
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~Task()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume()
+    {
+        if (handle.promise().exception)
+            std::rethrow_exception(handle.promise().exception);
+        return std::move(*handle.promise().value);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// 调用线程是否正阻塞在syncWait中：此时回调式操作可以直接在本线程完成，不必占用另一个线程
+inline bool inSyncWait()
+{
+    return detail::syncWaiting;
+}
+
+// 将回调式异步操作包装为可等待对象，完成后在调度线程池上恢复协程，
+// 避免在数据库事件循环或I/O执行器线程上继续执行协程的后续步骤。
+// 不指定调度线程池时，start返回前已完成的操作不挂起协程，直接在本线程继续
+template <typename T>
+class CallbackAwaitable
+{
+public:
+    using Start = std::function<void(std::function<void(T)>)>;
+
+    CallbackAwaitable(Start start, ThreadPool *scheduler) : start(std::move(start)), scheduler(scheduler) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        // 完成回调可能在start返回前于其他线程恢复协程并销毁本对象，先将start移出
+        Start pending = std::move(start);
+        if (scheduler)
+        {
+            pending([this, handle](T value)
+                  {
+                result = std::move(value);
+                if (!scheduler->post([handle]()
+                                     { handle.resume(); }))
+                {
+                    handle.resume();
+                } });
+            return true;
+        }
+
+        // start返回前完成的由本函数返回false继续协程，之后完成的由回调恢复
+        pending([this, handle](T value)
+              {
+            result = std::move(value);
+            if (state.exchange(kCompleted) == kSuspended)
+                handle.resume(); });
+        return state.exchange(kSuspended) != kCompleted;
+    }
+
+    T await_resume() { return std::move(*result); }
+
+private:
+    static constexpr int kStarting = 0;
+    static constexpr int kSuspended = 1;
+    static constexpr int kCompleted = 2;
+
+    Start start;
+    ThreadPool *scheduler;
+    std::optional<T> result;
+    std::atomic<int> state{kStarting};
+};
+
+// 启动任务，完成后以结果或异常调用callback
+template <typename T>
+void startTask(Task<T> task, std::function<void(std::optional<T>, std::exception_ptr)> callback)
+{
+    [](Task<T> task, std::function<void(std::optional<T>, std::exception_ptr)> callback) -> detail::DetachedTask
+    {
+        std::optional<T> value;
+        std::exception_ptr exception;
+        try
+        {
+            value = co_await std::move(task);
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+        callback(std::move(value), exception);
+    }(std::move(task), std::move(callback));
+}
+
+// 阻塞等待任务完成，供同步调用方（如httplib处理线程）使用
+template <typename T>
+T syncWait(Task<T> task)
+{
+    std::promise<T> promise;
+    std::future<T> future = promise.get_future();
+    // 任务在本线程上运行期间，awaitIo在本线程直接执行，不再经由I/O执行器与调度线程池
+    bool previous = detail::syncWaiting;
+    detail::syncWaiting = true;
+    startTask<T>(std::move(task), [&promise](std::optional<T> value, std::exception_ptr exception)
+                 {
+        if (exception)
+            promise.set_exception(exception);
+        else
+            promise.set_value(std::move(*value)); });
+    detail::syncWaiting = previous;
+    return future.get();
+}
+
+#endif // TASK_H
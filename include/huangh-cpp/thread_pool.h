@@ -0,0 +1,61 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+// 固定大小线程池，任务按提交顺序执行；maxPending为0表示队列不限长
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threadCount, size_t maxPending = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // 提交任务，线程池已停止或队列已满时返回false
+    bool post(std::function<void()> task);
+
+    // 提交任务并返回其结果的future
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F &&function)
+    {
+        using Result = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+        std::future<Result> future = task->get_future();
+        if (!post([task]()
+                  { (*task)(); }))
+        {
+            // 无法入队时在调用线程执行以保证future可用
+            (*task)();
+        }
+        return future;
+    }
+
+    // 等待已提交的任务执行完毕后停止工作线程
+    void shutdown();
+
+    size_t size() const { return workers.size(); }
+    size_t capacity() const { return maxPending; }
+    size_t pending() const;
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    mutable std::mutex mutex;
+    std::condition_variable available;
+    size_t maxPending;
+    bool stopping;
+
+    void workerLoop();
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,109 @@
+#include "class_name_table.h"
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include "logger.h"
+
+ClassNameTable &ClassNameTable::instance()
+{
+    static ClassNameTable table;
+    return table;
+}
+
+ClassNameTable::ClassNameTable()
+    : blocks(new std::atomic<Entry *>[kMaxBlocks]), count(1)
+{
+    for (size_t i = 0; i < kMaxBlocks; ++i)
+    {
+        blocks[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    // id 0：空班级名称
+    Entry *first = new Entry[kBlockSize];
+    first[0].json = "\"\"";
+    blocks[0].store(first, std::memory_order_release);
+    index.emplace(std::string_view(first[0].name), 0);
+}
+
+uint32_t ClassNameTable::intern(std::string_view className)
+{
+    uint32_t id;
+    if (!tryIntern(className, id, kCapacity))
+    {
+        Logger::error("班级名称字典已满，无法登记: {}", className);
+        return 0;
+    }
+    return id;
+}
+
+bool ClassNameTable::internForWrite(std::string_view className, uint32_t &id)
+{
+    if (tryIntern(className, id, kWriteLimit))
+        return true;
+
+    Logger::warn("班级名称数量已达写请求上限，拒绝登记: {}", className);
+    return false;
+}
+
+bool ClassNameTable::tryIntern(std::string_view className, uint32_t &id, size_t limit)
+{
+    id = 0;
+    if (className.empty())
+        return true;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = index.find(className);
+        if (it != index.end())
+        {
+            id = it->second;
+            return true;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = index.find(className);
+    if (it != index.end())
+    {
+        id = it->second;
+        return true;
+    }
+
+    uint32_t next = count.load(std::memory_order_relaxed);
+    if (next >= limit)
+        return false;
+
+    size_t block = next >> kBlockBits;
+    Entry *entries = blocks[block].load(std::memory_order_relaxed);
+    if (!entries)
+    {
+        entries = new Entry[kBlockSize];
+        blocks[block].store(entries, std::memory_order_release);
+    }
+
+    Entry &created = entries[next & (kBlockSize - 1)];
+    created.name.assign(className);
+    created.json = nlohmann::json(created.name).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+    index.emplace(std::string_view(created.name), next);
+
+    // 发布计数后条目才对无锁读取方可见
+    count.store(next + 1, std::memory_order_release);
+    id = next;
+    return true;
+}
+
+const ClassNameTable::Entry &ClassNameTable::entry(uint32_t id) const
+{
+    if (id >= count.load(std::memory_order_acquire))
+        id = 0;
+    return blocks[id >> kBlockBits].load(std::memory_order_acquire)[id & (kBlockSize - 1)];
+}
+
+const std::string &ClassNameTable::name(uint32_t id) const
+{
+    return entry(id).name;
+}
+
+const std::string &ClassNameTable::json(uint32_t id) const
+{
+    return entry(id).json;
+}
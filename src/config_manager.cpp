@@ -54,6 +54,86 @@ std::string ConfigManager::getSqliteDatabasePath() const
         .value("path", "../data/students.db");
 }
 
+std::string ConfigManager::getMemoryWalPath() const
+{
+    if (!loaded)
+        return "../data/students.wal";
+
+    return config.value("database", json::object())
+        .value("memory", json::object())
+        .value("wal_path", "../data/students.wal");
+}
+
+std::string ConfigManager::getMemorySnapshotPath() const
+{
+    if (!loaded)
+        return "../data/students.snapshot";
+
+    return config.value("database", json::object())
+        .value("memory", json::object())
+        .value("snapshot_path", "../data/students.snapshot");
+}
+
+int ConfigManager::getMemorySnapshotInterval() const
+{
+    if (!loaded)
+        return 300;
+
+    return config.value("database", json::object())
+        .value("memory", json::object())
+        .value("snapshot_interval_seconds", 300);
+}
+
+int ConfigManager::getMemoryGroupCommitWindowUs() const
+{
+    if (!loaded)
+        return 0;
+
+    return config.value("database", json::object())
+        .value("memory", json::object())
+        .value("group_commit_window_us", 0);
+}
+
+bool ConfigManager::getMemorySyncWrites() const
+{
+    if (!loaded)
+        return true;
+
+    return config.value("database", json::object())
+        .value("memory", json::object())
+        .value("sync_writes", true);
+}
+
+std::string ConfigManager::getShardedDirectory() const
+{
+    if (!loaded)
+        return "../data/shards";
+
+    return config.value("database", json::object())
+        .value("sharded", json::object())
+        .value("directory", "../data/shards");
+}
+
+int ConfigManager::getShardCount() const
+{
+    if (!loaded)
+        return 4;
+
+    return config.value("database", json::object())
+        .value("sharded", json::object())
+        .value("shard_count", 4);
+}
+
+int ConfigManager::getShardThreads() const
+{
+    if (!loaded)
+        return 0;
+
+    return config.value("database", json::object())
+        .value("sharded", json::object())
+        .value("threads", 0);
+}
+
 std::string ConfigManager::getPostgresqlHost() const
 {
     if (!loaded)
@@ -124,6 +204,190 @@ int ConfigManager::getPostgresqlConnectionTimeout() const
         .value("connection_timeout", 30);
 }
 
+int ConfigManager::getPostgresqlMinPoolSize() const
+{
+    if (!loaded)
+        return 1;
+
+    return config.value("database", json::object())
+        .value("postgresql", json::object())
+        .value("min_pool_size", 1);
+}
+
+int ConfigManager::getPostgresqlAcquireTimeoutMs() const
+{
+    if (!loaded)
+        return 5000;
+
+    return config.value("database", json::object())
+        .value("postgresql", json::object())
+        .value("acquire_timeout_ms", 5000);
+}
+
+int ConfigManager::getPostgresqlMaxLifetime() const
+{
+    if (!loaded)
+        return 1800;
+
+    return config.value("database", json::object())
+        .value("postgresql", json::object())
+        .value("max_lifetime_seconds", 1800);
+}
+
+int ConfigManager::getPostgresqlHealthCheckInterval() const
+{
+    if (!loaded)
+        return 30;
+
+    return config.value("database", json::object())
+        .value("postgresql", json::object())
+        .value("health_check_interval_seconds", 30);
+}
+
+int ConfigManager::getPostgresqlAsyncConnections() const
+{
+    if (!loaded)
+        return 0;
+
+    return config.value("database", json::object())
+        .value("postgresql", json::object())
+        .value("async_connections", 0);
+}
+
+std::vector<PostgresqlReplicaConfig> ConfigManager::getPostgresqlReplicas() const
+{
+    std::vector<PostgresqlReplicaConfig> replicas;
+    if (!loaded)
+        return replicas;
+
+    json replicasJson = config.value("database", json::object())
+                            .value("postgresql", json::object())
+                            .value("replicas", json::array());
+    if (!replicasJson.is_array())
+        return replicas;
+
+    for (const auto &item : replicasJson)
+    {
+        PostgresqlReplicaConfig replica;
+        replica.host = item.value("host", getPostgresqlHost());
+        replica.port = item.value("port", getPostgresqlPort());
+        replica.database = item.value("database", getPostgresqlDatabase());
+        replica.username = item.value("username", getPostgresqlUsername());
+        replica.password = item.value("password", getPostgresqlPassword());
+        replica.connectionPoolSize = item.value("connection_pool_size", getPostgresqlConnectionPoolSize());
+        replicas.push_back(replica);
+    }
+    return replicas;
+}
+
+bool ConfigManager::getPostgresqlHedgedReads() const
+{
+    if (!loaded)
+        return false;
+
+    return config.value("database", json::object())
+        .value("postgresql", json::object())
+        .value("hedged_reads", false);
+}
+
+int ConfigManager::getPostgresqlHedgeMinDelayMs() const
+{
+    if (!loaded)
+        return 5;
+
+    return config.value("database", json::object())
+        .value("postgresql", json::object())
+        .value("hedge_min_delay_ms", 5);
+}
+
+bool ConfigManager::getPostgresqlListenNotify() const
+{
+    if (!loaded)
+        return true;
+
+    return config.value("database", json::object())
+        .value("postgresql", json::object())
+        .value("listen_notify", true);
+}
+
+int ConfigManager::getReadYourWritesWindowMs() const
+{
+    if (!loaded)
+        return 1000;
+
+    return config.value("database", json::object()).value("read_your_writes_window_ms", 1000);
+}
+
+int ConfigManager::getIoThreads() const
+{
+    if (!loaded)
+        return 0;
+
+    return config.value("database", json::object())
+        .value("io_executor", json::object())
+        .value("threads", 0);
+}
+
+int ConfigManager::getIoQueueCapacity() const
+{
+    if (!loaded)
+        return 1024;
+
+    return config.value("database", json::object())
+        .value("io_executor", json::object())
+        .value("queue_capacity", 1024);
+}
+
+int ConfigManager::getIoDefaultTimeoutMs() const
+{
+    if (!loaded)
+        return 0;
+
+    return config.value("database", json::object())
+        .value("io_executor", json::object())
+        .value("default_timeout_ms", 0);
+}
+
+std::string ConfigManager::getSnapshotPath() const
+{
+    if (!loaded)
+        return "";
+
+    return config.value("database", json::object())
+        .value("snapshot", json::object())
+        .value("path", "");
+}
+
+int ConfigManager::getSnapshotServeWindow() const
+{
+    if (!loaded)
+        return 60;
+
+    return config.value("database", json::object())
+        .value("snapshot", json::object())
+        .value("serve_window_seconds", 60);
+}
+
+int ConfigManager::getSnapshotMaxAge() const
+{
+    if (!loaded)
+        return 3600;
+
+    return config.value("database", json::object())
+        .value("snapshot", json::object())
+        .value("max_age_seconds", 3600);
+}
+
+int ConfigManager::getSnapshotRefreshInterval() const
+{
+    if (!loaded)
+        return 600;
+
+    return config.value("database", json::object())
+        .value("snapshot", json::object())
+        .value("refresh_interval_seconds", 600);
+}
+
 std::string ConfigManager::getRedisHost() const
 {
     if (!loaded)
@@ -156,6 +420,86 @@ double ConfigManager::getRedisTimeout() const
     return config.value("redis", json::object()).value("timeout_seconds", 1.5);
 }
 
+int ConfigManager::getRedisPoolSize() const
+{
+    if (!loaded)
+        return 0;
+
+    return config.value("redis", json::object()).value("pool_size", 0);
+}
+
+int ConfigManager::getRedisAcquireTimeoutMs() const
+{
+    if (!loaded)
+        return 1000;
+
+    return config.value("redis", json::object()).value("acquire_timeout_ms", 1000);
+}
+
+bool ConfigManager::getRedisAutoPipeline() const
+{
+    if (!loaded)
+        return false;
+
+    return config.value("redis", json::object()).value("auto_pipeline", false);
+}
+
+int ConfigManager::getRedisPipelineConnections() const
+{
+    if (!loaded)
+        return 1;
+
+    return config.value("redis", json::object()).value("pipeline_connections", 1);
+}
+
+int ConfigManager::getRedisPipelineMaxBatch() const
+{
+    if (!loaded)
+        return 128;
+
+    return config.value("redis", json::object()).value("pipeline_max_batch", 128);
+}
+
+int ConfigManager::getRedisBreakerFailureThreshold() const
+{
+    if (!loaded)
+        return 3;
+
+    return config.value("redis", json::object()).value("breaker_failure_threshold", 3);
+}
+
+int ConfigManager::getRedisBreakerInitialBackoffMs() const
+{
+    if (!loaded)
+        return 500;
+
+    return config.value("redis", json::object()).value("breaker_initial_backoff_ms", 500);
+}
+
+int ConfigManager::getRedisBreakerMaxBackoffMs() const
+{
+    if (!loaded)
+        return 30000;
+
+    return config.value("redis", json::object()).value("breaker_max_backoff_ms", 30000);
+}
+
+std::string ConfigManager::getRedisClientTracking() const
+{
+    if (!loaded)
+        return "off";
+
+    return config.value("redis", json::object()).value("client_tracking", "off");
+}
+
+std::string ConfigManager::getRedisTrackingPrefix() const
+{
+    if (!loaded)
+        return "student:";
+
+    return config.value("redis", json::object()).value("tracking_prefix", "student:");
+}
+
 std::string ConfigManager::getServerHost() const
 {
     if (!loaded)
@@ -172,6 +516,38 @@ int ConfigManager::getServerPort() const
     return config.value("server", json::object()).value("port", 8080);
 }
 
+int ConfigManager::getCoroutineThreads() const
+{
+    if (!loaded)
+        return 2;
+
+    return config.value("server", json::object()).value("coroutine_threads", 2);
+}
+
+std::string ConfigManager::getServerFrontend() const
+{
+    if (!loaded)
+        return "httplib";
+
+    return config.value("server", json::object()).value("frontend", "httplib");
+}
+
+int ConfigManager::getMaxRequestBytes() const
+{
+    if (!loaded)
+        return 1048576;
+
+    return config.value("server", json::object()).value("max_request_bytes", 1048576);
+}
+
+int ConfigManager::getIdleTimeoutSeconds() const
+{
+    if (!loaded)
+        return 60;
+
+    return config.value("server", json::object()).value("idle_timeout_seconds", 60);
+}
+
 int ConfigManager::getStudentCacheExpire() const
 {
     if (!loaded)
@@ -195,3 +571,91 @@ int ConfigManager::getCountCacheExpire() const
 
     return config.value("cache", json::object()).value("count_expire_seconds", 30);
 }
+
+int ConfigManager::getLocalCacheCapacityMb() const
+{
+    if (!loaded)
+        return 16;
+
+    return config.value("cache", json::object()).value("local_capacity_mb", 16);
+}
+
+int ConfigManager::getLocalCacheShards() const
+{
+    if (!loaded)
+        return 16;
+
+    return config.value("cache", json::object()).value("local_shards", 16);
+}
+
+int ConfigManager::getLocalCacheTtlSeconds() const
+{
+    if (!loaded)
+        return 30;
+
+    return config.value("cache", json::object()).value("local_ttl_seconds", 30);
+}
+
+double ConfigManager::getCacheSoftTtlRatio() const
+{
+    if (!loaded)
+        return 0.8;
+
+    return config.value("cache", json::object()).value("soft_ttl_ratio", 0.8);
+}
+
+double ConfigManager::getCacheXfetchBeta() const
+{
+    if (!loaded)
+        return 1.0;
+
+    return config.value("cache", json::object()).value("xfetch_beta", 1.0);
+}
+
+int ConfigManager::getNegativeCacheExpire() const
+{
+    if (!loaded)
+        return 10;
+
+    return config.value("cache", json::object()).value("negative_expire_seconds", 10);
+}
+
+bool ConfigManager::getExistenceFilterEnabled() const
+{
+    if (!loaded)
+        return true;
+
+    return config.value("cache", json::object()).value("existence_filter", true);
+}
+
+int ConfigManager::getWarmupCount() const
+{
+    if (!loaded)
+        return 1000;
+
+    return config.value("cache", json::object()).value("warmup_count", 1000);
+}
+
+int ConfigManager::getWarmupBatchSize() const
+{
+    if (!loaded)
+        return 256;
+
+    return config.value("cache", json::object()).value("warmup_batch_size", 256);
+}
+
+int ConfigManager::getWarmupBudgetMs() const
+{
+    if (!loaded)
+        return 5000;
+
+    return config.value("cache", json::object()).value("warmup_budget_ms", 5000);
+}
+
+std::string ConfigManager::getWarmupHotIdsPath() const
+{
+    if (!loaded)
+        return "";
+
+    return config.value("cache", json::object()).value("warmup_hot_ids_path", "");
+}
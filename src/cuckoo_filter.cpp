@@ -0,0 +1,143 @@
+#include "cuckoo_filter.h"
+
+namespace
+{
+    uint64_t mix(uint64_t value)
+    {
+        // splitmix64终结函数
+        value += 0x9e3779b97f4a7c15ull;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+}
+
+CuckooFilter::CuckooFilter(size_t capacity) : count(0), randomState(0x2545f4914f6cdd1dull)
+{
+    size_t buckets = 1;
+    while (buckets * kBucketSize * 95 / 100 < capacity)
+        buckets <<= 1;
+    table.assign(buckets * kBucketSize, 0);
+    bucketMask = buckets - 1;
+}
+
+CuckooFilter::Position CuckooFilter::locate(uint64_t key) const
+{
+    uint64_t hash = mix(key);
+    uint16_t fingerprint = static_cast<uint16_t>(hash >> 48);
+    if (fingerprint == 0)
+        fingerprint = 1;
+    size_t first = static_cast<size_t>(hash) & bucketMask;
+    return Position{fingerprint, first, alternate(first, fingerprint)};
+}
+
+size_t CuckooFilter::alternate(size_t bucket, uint16_t fingerprint) const
+{
+    // 异或保证两个候选桶互为对方的alternate
+    return (bucket ^ static_cast<size_t>(mix(fingerprint))) & bucketMask;
+}
+
+bool CuckooFilter::hasFingerprint(size_t bucket, uint16_t fingerprint) const
+{
+    const uint16_t *slots = &table[bucket * kBucketSize];
+    for (size_t i = 0; i < kBucketSize; ++i)
+    {
+        if (slots[i] == fingerprint)
+            return true;
+    }
+    return false;
+}
+
+bool CuckooFilter::place(size_t bucket, uint16_t fingerprint)
+{
+    uint16_t *slots = &table[bucket * kBucketSize];
+    for (size_t i = 0; i < kBucketSize; ++i)
+    {
+        if (slots[i] == 0)
+        {
+            slots[i] = fingerprint;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CuckooFilter::remove(size_t bucket, uint16_t fingerprint)
+{
+    uint16_t *slots = &table[bucket * kBucketSize];
+    for (size_t i = 0; i < kBucketSize; ++i)
+    {
+        if (slots[i] == fingerprint)
+        {
+            slots[i] = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CuckooFilter::insert(uint64_t key)
+{
+    Position position = locate(key);
+    if (place(position.first, position.fingerprint) || place(position.second, position.fingerprint))
+    {
+        ++count;
+        return true;
+    }
+
+    // 两个桶都满：随机踢出一个指纹到它的另一个桶，失败时按记录的路径撤销
+    struct Kick
+    {
+        size_t bucket;
+        size_t slot;
+        uint16_t fingerprint;
+    };
+    std::vector<Kick> path;
+    path.reserve(kMaxKicks);
+
+    size_t bucket = (randomState & 1) ? position.first : position.second;
+    uint16_t fingerprint = position.fingerprint;
+    for (int kick = 0; kick < kMaxKicks; ++kick)
+    {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 7;
+        randomState ^= randomState << 17;
+        size_t slot = static_cast<size_t>(randomState % kBucketSize);
+
+        uint16_t &victim = table[bucket * kBucketSize + slot];
+        path.push_back(Kick{bucket, slot, victim});
+        uint16_t evicted = victim;
+        victim = fingerprint;
+
+        fingerprint = evicted;
+        bucket = alternate(bucket, fingerprint);
+        if (place(bucket, fingerprint))
+        {
+            ++count;
+            return true;
+        }
+    }
+
+    for (auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        table[it->bucket * kBucketSize + it->slot] = it->fingerprint;
+    }
+    return false;
+}
+
+bool CuckooFilter::contains(uint64_t key) const
+{
+    Position position = locate(key);
+    return hasFingerprint(position.first, position.fingerprint) || hasFingerprint(position.second, position.fingerprint);
+}
+
+bool CuckooFilter::erase(uint64_t key)
+{
+    Position position = locate(key);
+    if (remove(position.first, position.fingerprint) || remove(position.second, position.fingerprint))
+    {
+        --count;
+        return true;
+    }
+    return false;
+}
@@ -3,10 +3,92 @@
 #include <vector>
 #include <iostream>
 #include <sstream>
+#include <fstream>
+#include <algorithm>
 #include <nlohmann/json.hpp>
+#include <charconv>
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include "student_codec.h"
 
 using json = nlohmann::json;
 
+namespace
+{
+    // 将回调式异步操作包装为future
+    template <typename T, typename Start>
+    std::future<T> makeFuture(Start start)
+    {
+        auto promise = std::make_shared<std::promise<T>>();
+        std::future<T> future = promise->get_future();
+        start([promise](T value)
+              { promise->set_value(std::move(value)); });
+        return future;
+    }
+
+    RedisManager::Options redisPoolOptions(const ConfigManager &configManager)
+    {
+        RedisManager::Options options;
+        options.host = configManager.getRedisHost();
+        options.port = configManager.getRedisPort();
+        options.password = configManager.getRedisPassword();
+        options.poolSize = static_cast<size_t>(std::max(configManager.getRedisPoolSize(), 0));
+        options.timeout = std::chrono::milliseconds(static_cast<long long>(configManager.getRedisTimeout() * 1000));
+        options.acquireTimeout = std::chrono::milliseconds(std::max(configManager.getRedisAcquireTimeoutMs(), 0));
+        options.autoPipeline = configManager.getRedisAutoPipeline();
+        options.pipelineConnections = static_cast<size_t>(std::max(configManager.getRedisPipelineConnections(), 1));
+        options.pipelineMaxBatch = static_cast<size_t>(std::max(configManager.getRedisPipelineMaxBatch(), 1));
+        options.failureThreshold = static_cast<uint32_t>(std::max(configManager.getRedisBreakerFailureThreshold(), 1));
+        options.initialBackoff = std::chrono::milliseconds(configManager.getRedisBreakerInitialBackoffMs());
+        options.maxBackoff = std::chrono::milliseconds(configManager.getRedisBreakerMaxBackoffMs());
+        std::string tracking = configManager.getRedisClientTracking();
+        if (tracking == "default")
+            options.tracking = RedisManager::TrackingMode::Default;
+        else if (tracking == "broadcast")
+            options.tracking = RedisManager::TrackingMode::Broadcast;
+        else if (tracking != "off")
+            Logger::warn("未知的Redis客户端缓存跟踪模式: {}，已关闭", tracking);
+        options.trackingPrefix = configManager.getRedisTrackingPrefix();
+        return options;
+    }
+
+    StudentCache::Options localCacheOptions(const ConfigManager &configManager)
+    {
+        StudentCache::Options options;
+        options.capacityBytes = static_cast<size_t>(std::max(configManager.getLocalCacheCapacityMb(), 0)) * 1024 * 1024;
+        options.shards = static_cast<size_t>(std::max(configManager.getLocalCacheShards(), 1));
+        options.ttl = std::chrono::seconds(configManager.getLocalCacheTtlSeconds());
+        return options;
+    }
+
+    long long unixMillis()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // XFetch：越接近软过期、加载越慢越可能提前刷新，同一热点键的刷新时刻被随机分散开
+    bool refreshDue(const CacheStamp &stamp, double beta)
+    {
+        if (stamp.softExpiresAt <= 0)
+            return false;
+
+        thread_local std::mt19937 random(std::random_device{}());
+        double sample = std::generate_canonical<double, 32>(random);
+        double early = stamp.loadMillis * beta * -std::log(std::max(sample, 1e-12));
+        return unixMillis() + static_cast<long long>(early) >= stamp.softExpiresAt;
+    }
+
+    // 在调用方提供的缓冲中生成"student:<id>"缓存键，不分配内存
+    std::string_view studentCacheKey(char (&buffer)[32], int id)
+    {
+        static constexpr std::string_view prefix = "student:";
+        prefix.copy(buffer, prefix.size());
+        auto result = std::to_chars(buffer + prefix.size(), buffer + sizeof(buffer), id);
+        return std::string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+}
+
 std::unique_ptr<DatabaseInterface> DatabaseManager::createDatabase()
 {
     if (!configManager)
@@ -27,6 +109,16 @@ std::unique_ptr<DatabaseInterface> DatabaseManager::createDatabase()
         Logger::info("使用PostgreSQL数据库");
         return std::make_unique<PostgreSQLDatabase>(*configManager);
     }
+    else if (dbType == "memory")
+    {
+        Logger::info("使用内存数据库");
+        return std::make_unique<MemoryDatabase>(*configManager);
+    }
+    else if (dbType == "sharded")
+    {
+        Logger::info("使用分片SQLite数据库");
+        return std::make_unique<ShardedDatabase>(*configManager);
+    }
     else
     {
         Logger::error("不支持的数据库类型: {}", dbType);
@@ -35,18 +127,58 @@ std::unique_ptr<DatabaseInterface> DatabaseManager::createDatabase()
 }
 
 DatabaseManager::DatabaseManager(const ConfigManager &configManager)
-    : configManager(&configManager),
-      redisManager(configManager.getRedisHost(), configManager.getRedisPort(), configManager.getRedisPassword())
+    : localCache(localCacheOptions(configManager)),
+      redisManager(redisPoolOptions(configManager)),
+      configManager(&configManager),
+      readYourWritesWindow(configManager.getReadYourWritesWindowMs()),
+      snapshotPath(configManager.getSnapshotPath()),
+      snapshotMembershipChanged(false), snapshotStale(false), snapshotWriterRunning(false),
+      softTtlRatio(configManager.getCacheSoftTtlRatio()), xfetchBeta(configManager.getCacheXfetchBeta()),
+      refreshingCount(false), countVersion(0), loadMillis(0), cacheRefreshCount(0),
+      negativeExpireSeconds(configManager.getNegativeCacheExpire()), existenceFilterEnabled(false),
+      existenceFilterRebuilding(false), existenceFilterGeneration(0), filterRejectCount(0), negativeHitCount(0),
+      warmupCount(static_cast<size_t>(std::max(configManager.getWarmupCount(), 0))),
+      warmupBatchSize(static_cast<size_t>(std::max(configManager.getWarmupBatchSize(), 1))),
+      warmupBudget(configManager.getWarmupBudgetMs()), warmupHotIdsPath(configManager.getWarmupHotIdsPath()),
+      warmupStopping(false), ready(false), warmupSource("none"), warmupLoaded(0), warmupSkipped(0), warmupMillis(0),
+      listCacheExpire(std::max(configManager.getStudentsListCacheExpire(), 0)),
+      listCacheBypassUntil(0), listCacheHits(0), listCacheMisses(0)
 {
     database = createDatabase();
+    // 过滤器依赖看到所有写入：PostgreSQL需要LISTEN/NOTIFY送达其他实例与外部写入方的变更
+    existenceFilterEnabled = database && configManager.getExistenceFilterEnabled() &&
+                             (configManager.getDatabaseType() != "postgresql" || configManager.getPostgresqlListenNotify());
+
+    size_t ioThreads = configManager.getIoThreads() > 0 ? static_cast<size_t>(configManager.getIoThreads()) : defaultIoThreads();
+    ioExecutor = std::make_unique<IoExecutor>(ioThreads, configManager.getIoQueueCapacity(),
+                                              std::chrono::milliseconds(configManager.getIoDefaultTimeoutMs()));
+    coroutineScheduler = std::make_unique<ThreadPool>(static_cast<size_t>(std::max(configManager.getCoroutineThreads(), 1)));
+    redisManager.setInvalidationListener([this](const std::vector<std::string_view> &keys)
+                                         { onCacheInvalidated(keys); });
+    if (database)
+    {
+        database->setChangeListener([this](const StudentChangeEvent &event)
+                                    { onStudentChanged(event); });
+    }
 }
 
 DatabaseManager::DatabaseManager(const std::string &path, const std::string &redisHost, int redisPort)
-    : configManager(nullptr),
-      redisManager(redisHost, redisPort)
+    : redisManager(redisHost, redisPort),
+      configManager(nullptr),
+      readYourWritesWindow(1000),
+      snapshotMembershipChanged(false), snapshotStale(false), snapshotWriterRunning(false),
+      softTtlRatio(0.8), xfetchBeta(1.0),
+      refreshingCount(false), countVersion(0), loadMillis(0), cacheRefreshCount(0),
+      negativeExpireSeconds(10), existenceFilterEnabled(true),
+      existenceFilterRebuilding(false), existenceFilterGeneration(0), filterRejectCount(0), negativeHitCount(0),
+      warmupCount(0), warmupBatchSize(256), warmupBudget(0),
+      warmupStopping(false), ready(false), warmupSource("none"), warmupLoaded(0), warmupSkipped(0), warmupMillis(0),
+      listCacheExpire(60), listCacheBypassUntil(0), listCacheHits(0), listCacheMisses(0)
 {
     // 使用默认SQLite数据库
     database = std::make_unique<SQLiteDatabase>(path);
+    ioExecutor = std::make_unique<IoExecutor>(defaultIoThreads(), 1024, std::chrono::milliseconds(0));
+    coroutineScheduler = std::make_unique<ThreadPool>(2);
 }
 
 DatabaseManager::~DatabaseManager()
@@ -79,16 +211,60 @@ bool DatabaseManager::open()
         Logger::info("Redis连接成功");
     }
 
+    openSnapshot();
+    // 全表扫描不阻塞启动，构建完成前过滤器放行所有请求
+    rebuildExistenceFilter();
+
+    // 预热在后台进行，期间请求照常处理，只是尚未报告就绪
+    if (warmupCount == 0 || warmupBudget.count() <= 0)
+    {
+        ready = true;
+    }
+    else if (!warmupThread.joinable())
+    {
+        warmupStopping = false;
+        warmupThread = std::thread(&DatabaseManager::warmUpCache, this);
+    }
+
     Logger::info("数据库连接成功，类型: {}", getDatabaseType());
     return true;
 }
 
 void DatabaseManager::close()
 {
+    warmupStopping = true;
+    if (warmupThread.joinable())
+    {
+        warmupThread.join();
+    }
+    saveHotIds();
+    ready = false;
+
+    {
+        std::lock_guard<std::mutex> lock(snapshotWriterMutex);
+        snapshotWriterRunning = false;
+    }
+    snapshotWriterCv.notify_all();
+    if (snapshotWriter.joinable())
+    {
+        snapshotWriter.join();
+    }
+
+    // 先排空执行器中的操作再关闭数据库
+    if (ioExecutor)
+    {
+        ioExecutor->shutdown();
+    }
+    if (coroutineScheduler)
+    {
+        coroutineScheduler->shutdown();
+    }
+
     if (database)
     {
         database->close();
     }
+    snapshot.close();
 }
 
 std::string DatabaseManager::getDatabaseType() const
@@ -100,7 +276,295 @@ std::string DatabaseManager::getDatabaseType() const
     return configManager->getDatabaseType();
 }
 
-int DatabaseManager::addStudent(const Student &student)
+json DatabaseManager::getMetrics() const
+{
+    json metrics;
+    metrics["database_type"] = getDatabaseType();
+    metrics["database"] = database ? database->getMetrics() : json::object();
+
+    if (ioExecutor)
+    {
+        IoExecutor::Stats stats = ioExecutor->getStats();
+        metrics["io_executor"] = {
+            {"threads", stats.threads},
+            {"queued", stats.queued},
+            {"capacity", stats.capacity},
+            {"completed", stats.completed},
+            {"timeouts", stats.timeouts},
+            {"cancelled", stats.cancelled},
+            {"rejected", stats.rejected},
+            {"failed", stats.failed}};
+    }
+
+    RedisManager::Stats redisStats = redisManager.getStats();
+    metrics["redis_pool"] = {
+        {"size", redisStats.poolSize},
+        {"in_use", redisStats.inUse},
+        {"connects", redisStats.connects},
+        {"acquire_timeouts", redisStats.acquireTimeouts},
+        {"pipeline_batches", redisStats.pipelineBatches},
+        {"pipelined_commands", redisStats.pipelinedCommands}};
+    metrics["redis_breaker"] = {
+        {"state", redisStats.breakerOpen ? "open" : "closed"},
+        {"consecutive_failures", redisStats.consecutiveFailures},
+        {"trips", redisStats.breakerTrips},
+        {"bypassed", redisStats.bypassed}};
+    metrics["redis_tracking"] = {
+        {"connected", redisStats.trackingConnected},
+        {"invalidations", redisStats.invalidations}};
+
+    StudentCache::Stats cacheStats = localCache.getStats();
+    metrics["local_cache"] = {
+        {"entries", cacheStats.entries},
+        {"bytes", cacheStats.bytes},
+        {"capacity_bytes", cacheStats.capacityBytes},
+        {"hits", cacheStats.hits},
+        {"misses", cacheStats.misses},
+        {"evictions", cacheStats.evictions},
+        {"expirations", cacheStats.expirations}};
+    metrics["cache_refresh"] = {
+        {"refreshes", cacheRefreshCount.load()},
+        {"load_millis", loadMillis.load()}};
+    {
+        std::shared_lock<std::shared_mutex> lock(existenceFilterMutex);
+        metrics["existence_filter"] = {
+            {"enabled", existenceFilterEnabled},
+            {"ready", existenceFilter != nullptr},
+            {"entries", existenceFilter ? existenceFilter->size() : 0},
+            {"slots", existenceFilter ? existenceFilter->capacity() : 0},
+            {"memory_bytes", existenceFilter ? existenceFilter->memoryBytes() : 0},
+            {"rejected", filterRejectCount.load()}};
+    }
+    metrics["negative_cache"] = {
+        {"expire_seconds", negativeExpireSeconds},
+        {"hits", negativeHitCount.load()}};
+    metrics["warmup"] = {
+        {"ready", ready.load()},
+        {"source", warmupSource.load()},
+        {"loaded", warmupLoaded.load()},
+        {"skipped", warmupSkipped.load()},
+        {"elapsed_ms", warmupMillis.load()}};
+    metrics["list_cache"] = {
+        {"expire_seconds", listCacheExpire},
+        {"hits", listCacheHits.load()},
+        {"misses", listCacheMisses.load()},
+        {"bypassed", unixMillis() < listCacheBypassUntil.load()}};
+    return metrics;
+}
+
+size_t DatabaseManager::defaultIoThreads() const
+{
+    // 执行器线程大多在等待Redis与数据库，线程数与后端可并行的连接数相当
+    std::string type = getDatabaseType();
+    if (type == "postgresql")
+        return static_cast<size_t>(std::max(configManager->getPostgresqlConnectionPoolSize(), 1)) * 2;
+    if (type == "sharded")
+        return static_cast<size_t>(std::max(configManager->getShardCount(), 1)) * 2;
+    if (type == "memory")
+        return std::max<size_t>(std::thread::hardware_concurrency(), 2);
+    return 4;
+}
+
+void DatabaseManager::recordWrite(const std::string &clientId)
+{
+    if (clientId.empty() || readYourWritesWindow.count() <= 0)
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(recentWritesMutex);
+    recentWrites[clientId] = now;
+
+    // 定期清理过期记录，防止无限增长
+    if (recentWrites.size() > 10000)
+    {
+        for (auto it = recentWrites.begin(); it != recentWrites.end();)
+        {
+            if (now - it->second > readYourWritesWindow)
+                it = recentWrites.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
+bool DatabaseManager::shouldReadPrimary(const std::string &clientId)
+{
+    if (clientId.empty())
+        return false;
+
+    std::lock_guard<std::mutex> lock(recentWritesMutex);
+    auto it = recentWrites.find(clientId);
+    if (it == recentWrites.end())
+        return false;
+
+    if (std::chrono::steady_clock::now() - it->second > readYourWritesWindow)
+    {
+        recentWrites.erase(it);
+        return false;
+    }
+    return true;
+}
+
+void DatabaseManager::openSnapshot()
+{
+    if (snapshotPath.empty())
+        return;
+
+    int serveWindow = configManager ? configManager->getSnapshotServeWindow() : 0;
+    int maxAge = configManager ? configManager->getSnapshotMaxAge() : 0;
+    if (serveWindow > 0 && snapshot.open(snapshotPath))
+    {
+        std::time_t age = std::time(nullptr) - snapshot.createdAt();
+        if (maxAge > 0 && age > maxAge)
+        {
+            Logger::warn("启动快照已生成 {} 秒，超过上限 {} 秒，不使用", age, maxAge);
+            snapshot.close();
+        }
+    }
+    if (snapshot.isOpen())
+    {
+        snapshotServeUntil = std::chrono::steady_clock::now() + std::chrono::seconds(serveWindow);
+        Logger::info("已映射启动快照，记录数: {}，服务窗口: {}秒", snapshot.size(), serveWindow);
+        validateSnapshot();
+    }
+
+    if (configManager && configManager->getSnapshotRefreshInterval() > 0 && !snapshotWriter.joinable())
+    {
+        snapshotWriterRunning = true;
+        snapshotWriter = std::thread(&DatabaseManager::snapshotWriterLoop, this);
+    }
+}
+
+void DatabaseManager::validateSnapshot()
+{
+    if (!database)
+        return;
+
+    int count;
+    long long maxId;
+    {
+        PrimaryReadScope primaryRead;
+        count = database->getStudentCount();
+        maxId = database->getMaxStudentId();
+    }
+    if (count >= 0 && maxId >= 0 && static_cast<size_t>(count) == snapshot.size() && maxId == snapshot.maxId())
+        return;
+
+    std::lock_guard<std::mutex> lock(snapshotDirtyMutex);
+    snapshotMembershipChanged = true;
+    Logger::warn("启动快照与数据库不一致（快照记录数 {}，最大id {}；数据库记录数 {}，最大id {}），只用于点查",
+                 snapshot.size(), snapshot.maxId(), count, maxId);
+}
+
+bool DatabaseManager::servesFromSnapshot() const
+{
+    return snapshot.isOpen() && std::chrono::steady_clock::now() < snapshotServeUntil;
+}
+
+bool DatabaseManager::snapshotClean()
+{
+    if (!servesFromSnapshot())
+        return false;
+
+    std::lock_guard<std::mutex> lock(snapshotDirtyMutex);
+    return !snapshotStale && !snapshotMembershipChanged && snapshotDirty.empty();
+}
+
+bool DatabaseManager::readFromSnapshot(int id, Student &student)
+{
+    if (!servesFromSnapshot())
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(snapshotDirtyMutex);
+        if (snapshotStale || snapshotDirty.count(id) > 0)
+            return false;
+    }
+
+    // 快照生成后到本进程启动之间的写入无从得知，快照中没有不代表数据库中没有，交由数据库确认
+    StudentView view;
+    if (!snapshot.find(id, view))
+        return false;
+
+    student = view.toStudent();
+    return true;
+}
+
+void DatabaseManager::markSnapshotDirty(int id, bool membershipChanged)
+{
+    if (!snapshot.isOpen())
+        return;
+
+    std::lock_guard<std::mutex> lock(snapshotDirtyMutex);
+    if (id > 0)
+    {
+        snapshotDirty.insert(id);
+    }
+    if (membershipChanged)
+    {
+        snapshotMembershipChanged = true;
+    }
+}
+
+void DatabaseManager::markSnapshotStale()
+{
+    if (!snapshot.isOpen())
+        return;
+
+    std::lock_guard<std::mutex> lock(snapshotDirtyMutex);
+    snapshotStale = true;
+}
+
+void DatabaseManager::snapshotWriterLoop()
+{
+    std::chrono::seconds interval(configManager->getSnapshotRefreshInterval());
+
+    // 启动时没有快照文件则立即生成一份
+    bool due = !std::ifstream(snapshotPath).good();
+
+    std::unique_lock<std::mutex> lock(snapshotWriterMutex);
+    while (snapshotWriterRunning)
+    {
+        if (!due)
+        {
+            snapshotWriterCv.wait_for(lock, interval, [this]()
+                                      { return !snapshotWriterRunning; });
+            if (!snapshotWriterRunning)
+                break;
+        }
+        due = false;
+
+        lock.unlock();
+        refreshSnapshot();
+        lock.lock();
+    }
+}
+
+void DatabaseManager::refreshSnapshot()
+{
+    if (!database)
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+    StudentSnapshot::Builder builder;
+    long long exported = database->exportStudents([&builder](int id, const Student &student)
+                                                  {
+        builder.add(id, student);
+        return true; });
+    if (exported < 0)
+    {
+        Logger::error("生成启动快照失败：导出学生数据出错");
+        return;
+    }
+
+    if (builder.write(snapshotPath))
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        Logger::info("启动快照已更新，记录数: {}，耗时: {}ms", builder.size(), elapsed.count());
+    }
+}
+
+int DatabaseManager::addStudent(const Student &student, const std::string &clientId)
 {
     if (!database)
     {
@@ -108,18 +572,23 @@ int DatabaseManager::addStudent(const Student &student)
         return -1;
     }
 
+    markSnapshotDirty(0, true);
     int studentId = database->addStudent(student);
     if (studentId > 0)
     {
-        // 更新该学生的缓存
+        noteStudentAdded(studentId);
+        recordWrite(clientId);
+        markSnapshotDirty(studentId, true);
+        // 更新该学生的缓存，学生数量已变化
         updateStudentCache(studentId, student);
+        clearStudentsCache();
         Logger::info("添加学生成功，ID: {}，已更新缓存", studentId);
     }
 
     return studentId;
 }
 
-bool DatabaseManager::updateStudent(int id, const Student &student)
+bool DatabaseManager::updateStudent(int id, const Student &student, const std::string &clientId)
 {
     if (!database)
     {
@@ -127,20 +596,23 @@ bool DatabaseManager::updateStudent(int id, const Student &student)
         return false;
     }
 
+    markSnapshotDirty(id, false);
     bool success = database->updateStudent(id, student);
     if (success)
     {
+        recordWrite(clientId);
         // 清除相关缓存
         clearStudentCache(id);
         // 更新该学生的缓存
         updateStudentCache(id, student);
+        bumpStudentListGeneration();
         Logger::info("更新学生成功，ID: {}，已更新缓存", id);
     }
 
     return success;
 }
 
-bool DatabaseManager::deleteStudent(int id)
+bool DatabaseManager::deleteStudent(int id, const std::string &clientId)
 {
     if (!database)
     {
@@ -148,126 +620,140 @@ bool DatabaseManager::deleteStudent(int id)
         return false;
     }
 
+    markSnapshotDirty(id, true);
     bool success = database->deleteStudent(id);
     if (success)
     {
+        noteStudentDeleted(id);
+        recordWrite(clientId);
         // 清除相关缓存
         clearStudentCache(id);
+        clearStudentsCache();
         Logger::info("删除学生成功，ID: {}，已清除缓存", id);
     }
 
     return success;
 }
 
-Student DatabaseManager::getStudent(int id)
+Student DatabaseManager::getStudent(int id, const std::string &clientId)
 {
-    // 尝试从缓存获取
-    std::string cacheKey = "student:" + std::to_string(id);
-    std::string cachedStudent = redisManager.get(cacheKey);
+    // 读取前的版本：读取期间该id有写入或失效时，读到的值可能已过时，不回填缓存
+    std::atomic<uint64_t> &version = studentVersion(id);
+    uint64_t sequence = version.load();
 
-    if (!cachedStudent.empty())
+    // 先查进程内缓存，再查Redis
     {
-        Student student = studentFromCacheString(cachedStudent);
-        if (student.getName() != "" || student.getAge() > 0 || student.getClassName() != "")
+        Student student;
+        if (localCache.find(id, student))
+        {
+            return student;
+        }
+
+        // 过滤器确定不存在时直接返回
+        if (!mayExist(id))
         {
-            Logger::info("从缓存获取学生，ID: {}", id);
             return student;
         }
+
+        std::optional<Student> cached = readStudentCache(id);
+        if (cached)
+        {
+            if (cached->getName() != "" || cached->getAge() > 0 || cached->getClassName() != "")
+            {
+                localCache.insert(id, *cached, version, sequence);
+                Logger::info("从缓存获取学生，ID: {}", id);
+            }
+            return *cached;
+        }
     }
 
-    // 缓存未命中，查询数据库
+    bool readPrimary = shouldReadPrimary(clientId);
+
+    // 缓存未命中，冷启动窗口内优先读取快照；快照可能落后于数据库，只写入一级缓存，不发布到共享的Redis
+    Student student;
+    if (!readPrimary && readFromSnapshot(id, student))
+    {
+        admitLocal(id, student, sequence);
+        Logger::info("从启动快照获取学生，ID: {}", id);
+        return student;
+    }
+
+    // 查询数据库
     if (!database)
     {
         Logger::error("数据库实例未初始化");
         return Student();
     }
 
-    Student student = database->getStudent(id);
+    auto loadStart = std::chrono::steady_clock::now();
+    {
+        // 结果会写入共享缓存，固定读取主库：写入后滞后副本的旧值不能被缓存整个过期时间
+        PrimaryReadScope primaryRead;
+        student = database->getStudent(id);
+    }
+    recordLoadTime(std::chrono::steady_clock::now() - loadStart);
     if (student.getName() != "" || student.getAge() > 0 || student.getClassName() != "")
     {
-        // 写入缓存
-        updateStudentCache(id, student);
+        fillStudentCache(id, student, sequence);
         Logger::info("从数据库获取学生，ID: {}，已写入缓存", id);
     }
+    else
+    {
+        cacheStudentMissing(id, sequence);
+    }
 
     return student;
 }
 
-std::vector<std::pair<int, Student>> DatabaseManager::getAllStudents()
+StudentBatch DatabaseManager::getAllStudents(const std::string &clientId)
 {
-    // 尝试从缓存获取
-    // std::string cacheKey = "students:all";
-    // std::string cachedStudents = redisManager.get(cacheKey);
-
-    // if (!cachedStudents.empty())
-    // {
-    //     try
-    //     {
-    //         json j = json::parse(cachedStudents);
-    //         std::vector<std::pair<int, Student>> students;
-
-    //         for (const auto &item : j)
-    //         {
-    //             int id = item.value("id", 0);
-    //             std::string name = item.value("name", "");
-    //             int age = item.value("age", 0);
-    //             std::string className = item.value("className", "");
-    //             students.emplace_back(id, Student(name, age, className));
-    //         }
-
-    //         if (!students.empty())
-    //         {
-    //             Logger::info("从缓存获取所有学生，数量: {}", students.size());
-    //             return students;
-    //         }
-    //     }
-    //     catch (const json::parse_error &e)
-    //     {
-    //         Logger::error("缓存中学生列表解析失败: {}", e.what());
-    //     }
-    // }
+    // 列表不在这一层缓存：HTTP接口按表代数缓存最终响应体（见getStudentListCacheTask）
+    bool readPrimary = shouldReadPrimary(clientId);
+    StudentBatch students;
 
-    // 缓存未命中，查询数据库
+    // 快照未被本地写入或变更通知污染时直接返回快照内容
+    if (!readPrimary && snapshotClean())
+    {
+        students.reserve(snapshot.size());
+        snapshot.forEach([&students](const StudentView &view)
+                         {
+            students.add(view.id, view.age, view.name, view.className);
+            return true; });
+        Logger::info("从启动快照获取所有学生，数量: {}", students.size());
+        return students;
+    }
+
+    // 查询数据库
     if (!database)
     {
         Logger::error("数据库实例未初始化");
         return {};
     }
 
-    std::vector<std::pair<int, Student>> students = database->getAllStudents();
-
-    // 写入缓存（即使为空也写入）
-    // json j = json::array();
-    // for (const auto &pair : students)
-    // {
-    //     json studentJson;
-    //     studentJson["id"] = pair.first;
-    //     studentJson["name"] = pair.second.getName();
-    //     studentJson["age"] = pair.second.getAge();
-    //     studentJson["className"] = pair.second.getClassName();
-    //     j.push_back(studentJson);
-    // }
-    // redisManager.set(cacheKey, j.dump(), 60); // 1分钟过期
+    if (readPrimary)
+    {
+        PrimaryReadScope primaryRead;
+        students = database->getAllStudents();
+    }
+    else
+    {
+        students = database->getAllStudents();
+    }
+
     Logger::info("从数据库获取所有学生，数量: {}", students.size());
 
     return students;
 }
 
-int DatabaseManager::getStudentCount()
+int DatabaseManager::getStudentCount(const std::string &clientId)
 {
     // 尝试从缓存获取
     std::string cacheKey = "students:count";
     std::string cachedCount = redisManager.get(cacheKey);
-    if (!cachedCount.empty())
+    int count;
+    if (!cachedCount.empty() && countFromCacheString(cachedCount, count))
     {
-        try
-        {
-            return std::stoi(cachedCount);
-        }
-        catch (const std::exception &e)
-        {
-            Logger::error("缓存中学生数量解析失败: {}", e.what());
-        }
+        return count;
     }
 
     // 缓存未命中，查询数据库
@@ -277,7 +763,19 @@ int DatabaseManager::getStudentCount()
         return -1;
     }
 
-    int count = database->getStudentCount();
+    bool readPrimary = shouldReadPrimary(clientId);
+    if (!readPrimary && snapshotClean())
+    {
+        // 快照计数不写入共享缓存
+        return static_cast<int>(snapshot.size());
+    }
+
+    {
+        // 结果会写入共享缓存，固定读取主库
+        PrimaryReadScope primaryRead;
+        count = database->getStudentCount();
+    }
+
     if (count >= 0)
     {
         // 写入缓存，设置过期时间
@@ -286,61 +784,1552 @@ int DatabaseManager::getStudentCount()
         {
             expireSeconds = configManager->getCountCacheExpire();
         }
-        redisManager.set(cacheKey, std::to_string(count), expireSeconds);
+        redisManager.set(cacheKey, countToCacheString(count), expireSeconds);
     }
 
     return count;
 }
 
-// 缓存相关方法实现
-std::string DatabaseManager::studentToCacheString(const Student &student) const
+StudentBatch DatabaseManager::getStudents(const std::vector<int> &ids)
 {
-    json j;
-    j["name"] = student.getName();
-    j["age"] = student.getAge();
-    j["className"] = student.getClassName();
-    return j.dump();
-}
+    StudentBatch students;
+    students.reserve(ids.size());
 
-Student DatabaseManager::studentFromCacheString(const std::string &cacheStr) const
-{
-    try
+    // 先查进程内缓存，其余的再查Redis（所有GET在一次往返中完成），收集未命中的ID；
+    // 每个id的版本在读取Redis与数据库之前记录
+    std::vector<int> remoteIds;
+    std::vector<uint64_t> remoteVersions;
+    for (int id : ids)
     {
-        json j = json::parse(cacheStr);
-        std::string name = j.value("name", "");
-        int age = j.value("age", 0);
-        std::string className = j.value("className", "");
-        return Student(name, age, className);
+        Student student;
+        if (localCache.find(id, student))
+        {
+            students.add(id, student);
+        }
+        else if (mayExist(id))
+        {
+            remoteIds.push_back(id);
+            remoteVersions.push_back(studentVersion(id).load());
+        }
     }
-    catch (const json::parse_error &e)
+
+    std::vector<int> missingIds;
+    std::unordered_map<int, uint64_t> missingVersions;
+    if (!remoteIds.empty())
     {
-        Logger::error("缓存中学生数据解析失败: {}", e.what());
-        return Student();
+        RedisManager::Pipeline lookups = redisManager.pipeline();
+        for (int id : remoteIds)
+        {
+            lookups.get("student:" + std::to_string(id));
+        }
+        std::vector<RedisResult> cached = lookups.execute();
+
+        for (size_t i = 0; i < remoteIds.size(); ++i)
+        {
+            Student student;
+            if (cached[i].ok && !cached[i].nil && studentFromCacheString(remoteIds[i], cached[i].value, student))
+            {
+                // 命中负缓存的id不再查询数据库
+                if (student.getName() != "" || student.getAge() > 0 || student.getClassName() != "")
+                {
+                    localCache.insert(remoteIds[i], student, studentVersion(remoteIds[i]), remoteVersions[i]);
+                    students.add(remoteIds[i], student);
+                }
+                continue;
+            }
+            missingIds.push_back(remoteIds[i]);
+            missingVersions.emplace(remoteIds[i], remoteVersions[i]);
+        }
     }
-}
 
-void DatabaseManager::clearStudentsCache()
-{
-    // 清除所有学生列表缓存
-    // redisManager.del("students:all");
-    redisManager.del("students:count");
+    if (missingIds.empty())
+    {
+        Logger::info("批量获取学生全部命中缓存，数量: {}", students.size());
+        return students;
+    }
+
+    if (!database)
+    {
+        Logger::error("数据库实例未初始化");
+        return students;
+    }
+
+    // 未命中的部分一次批量查询数据库，数据库中也不存在的id写入负缓存；期间有写入的id不回填
+    StudentBatch loaded;
+    {
+        // 结果会写入共享缓存，固定读取主库
+        PrimaryReadScope primaryRead;
+        loaded = database->getStudents(missingIds);
+    }
+    int expireSeconds = configManager ? configManager->getStudentCacheExpire() : 300;
+    RedisManager::Pipeline fills = redisManager.pipeline();
+    std::unordered_set<int> found;
+    for (size_t i = 0; i < loaded.size(); ++i)
+    {
+        int id = loaded.id(i);
+        found.insert(id);
+        uint64_t sequence = missingVersions[id];
+        if (studentVersion(id).load() != sequence)
+            continue;
+
+        Student student = loaded.student(i);
+        fills.set("student:" + std::to_string(id), studentToCacheString(student), expireSeconds);
+        admitLocal(id, student, sequence);
+    }
+    if (negativeExpireSeconds > 0)
+    {
+        std::string expire = std::to_string(negativeExpireSeconds);
+        for (int id : missingIds)
+        {
+            if (found.count(id) == 0 && studentVersion(id).load() == missingVersions[id])
+            {
+                fills.command({"SET", "student:" + std::to_string(id), studentCacheMissingValue(), "EX", expire, "NX"});
+            }
+        }
+    }
+    fills.execute();
+    students.append(loaded);
+
+    Logger::info("批量获取学生，请求: {}，缓存未命中: {}", ids.size(), missingIds.size());
+    return students;
 }
 
-void DatabaseManager::clearStudentCache(int id)
+std::vector<int> DatabaseManager::addStudents(const std::vector<Student> &students)
 {
-    std::string cacheKey = "student:" + std::to_string(id);
-    redisManager.del(cacheKey);
+    if (!database)
+    {
+        Logger::error("数据库实例未初始化");
+        return std::vector<int>(students.size(), -1);
+    }
+
+    markSnapshotDirty(0, true);
+    std::vector<int> ids = database->addStudents(students);
+
+    // 回填缓存与清除计数缓存在一次往返中完成
+    int expireSeconds = configManager ? configManager->getStudentCacheExpire() : 300;
+    RedisManager::Pipeline updates = redisManager.pipeline();
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        if (ids[i] > 0)
+        {
+            noteStudentAdded(ids[i]);
+            markSnapshotDirty(ids[i], true);
+            forgetStudent(ids[i]);
+            updates.set("student:" + std::to_string(ids[i]), studentToCacheString(students[i]), expireSeconds);
+        }
+    }
+    updates.del("students:count");
+    updates.execute();
+    bumpStudentListGeneration();
+
+    return ids;
 }
 
-void DatabaseManager::updateStudentCache(int id, const Student &student)
+int DatabaseManager::deleteStudents(const std::vector<int> &ids)
 {
-    std::string cacheKey = "student:" + std::to_string(id);
-    std::string cacheValue = studentToCacheString(student);
-    // 使用配置管理器获取过期时间，如果没有配置管理器则使用默认值
-    int expireSeconds = 300; // 默认5分钟
-    if (configManager)
+    if (!database)
     {
-        expireSeconds = configManager->getStudentCacheExpire();
-    }
+        Logger::error("数据库实例未初始化");
+        return -1;
+    }
+
+    for (int id : ids)
+    {
+        markSnapshotDirty(id, true);
+    }
+    int deleted = database->deleteStudents(ids);
+    if (deleted > 0)
+    {
+        // 只知道删除的数量：全部存在（且无重复）时才能安全地从过滤器删除，否则保留为误判
+        if (static_cast<size_t>(deleted) == ids.size())
+        {
+            for (int id : ids)
+            {
+                noteStudentDeleted(id);
+            }
+        }
+
+        RedisManager::Pipeline invalidations = redisManager.pipeline();
+        for (int id : ids)
+        {
+            forgetStudent(id);
+            invalidations.del("student:" + std::to_string(id));
+        }
+        invalidations.del("students:count");
+        invalidations.execute();
+        bumpStudentListGeneration();
+    }
+
+    return deleted;
+}
+
+long long DatabaseManager::importStudents(const StudentSource &source)
+{
+    if (!database)
+    {
+        Logger::error("数据库实例未初始化");
+        return -1;
+    }
+
+    markSnapshotStale();
+    long long imported = database->importStudents(source);
+    // 失败的导入也可能已写入部分记录（或删除补偿未完成），只要不是确定无写入就整体失效
+    if (imported != 0)
+    {
+        forgetAllStudents();
+        clearStudentsCache();
+        // 导入的id未知，重新从后端构建过滤器；导入的id在负缓存过期前仍可能返回不存在
+        rebuildExistenceFilter();
+    }
+    return imported;
+}
+
+long long DatabaseManager::exportStudents(const StudentSink &sink)
+{
+    if (!database)
+    {
+        Logger::error("数据库实例未初始化");
+        return -1;
+    }
+
+    return database->exportStudents(sink);
+}
+
+long long DatabaseManager::scanStudents(const StudentVisitor &visitor, const std::string &clientId, bool forCache)
+{
+    // 结果会写入共享缓存时固定读取主库，滞后副本的旧列表不能以新代数缓存
+    bool readPrimary = forCache || shouldReadPrimary(clientId);
+    if (!readPrimary && snapshotClean())
+    {
+        return snapshot.forEach(visitor);
+    }
+
+    if (!database)
+    {
+        Logger::error("数据库实例未初始化");
+        return -1;
+    }
+
+    auto sink = [&visitor](int id, const Student &student)
+    {
+        return visitor(StudentView{id, student.getAge(), student.getName(), student.getClassName(), student.getClassId()});
+    };
+
+    if (readPrimary)
+    {
+        PrimaryReadScope primaryRead;
+        return database->exportStudents(sink);
+    }
+    return database->exportStudents(sink);
+}
+
+void DatabaseManager::postCacheWork(std::function<void()> work)
+{
+    auto shared = std::make_shared<std::function<void()>>(std::move(work));
+    OperationOptions options;
+    options.timeout = std::chrono::milliseconds(-1);
+    ioExecutor->submit<bool>([shared](std::function<void(bool)> done)
+                             {
+        (*shared)();
+        done(true); },
+                             options, [shared](AsyncResult<bool> result)
+                             {
+        // 执行器已满或已停止时就地执行，失效不能丢
+        if (result.status == AsyncStatus::Rejected)
+        {
+            (*shared)();
+        } });
+}
+
+void DatabaseManager::getStudentAsync(int id, std::function<void(AsyncResult<Student>)> callback, const OperationOptions &options, const std::string &clientId)
+{
+    ioExecutor->submit<Student>([this, id, clientId](std::function<void(Student)> done)
+                                {
+        // 缓存命中直接完成
+        Student cachedStudent;
+        if (localCache.find(id, cachedStudent) || !mayExist(id))
+        {
+            done(cachedStudent);
+            return;
+        }
+
+        uint64_t sequence = studentVersion(id).load();
+        std::optional<Student> cached = readStudentCache(id);
+        if (cached)
+        {
+            if (cached->getName() != "" || cached->getAge() > 0 || cached->getClassName() != "")
+            {
+                localCache.insert(id, *cached, studentVersion(id), sequence);
+            }
+            done(*cached);
+            return;
+        }
+
+        bool readPrimary = shouldReadPrimary(clientId);
+        Student snapshotStudent;
+        if (!readPrimary && readFromSnapshot(id, snapshotStudent))
+        {
+            admitLocal(id, snapshotStudent, sequence);
+            done(snapshotStudent);
+            return;
+        }
+
+        if (!database)
+        {
+            Logger::error("数据库实例未初始化");
+            done(Student());
+            return;
+        }
+
+        // 回调可能位于数据库事件循环线程，回填缓存交给I/O执行器，结果立即交付
+        auto loaded = [this, id, sequence, done](Student student)
+        {
+            postCacheWork([this, id, sequence, student]()
+                          {
+                if (student.getName() != "" || student.getAge() > 0 || student.getClassName() != "") {
+                    fillStudentCache(id, student, sequence);
+                } else {
+                    cacheStudentMissing(id, sequence);
+                } });
+            done(student);
+        };
+        // 结果会写入共享缓存，固定读取主库
+        PrimaryReadScope primaryRead;
+        database->getStudentAsync(id, std::move(loaded)); },
+                                options, std::move(callback));
+}
+
+void DatabaseManager::addStudentAsync(const Student &student, std::function<void(AsyncResult<int>)> callback, const OperationOptions &options, const std::string &clientId)
+{
+    ioExecutor->submit<int>([this, student, clientId](std::function<void(int)> done)
+                            {
+        if (!database)
+        {
+            Logger::error("数据库实例未初始化");
+            done(-1);
+            return;
+        }
+
+        markSnapshotDirty(0, true);
+        database->addStudentAsync(student, [this, student, clientId, done](int studentId)
+                                  {
+            if (studentId <= 0) {
+                done(studentId);
+                return;
+            }
+
+            noteStudentAdded(studentId);
+            markSnapshotDirty(studentId, true);
+            recordWrite(clientId);
+            // 缓存失效完成后再交付结果，调用方随后的读取不会命中旧值
+            postCacheWork([this, student, studentId, done]()
+                          {
+                updateStudentCache(studentId, student);
+                clearStudentsCache();
+                done(studentId); }); }); },
+                            options, std::move(callback));
+}
+
+void DatabaseManager::updateStudentAsync(int id, const Student &student, std::function<void(AsyncResult<bool>)> callback, const OperationOptions &options, const std::string &clientId)
+{
+    ioExecutor->submit<bool>([this, id, student, clientId](std::function<void(bool)> done)
+                             {
+        if (!database)
+        {
+            Logger::error("数据库实例未初始化");
+            done(false);
+            return;
+        }
+
+        markSnapshotDirty(id, false);
+        database->updateStudentAsync(id, student, [this, id, student, clientId, done](bool success)
+                                     {
+            if (!success) {
+                done(false);
+                return;
+            }
+
+            recordWrite(clientId);
+            postCacheWork([this, id, student, done]()
+                          {
+                updateStudentCache(id, student);
+                bumpStudentListGeneration();
+                done(true); }); }); },
+                             options, std::move(callback));
+}
+
+void DatabaseManager::deleteStudentAsync(int id, std::function<void(AsyncResult<bool>)> callback, const OperationOptions &options, const std::string &clientId)
+{
+    ioExecutor->submit<bool>([this, id, clientId](std::function<void(bool)> done)
+                             {
+        if (!database)
+        {
+            Logger::error("数据库实例未初始化");
+            done(false);
+            return;
+        }
+
+        markSnapshotDirty(id, true);
+        database->deleteStudentAsync(id, [this, id, clientId, done](bool success)
+                                     {
+            if (!success) {
+                done(false);
+                return;
+            }
+
+            noteStudentDeleted(id);
+            recordWrite(clientId);
+            postCacheWork([this, id, done]()
+                          {
+                clearStudentCache(id);
+                clearStudentsCache();
+                done(true); }); }); },
+                             options, std::move(callback));
+}
+
+void DatabaseManager::getAllStudentsAsync(std::function<void(AsyncResult<StudentBatch>)> callback, const OperationOptions &options, const std::string &clientId)
+{
+    ioExecutor->submit<StudentBatch>([this, clientId](std::function<void(StudentBatch)> done)
+                                     {
+        bool readPrimary = shouldReadPrimary(clientId);
+        if (!readPrimary && snapshotClean())
+        {
+            StudentBatch students;
+            students.reserve(snapshot.size());
+            snapshot.forEach([&students](const StudentView &view)
+                             {
+                students.add(view.id, view.age, view.name, view.className);
+                return true; });
+            done(std::move(students));
+            return;
+        }
+
+        if (!database)
+        {
+            Logger::error("数据库实例未初始化");
+            done({});
+            return;
+        }
+
+        if (readPrimary)
+        {
+            PrimaryReadScope primaryRead;
+            database->getAllStudentsAsync(std::move(done));
+        }
+        else
+        {
+            database->getAllStudentsAsync(std::move(done));
+        } },
+                                     options, std::move(callback));
+}
+
+void DatabaseManager::getStudentCountAsync(std::function<void(AsyncResult<int>)> callback, const OperationOptions &options, const std::string &clientId)
+{
+    ioExecutor->submit<int>([this, clientId](std::function<void(int)> done)
+                            {
+        std::string cachedCount = redisManager.get("students:count");
+        int count;
+        if (!cachedCount.empty() && countFromCacheString(cachedCount, count))
+        {
+            done(count);
+            return;
+        }
+
+        bool readPrimary = shouldReadPrimary(clientId);
+        if (!readPrimary && snapshotClean())
+        {
+            done(static_cast<int>(snapshot.size()));
+            return;
+        }
+
+        if (!database)
+        {
+            Logger::error("数据库实例未初始化");
+            done(-1);
+            return;
+        }
+
+        auto counted = [this, done](int count)
+        {
+            if (count >= 0)
+            {
+                int expireSeconds = configManager ? configManager->getCountCacheExpire() : 30;
+                postCacheWork([this, count, expireSeconds]()
+                              { redisManager.set("students:count", countToCacheString(count), expireSeconds); });
+            }
+            done(count);
+        };
+        PrimaryReadScope primaryRead;
+        database->getStudentCountAsync(std::move(counted)); },
+                            options, std::move(callback));
+}
+
+std::future<AsyncResult<Student>> DatabaseManager::getStudentAsync(int id, const OperationOptions &options, const std::string &clientId)
+{
+    return makeFuture<AsyncResult<Student>>([this, id, options, &clientId](std::function<void(AsyncResult<Student>)> callback)
+                                            { getStudentAsync(id, std::move(callback), options, clientId); });
+}
+
+std::future<AsyncResult<int>> DatabaseManager::addStudentAsync(const Student &student, const OperationOptions &options, const std::string &clientId)
+{
+    return makeFuture<AsyncResult<int>>([this, &student, options, &clientId](std::function<void(AsyncResult<int>)> callback)
+                                        { addStudentAsync(student, std::move(callback), options, clientId); });
+}
+
+std::future<AsyncResult<bool>> DatabaseManager::updateStudentAsync(int id, const Student &student, const OperationOptions &options, const std::string &clientId)
+{
+    return makeFuture<AsyncResult<bool>>([this, id, &student, options, &clientId](std::function<void(AsyncResult<bool>)> callback)
+                                         { updateStudentAsync(id, student, std::move(callback), options, clientId); });
+}
+
+std::future<AsyncResult<bool>> DatabaseManager::deleteStudentAsync(int id, const OperationOptions &options, const std::string &clientId)
+{
+    return makeFuture<AsyncResult<bool>>([this, id, options, &clientId](std::function<void(AsyncResult<bool>)> callback)
+                                         { deleteStudentAsync(id, std::move(callback), options, clientId); });
+}
+
+std::future<AsyncResult<StudentBatch>> DatabaseManager::getAllStudentsAsync(const OperationOptions &options, const std::string &clientId)
+{
+    using Result = AsyncResult<StudentBatch>;
+    return makeFuture<Result>([this, options, &clientId](std::function<void(Result)> callback)
+                              { getAllStudentsAsync(std::move(callback), options, clientId); });
+}
+
+std::future<AsyncResult<int>> DatabaseManager::getStudentCountAsync(const OperationOptions &options, const std::string &clientId)
+{
+    return makeFuture<AsyncResult<int>>([this, options, &clientId](std::function<void(AsyncResult<int>)> callback)
+                                        { getStudentCountAsync(std::move(callback), options, clientId); });
+}
+
+template <typename T>
+CallbackAwaitable<T> DatabaseManager::awaitIo(std::function<void(std::function<void(T)>)> work, T fallback, OperationOptions options)
+{
+    if (inSyncWait())
+    {
+        // 调用线程本身在syncWait中阻塞（如httplib工作线程），直接在本线程执行并等待完成，
+        // 协程在本线程继续，每个请求只占用一个线程
+        return CallbackAwaitable<T>([work = std::move(work)](std::function<void(T)> resume)
+                                    {
+            auto promise = std::make_shared<std::promise<T>>();
+            std::future<T> future = promise->get_future();
+            work([promise](T value)
+                 { promise->set_value(std::move(value)); });
+            resume(future.get()); },
+                                    nullptr);
+    }
+
+    return CallbackAwaitable<T>([this, work = std::move(work), fallback = std::move(fallback), options](std::function<void(T)> resume)
+                                { ioExecutor->submit<T>(work, options, [resume, fallback](AsyncResult<T> result)
+                                                        { resume(result.ok() ? std::move(result.value) : fallback); }); },
+                                coroutineScheduler.get());
+}
+
+OperationOptions DatabaseManager::noDeadline()
+{
+    OperationOptions options;
+    options.timeout = std::chrono::milliseconds(-1);
+    return options;
+}
+
+CallbackAwaitable<std::string> DatabaseManager::redisGet(std::string key)
+{
+    // hiredis为阻塞客户端，在I/O执行器上调用以免阻塞协程调度线程
+    return awaitIo<std::string>([this, key = std::move(key)](std::function<void(std::string)> done)
+                                { done(redisManager.get(key)); },
+                                std::string());
+}
+
+CallbackAwaitable<std::optional<Student>> DatabaseManager::redisGetStudent(int id)
+{
+    // 回复在I/O线程上直接解析为Student，回复文本不跨线程复制
+    return awaitIo<std::optional<Student>>([this, id](std::function<void(std::optional<Student>)> done)
+                                           { done(readStudentCache(id)); },
+                                           std::nullopt);
+}
+
+CallbackAwaitable<bool> DatabaseManager::redisCacheMissing(int id, uint64_t sequence)
+{
+    return awaitIo<bool>([this, id, sequence](std::function<void(bool)> done)
+                         {
+        cacheStudentMissing(id, sequence);
+        done(true); },
+                         false);
+}
+
+CallbackAwaitable<StudentListCache> DatabaseManager::redisGetStudentList()
+{
+    return awaitIo<StudentListCache>([this](std::function<void(StudentListCache)> done)
+                                     { done(readStudentListCache()); },
+                                     StudentListCache());
+}
+
+CallbackAwaitable<bool> DatabaseManager::redisBumpListGeneration()
+{
+    return awaitIo<bool>([this](std::function<void(bool)> done)
+                         {
+        bumpStudentListGeneration();
+        done(true); },
+                         false, noDeadline());
+}
+
+CallbackAwaitable<bool> DatabaseManager::redisSet(std::string key, std::string value, int expireSeconds)
+{
+    // 缓存写入与失效不设截止时间，超时放弃会留下旧值
+    return awaitIo<bool>([this, key = std::move(key), value = std::move(value), expireSeconds](std::function<void(bool)> done)
+                         { done(redisManager.set(key, value, expireSeconds)); },
+                         false, noDeadline());
+}
+
+CallbackAwaitable<bool> DatabaseManager::redisDel(std::string key)
+{
+    return awaitIo<bool>([this, key = std::move(key)](std::function<void(bool)> done)
+                         { done(redisManager.del(key)); },
+                         false, noDeadline());
+}
+
+CallbackAwaitable<int> DatabaseManager::databaseAdd(const Student &student)
+{
+    // 后端的回调式异步接口在I/O执行器上发起，未提供非阻塞实现的后端也不会阻塞协程调度线程。
+    // 写入不设截止时间：超时返回时写入可能仍会提交，不能据此报告失败
+    return awaitIo<int>([this, student](std::function<void(int)> done)
+                        { database->addStudentAsync(student, std::move(done)); },
+                        -1, noDeadline());
+}
+
+CallbackAwaitable<bool> DatabaseManager::databaseUpdate(int id, const Student &student)
+{
+    return awaitIo<bool>([this, id, student](std::function<void(bool)> done)
+                         { database->updateStudentAsync(id, student, std::move(done)); },
+                         false, noDeadline());
+}
+
+CallbackAwaitable<bool> DatabaseManager::databaseDelete(int id)
+{
+    return awaitIo<bool>([this, id](std::function<void(bool)> done)
+                         { database->deleteStudentAsync(id, std::move(done)); },
+                         false, noDeadline());
+}
+
+CallbackAwaitable<Student> DatabaseManager::databaseGet(int id)
+{
+    return awaitIo<Student>([this, id](std::function<void(Student)> done)
+                            {
+        PrimaryReadScope primaryRead;
+        database->getStudentAsync(id, std::move(done)); },
+                            Student());
+}
+
+CallbackAwaitable<int> DatabaseManager::databaseCount()
+{
+    return awaitIo<int>([this](std::function<void(int)> done)
+                        {
+        PrimaryReadScope primaryRead;
+        database->getStudentCountAsync(std::move(done)); },
+                        -1);
+}
+
+CallbackAwaitable<long long> DatabaseManager::databaseScan(const StudentVisitor &visitor, const std::string &clientId, bool forCache)
+{
+    // 全表扫描为流式同步调用，整体放在I/O执行器上执行
+    return awaitIo<long long>([this, visitor, clientId, forCache](std::function<void(long long)> done)
+                              { done(scanStudents(visitor, clientId, forCache)); },
+                              -1);
+}
+
+Task<int> DatabaseManager::addStudentTask(Student student, std::string clientId)
+{
+    if (!database)
+    {
+        Logger::error("数据库实例未初始化");
+        co_return -1;
+    }
+
+    markSnapshotDirty(0, true);
+    int studentId = co_await databaseAdd(student);
+    if (studentId > 0)
+    {
+        noteStudentAdded(studentId);
+        recordWrite(clientId);
+        markSnapshotDirty(studentId, true);
+        forgetStudent(studentId);
+        int expireSeconds = configManager ? configManager->getStudentCacheExpire() : 300;
+        co_await redisSet("student:" + std::to_string(studentId), studentToCacheString(student), expireSeconds);
+        co_await redisDel("students:count");
+        co_await redisBumpListGeneration();
+        Logger::info("添加学生成功，ID: {}，已更新缓存", studentId);
+    }
+
+    co_return studentId;
+}
+
+Task<bool> DatabaseManager::updateStudentTask(int id, Student student, std::string clientId)
+{
+    if (!database)
+    {
+        Logger::error("数据库实例未初始化");
+        co_return false;
+    }
+
+    markSnapshotDirty(id, false);
+    bool success = co_await databaseUpdate(id, student);
+    if (success)
+    {
+        recordWrite(clientId);
+        forgetStudent(id);
+        int expireSeconds = configManager ? configManager->getStudentCacheExpire() : 300;
+        co_await redisSet("student:" + std::to_string(id), studentToCacheString(student), expireSeconds);
+        co_await redisBumpListGeneration();
+        Logger::info("更新学生成功，ID: {}，已更新缓存", id);
+    }
+
+    co_return success;
+}
+
+Task<bool> DatabaseManager::deleteStudentTask(int id, std::string clientId)
+{
+    if (!database)
+    {
+        Logger::error("数据库实例未初始化");
+        co_return false;
+    }
+
+    markSnapshotDirty(id, true);
+    bool success = co_await databaseDelete(id);
+    if (success)
+    {
+        noteStudentDeleted(id);
+        recordWrite(clientId);
+        forgetStudent(id);
+        co_await redisDel("student:" + std::to_string(id));
+        co_await redisDel("students:count");
+        co_await redisBumpListGeneration();
+        Logger::info("删除学生成功，ID: {}，已清除缓存", id);
+    }
+
+    co_return success;
+}
+
+Task<Student> DatabaseManager::getStudentTask(int id, std::string clientId)
+{
+    // 读取前的版本：读取期间该id有写入或失效时，读到的值可能已过时，不回填缓存
+    uint64_t sequence = studentVersion(id).load();
+
+    {
+        // 进程内缓存命中时不挂起
+        Student student;
+        if (localCache.find(id, student) || !mayExist(id))
+        {
+            co_return student;
+        }
+
+        std::optional<Student> cached = co_await redisGetStudent(id);
+        if (cached)
+        {
+            if (cached->getName() != "" || cached->getAge() > 0 || cached->getClassName() != "")
+            {
+                localCache.insert(id, *cached, studentVersion(id), sequence);
+                Logger::info("从缓存获取学生，ID: {}", id);
+            }
+            co_return *cached;
+        }
+    }
+
+    std::string cacheKey = "student:" + std::to_string(id);
+
+    bool readPrimary = shouldReadPrimary(clientId);
+    int expireSeconds = configManager ? configManager->getStudentCacheExpire() : 300;
+
+    Student student;
+    if (!readPrimary && readFromSnapshot(id, student))
+    {
+        admitLocal(id, student, sequence);
+        Logger::info("从启动快照获取学生，ID: {}", id);
+        co_return student;
+    }
+
+    if (!database)
+    {
+        Logger::error("数据库实例未初始化");
+        co_return Student();
+    }
+
+    student = co_await databaseGet(id);
+    if (student.getName() != "" || student.getAge() > 0 || student.getClassName() != "")
+    {
+        if (studentVersion(id).load() == sequence)
+        {
+            co_await redisSet(cacheKey, studentToCacheString(student), expireSeconds);
+            admitLocal(id, student, sequence);
+        }
+        Logger::info("从数据库获取学生，ID: {}，已写入缓存", id);
+    }
+    else
+    {
+        co_await redisCacheMissing(id, sequence);
+    }
+
+    co_return student;
+}
+
+Task<int> DatabaseManager::getStudentCountTask(std::string clientId)
+{
+    std::string cachedCount = co_await redisGet("students:count");
+    int count;
+    if (!cachedCount.empty() && countFromCacheString(cachedCount, count))
+    {
+        co_return count;
+    }
+
+    if (!database)
+    {
+        Logger::error("数据库实例未初始化");
+        co_return -1;
+    }
+
+    bool readPrimary = shouldReadPrimary(clientId);
+    if (!readPrimary && snapshotClean())
+    {
+        // 快照计数不写入共享缓存
+        co_return static_cast<int>(snapshot.size());
+    }
+
+    count = co_await databaseCount();
+
+    if (count >= 0)
+    {
+        int expireSeconds = configManager ? configManager->getCountCacheExpire() : 30;
+        co_await redisSet("students:count", countToCacheString(count), expireSeconds);
+    }
+
+    co_return count;
+}
+
+Task<long long> DatabaseManager::scanStudentsTask(StudentVisitor visitor, std::string clientId, bool forCache)
+{
+    co_return co_await databaseScan(visitor, clientId, forCache);
+}
+
+Task<StudentListCache> DatabaseManager::getStudentListCacheTask(std::string clientId)
+{
+    // 读己之写窗口内的客户端直接读取后端，也不写回
+    if (listCacheExpire <= 0 || shouldReadPrimary(clientId))
+    {
+        co_return StudentListCache();
+    }
+
+    StudentListCache cached = co_await redisGetStudentList();
+    // 本次列表会从快照生成时不回写，快照内容不能发布到共享缓存
+    if (!cached.hit && snapshotClean())
+    {
+        cached.generation = -1;
+    }
+    co_return cached;
+}
+
+void DatabaseManager::storeStudentListCache(long long generation, std::shared_ptr<const std::string> body)
+{
+    if (generation < 0 || listCacheExpire <= 0)
+        return;
+
+    ioExecutor->submit<bool>([this, generation, body = std::move(body)](std::function<void(bool)> done)
+                             { done(redisManager.set("students:all:" + std::to_string(generation), *body, listCacheExpire)); },
+                             OperationOptions(),
+                             [](AsyncResult<bool>) {});
+}
+
+// 缓存相关方法实现
+CacheStamp DatabaseManager::makeCacheStamp(int expireSeconds) const
+{
+    // 软过期为硬过期（Redis TTL）的一部分，比例不在(0,1)内时不做提前刷新
+    CacheStamp stamp;
+    if (softTtlRatio > 0 && softTtlRatio < 1 && expireSeconds > 0)
+    {
+        stamp.softExpiresAt = unixMillis() + static_cast<long long>(expireSeconds * 1000 * softTtlRatio);
+        stamp.loadMillis = loadMillis.load(std::memory_order_relaxed);
+    }
+    return stamp;
+}
+
+void DatabaseManager::recordLoadTime(std::chrono::steady_clock::duration elapsed)
+{
+    // 加载耗时的指数滑动平均，作为XFetch的重算代价
+    int sample = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+    int previous = loadMillis.load(std::memory_order_relaxed);
+    loadMillis.store(previous == 0 ? sample : (previous * 7 + sample) / 8, std::memory_order_relaxed);
+}
+
+std::string DatabaseManager::studentToCacheString(const Student &student) const
+{
+    std::string out;
+    out.reserve(24 + student.getName().size() + student.getClassName().size());
+    encodeStudentCache(out, student.getName(), student.getAge(), student.getClassId(),
+                       makeCacheStamp(configManager ? configManager->getStudentCacheExpire() : 300));
+    return out;
+}
+
+bool DatabaseManager::studentFromCacheString(int id, std::string_view cacheStr, Student &student)
+{
+    if (isStudentCacheMissing(cacheStr))
+    {
+        ++negativeHitCount;
+        student = Student();
+        return true;
+    }
+
+    CacheStamp stamp;
+    std::string error;
+    if (!decodeStudentCache(cacheStr, student, &stamp, &error))
+    {
+        Logger::error("缓存中学生数据解析失败: {}", error);
+        student = Student();
+        return false;
+    }
+
+    if (refreshDue(stamp, xfetchBeta))
+    {
+        scheduleStudentRefresh(id, cacheStr);
+    }
+    return true;
+}
+
+std::string DatabaseManager::countToCacheString(int count) const
+{
+    // "数量 软过期时刻 加载耗时"，只读取开头整数的旧版本读取方仍然兼容
+    CacheStamp stamp = makeCacheStamp(configManager ? configManager->getCountCacheExpire() : 30);
+    std::string out = std::to_string(count);
+    if (stamp.softExpiresAt > 0)
+    {
+        out += ' ';
+        out += std::to_string(stamp.softExpiresAt);
+        out += ' ';
+        out += std::to_string(stamp.loadMillis);
+    }
+    return out;
+}
+
+bool DatabaseManager::countFromCacheString(std::string_view cacheStr, int &count)
+{
+    const char *cursor = cacheStr.data();
+    const char *end = cacheStr.data() + cacheStr.size();
+    auto result = std::from_chars(cursor, end, count);
+    if (result.ec != std::errc())
+    {
+        Logger::error("缓存中学生数量解析失败: {}", cacheStr);
+        return false;
+    }
+
+    CacheStamp stamp;
+    cursor = result.ptr;
+    if (cursor != end && *cursor == ' ')
+    {
+        result = std::from_chars(cursor + 1, end, stamp.softExpiresAt);
+        if (result.ptr != end && *result.ptr == ' ')
+            std::from_chars(result.ptr + 1, end, stamp.loadMillis);
+    }
+
+    if (refreshDue(stamp, xfetchBeta))
+    {
+        scheduleCountRefresh(cacheStr);
+    }
+    return true;
+}
+
+std::atomic<uint64_t> &DatabaseManager::studentVersion(int id)
+{
+    // 乘法哈希取高位，相邻id分散到不同条目
+    return studentVersions[(static_cast<uint32_t>(id) * 0x9e3779b1u) >> 22];
+}
+
+void DatabaseManager::forgetStudent(int id)
+{
+    ++studentVersion(id);
+    localCache.erase(id);
+}
+
+void DatabaseManager::forgetAllStudents()
+{
+    for (std::atomic<uint64_t> &version : studentVersions)
+    {
+        ++version;
+    }
+    localCache.clear();
+}
+
+bool DatabaseManager::mayExist(int id)
+{
+    std::shared_lock<std::shared_mutex> lock(existenceFilterMutex);
+    if (!existenceFilter || existenceFilter->contains(static_cast<uint64_t>(id)))
+        return true;
+
+    ++filterRejectCount;
+    return false;
+}
+
+void DatabaseManager::noteStudentAdded(int id)
+{
+    if (!existenceFilterEnabled)
+        return;
+
+    {
+        std::unique_lock<std::shared_mutex> lock(existenceFilterMutex);
+        if (existenceFilterRebuilding)
+        {
+            existenceFilterPending.push_back(id);
+            return;
+        }
+        if (existenceFilter && existenceFilter->insert(static_cast<uint64_t>(id)))
+            return;
+
+        // 表已满或上次构建失败：放行所有请求，在后台重新构建
+        if (existenceFilter)
+            Logger::warn("存在性过滤器已满，条目数: {}，后台重建", existenceFilter->size());
+        existenceFilter.reset();
+        existenceFilterRebuilding = true;
+        existenceFilterPending.clear();
+    }
+    scheduleExistenceFilterBuild();
+}
+
+void DatabaseManager::noteStudentDeleted(int id)
+{
+    if (!existenceFilterEnabled)
+        return;
+
+    std::unique_lock<std::shared_mutex> lock(existenceFilterMutex);
+    if (existenceFilterRebuilding)
+    {
+        // 构建中的扫描可能已读到该id，留下的误判由负缓存兜底
+        std::erase(existenceFilterPending, id);
+        return;
+    }
+    if (existenceFilter)
+        existenceFilter->erase(static_cast<uint64_t>(id));
+}
+
+void DatabaseManager::rebuildExistenceFilter()
+{
+    if (!existenceFilterEnabled)
+        return;
+
+    {
+        std::unique_lock<std::shared_mutex> lock(existenceFilterMutex);
+        existenceFilter.reset();
+        ++existenceFilterGeneration;
+        if (existenceFilterRebuilding)
+            return;
+        existenceFilterRebuilding = true;
+        existenceFilterPending.clear();
+    }
+    scheduleExistenceFilterBuild();
+}
+
+void DatabaseManager::scheduleExistenceFilterBuild()
+{
+    // 操作在开始前超时或被拒绝时由回调结束重建状态，二者只有一方生效
+    auto started = std::make_shared<std::atomic<bool>>(false);
+    ioExecutor->submit<bool>([this, started](std::function<void(bool)> done)
+                             {
+        if (!started->exchange(true))
+            buildExistenceFilter();
+        done(true); },
+                             OperationOptions(),
+                             [this, started](AsyncResult<bool>)
+                             {
+                                 if (started->exchange(true))
+                                     return;
+                                 std::unique_lock<std::shared_mutex> lock(existenceFilterMutex);
+                                 existenceFilterRebuilding = false;
+                                 existenceFilterPending.clear();
+                             });
+}
+
+void DatabaseManager::buildExistenceFilter()
+{
+    // 调用方已置existenceFilterRebuilding：期间的新增记入pending，删除不处理（只会留下误判）
+    auto start = std::chrono::steady_clock::now();
+    int count = database ? database->getStudentCount() : -1;
+    size_t capacity = std::max<size_t>(count > 0 ? static_cast<size_t>(count) * 3 / 2 : 0, 1024);
+
+    while (count >= 0)
+    {
+        uint64_t generation;
+        {
+            std::shared_lock<std::shared_mutex> lock(existenceFilterMutex);
+            generation = existenceFilterGeneration;
+        }
+
+        auto filter = std::make_unique<CuckooFilter>(capacity);
+        bool full = false;
+        // 过滤器不能漏掉已存在的id，扫描固定走主库，避免副本延迟
+        PrimaryReadScope primaryRead;
+        long long scanned = database->exportStudents([&filter, &full](int id, const Student &)
+                                                     {
+            full = !filter->insert(static_cast<uint64_t>(id));
+            return !full; });
+        if (scanned < 0)
+            break;
+
+        std::unique_lock<std::shared_mutex> lock(existenceFilterMutex);
+        if (generation != existenceFilterGeneration)
+        {
+            // 扫描期间又请求了重建（例如通知丢失），本次结果可能缺少记录
+            Logger::info("存在性过滤器构建期间收到重建请求，重新扫描");
+            continue;
+        }
+        for (size_t i = 0; i < existenceFilterPending.size() && !full; ++i)
+        {
+            full = !filter->insert(static_cast<uint64_t>(existenceFilterPending[i]));
+        }
+        if (full)
+        {
+            // 容量不足时加倍重新扫描，pending保留到下一轮
+            capacity *= 2;
+            continue;
+        }
+
+        existenceFilter = std::move(filter);
+        existenceFilterRebuilding = false;
+        existenceFilterPending.clear();
+        Logger::info("存在性过滤器构建完成，条目数: {}，内存: {} KB，耗时: {} ms", existenceFilter->size(),
+                     existenceFilter->memoryBytes() / 1024,
+                     std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+        return;
+    }
+
+    // 扫描失败：过滤器保持为空（放行所有请求），下一次新增时重试
+    Logger::error("存在性过滤器构建失败，暂不使用过滤器");
+    std::unique_lock<std::shared_mutex> lock(existenceFilterMutex);
+    existenceFilterRebuilding = false;
+    existenceFilterPending.clear();
+}
+
+void DatabaseManager::warmUpCache()
+{
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + warmupBudget;
+
+    std::vector<int> ids = loadHotIds();
+    if (!ids.empty())
+    {
+        warmupSource = "hot_ids";
+    }
+    else
+    {
+        warmupSource = "recent";
+        ids = recentIds(deadline);
+    }
+
+    for (size_t offset = 0; offset < ids.size(); offset += warmupBatchSize)
+    {
+        if (warmupStopping.load() || std::chrono::steady_clock::now() >= deadline)
+            break;
+        size_t end = std::min(ids.size(), offset + warmupBatchSize);
+        warmUpBatch(std::vector<int>(ids.begin() + offset, ids.begin() + end));
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    warmupMillis = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    ready = true;
+    if (std::chrono::steady_clock::now() >= deadline)
+    {
+        Logger::warn("缓存预热超出时间预算 {} ms，已加载: {}，按就绪处理", warmupBudget.count(), warmupLoaded.load());
+    }
+    else
+    {
+        Logger::info("缓存预热完成，来源: {}，已加载: {}，跳过: {}，耗时: {} ms", warmupSource.load(), warmupLoaded.load(),
+                     warmupSkipped.load(), warmupMillis.load());
+    }
+}
+
+std::vector<int> DatabaseManager::loadHotIds() const
+{
+    std::vector<int> ids;
+    if (warmupHotIdsPath.empty())
+        return ids;
+
+    std::ifstream file(warmupHotIdsPath);
+    int id;
+    while (ids.size() < warmupCount && file >> id)
+    {
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+std::vector<int> DatabaseManager::recentIds(std::chrono::steady_clock::time_point deadline)
+{
+    // 流式扫描，用小顶堆保留id最大的warmupCount个；超出预算时使用已扫描部分的结果
+    std::vector<int> heap;
+    heap.reserve(warmupCount);
+    database->exportStudents([this, &heap, deadline](int id, const Student &)
+                             {
+        if (heap.size() < warmupCount)
+        {
+            heap.push_back(id);
+            std::push_heap(heap.begin(), heap.end(), std::greater<int>());
+        }
+        else if (id > heap.front())
+        {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<int>());
+            heap.back() = id;
+            std::push_heap(heap.begin(), heap.end(), std::greater<int>());
+        }
+        return !warmupStopping.load() && std::chrono::steady_clock::now() < deadline; });
+
+    // 最近的记录先加载
+    std::sort(heap.begin(), heap.end(), std::greater<int>());
+    return heap;
+}
+
+void DatabaseManager::warmUpBatch(const std::vector<int> &ids)
+{
+    // 读取前记录每个id的版本，读取期间有写入的id单独跳过，不影响同批其他id
+    std::unordered_map<int, uint64_t> versions;
+    versions.reserve(ids.size());
+    for (int id : ids)
+    {
+        versions.emplace(id, studentVersion(id).load());
+    }
+    StudentBatch loaded;
+    {
+        PrimaryReadScope primaryRead;
+        loaded = database->getStudents(ids);
+    }
+
+    // NX：Redis中已有的值（旧实例写入或启动后的写路径写入）保持不变
+    std::string expire = std::to_string(configManager ? configManager->getStudentCacheExpire() : 300);
+    RedisManager::Pipeline fills = redisManager.pipeline();
+    size_t filled = 0;
+    for (size_t i = 0; i < loaded.size(); ++i)
+    {
+        int id = loaded.id(i);
+        uint64_t sequence = versions[id];
+        if (studentVersion(id).load() != sequence)
+            continue;
+
+        Student student = loaded.student(i);
+        fills.command({"SET", "student:" + std::to_string(id), studentToCacheString(student), "EX", expire, "NX"});
+        admitLocal(id, student, sequence);
+        ++filled;
+    }
+    fills.execute();
+    warmupLoaded += filled;
+    warmupSkipped += ids.size() - filled;
+}
+
+void DatabaseManager::saveHotIds() const
+{
+    // 记录一级缓存中的热点id供下次启动预热；缓存为空（如未成功打开）时保留原有列表
+    if (warmupHotIdsPath.empty() || warmupCount == 0)
+        return;
+
+    std::vector<int> ids = localCache.hotIds(warmupCount);
+    if (ids.empty())
+        return;
+
+    std::string tempPath = warmupHotIdsPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        for (int id : ids)
+        {
+            file << id << '\n';
+        }
+        if (!file)
+        {
+            Logger::error("热点id列表写入失败: {}", tempPath);
+            return;
+        }
+    }
+    if (std::rename(tempPath.c_str(), warmupHotIdsPath.c_str()) != 0)
+    {
+        Logger::error("热点id列表重命名失败: {}", warmupHotIdsPath);
+        return;
+    }
+    Logger::info("已记录热点id列表，数量: {}", ids.size());
+}
+
+void DatabaseManager::bumpStudentListGeneration()
+{
+    if (listCacheExpire <= 0)
+        return;
+
+    long long generation;
+    if (!redisManager.incrBy("students:generation", 1, generation))
+    {
+        // 代数未能递增，其他实例仍可能读到旧列表；本实例至少在旧条目过期前不再使用
+        listCacheBypassUntil = unixMillis() + static_cast<long long>(listCacheExpire) * 1000;
+        Logger::warn("学生列表缓存代数递增失败，{} 秒内不使用列表缓存", listCacheExpire);
+    }
+}
+
+StudentListCache DatabaseManager::readStudentListCache()
+{
+    StudentListCache result;
+    if (unixMillis() < listCacheBypassUntil.load())
+        return result;
+
+    // 以GET读取代数，键不存在时为0；读路径不发送写命令（不产生AOF与复制流量，只读副本上也可执行）
+    RedisManager::Pipeline pipeline = redisManager.pipeline();
+    pipeline.get("students:generation");
+    std::vector<RedisResult> replies = pipeline.execute();
+    if (replies.empty() || !replies[0].ok)
+        return result;
+
+    long long generation = 0;
+    if (!replies[0].nil)
+    {
+        const std::string &value = replies[0].value;
+        auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), generation);
+        if (error != std::errc() || end != value.data() + value.size())
+            return result;
+    }
+
+    result.generation = generation;
+    std::string key = "students:all:" + std::to_string(generation);
+    result.hit = redisManager.get(key, [&result](std::string_view cached)
+                                  { result.body.assign(cached.data(), cached.size()); });
+    if (result.hit)
+        ++listCacheHits;
+    else
+        ++listCacheMisses;
+    return result;
+}
+
+void DatabaseManager::cacheStudentMissing(int id, uint64_t sequence)
+{
+    // 期间有写入（可能正是新增该id）时不写；NX保证不覆盖其他实例刚写入的学生
+    if (negativeExpireSeconds <= 0 || studentVersion(id).load() != sequence)
+        return;
+
+    char keyBuffer[32];
+    redisManager.setIfAbsent(studentCacheKey(keyBuffer, id), studentCacheMissingValue(), negativeExpireSeconds);
+}
+
+void DatabaseManager::scheduleStudentRefresh(int id, std::string_view observed)
+{
+    {
+        std::lock_guard<std::mutex> lock(refreshMutex);
+        if (!refreshingStudents.insert(id).second)
+            return;
+    }
+
+    // 同一id同时只有一个刷新；回调在完成、超时或被拒绝时都会执行
+    ioExecutor->submit<bool>([this, id, expected = std::string(observed)](std::function<void(bool)> done)
+                             { done(refreshStudent(id, expected)); },
+                             OperationOptions(),
+                             [this, id](AsyncResult<bool>)
+                             {
+                                 std::lock_guard<std::mutex> lock(refreshMutex);
+                                 refreshingStudents.erase(id);
+                             });
+}
+
+void DatabaseManager::scheduleCountRefresh(std::string_view observed)
+{
+    if (refreshingCount.exchange(true))
+        return;
+
+    ioExecutor->submit<bool>([this, expected = std::string(observed)](std::function<void(bool)> done)
+                             { done(refreshCount(expected)); },
+                             OperationOptions(),
+                             [this](AsyncResult<bool>)
+                             { refreshingCount = false; });
+}
+
+bool DatabaseManager::refreshStudent(int id, const std::string &observed)
+{
+    if (!database)
+        return false;
+
+    // 刷新期间本进程对该id有写入或失效时放弃回写；其他实例的写入由比较并写入排除
+    uint64_t sequence = studentVersion(id).load();
+    auto start = std::chrono::steady_clock::now();
+    Student student;
+    {
+        PrimaryReadScope primaryRead;
+        student = database->getStudent(id);
+    }
+    recordLoadTime(std::chrono::steady_clock::now() - start);
+
+    if (student.getName() == "" && student.getAge() <= 0 && student.getClassName() == "")
+        return false;
+    if (studentVersion(id).load() != sequence)
+        return false;
+
+    int expireSeconds = configManager ? configManager->getStudentCacheExpire() : 300;
+    char keyBuffer[32];
+    bool stored = redisManager.compareAndSet(studentCacheKey(keyBuffer, id), observed, studentToCacheString(student), expireSeconds);
+    if (stored)
+    {
+        ++cacheRefreshCount;
+        Logger::debug("后台刷新学生缓存，ID: {}", id);
+    }
+    return stored;
+}
+
+bool DatabaseManager::refreshCount(const std::string &observed)
+{
+    if (!database)
+        return false;
+
+    uint64_t sequence = countVersion.load();
+    auto start = std::chrono::steady_clock::now();
+    int count;
+    {
+        PrimaryReadScope primaryRead;
+        count = database->getStudentCount();
+    }
+    recordLoadTime(std::chrono::steady_clock::now() - start);
+
+    if (count < 0 || countVersion.load() != sequence)
+        return false;
+
+    int expireSeconds = configManager ? configManager->getCountCacheExpire() : 30;
+    bool stored = redisManager.compareAndSet("students:count", observed, countToCacheString(count), expireSeconds);
+    if (stored)
+    {
+        ++cacheRefreshCount;
+    }
+    return stored;
+}
+
+std::optional<Student> DatabaseManager::readStudentCache(int id)
+{
+    // 缓存键在栈上生成，值直接从回复缓冲解码，整个过程不经过全局分配器（长姓名除外）；
+    // 回调只捕获两个指针，std::function不会为其分配内存
+    struct Lookup
+    {
+        int id;
+        bool found;
+        Student student;
+    } lookup{id, false, Student()};
+    char keyBuffer[32];
+    redisManager.get(studentCacheKey(keyBuffer, id), [this, &lookup](std::string_view cached)
+                     { lookup.found = studentFromCacheString(lookup.id, cached, lookup.student); });
+    if (!lookup.found)
+        return std::nullopt;
+    return std::move(lookup.student);
+}
+
+void DatabaseManager::onStudentChanged(const StudentChangeEvent &event)
+{
+    if (event.operation == StudentChangeEvent::Operation::Resync)
+    {
+        onStudentsResync(event);
+        return;
+    }
+
+    // 任何来源的变更都使快照中对应记录失效
+    markSnapshotDirty(event.id, event.operation != StudentChangeEvent::Operation::Update);
+    // 一级缓存与存在性过滤器是本进程私有的，其他实例的写入同样需要维护
+    forgetStudent(event.id);
+    if (event.operation == StudentChangeEvent::Operation::Insert)
+        noteStudentAdded(event.id);
+    else if (event.operation == StudentChangeEvent::Operation::Delete)
+        noteStudentDeleted(event.id);
+
+    // 其他服务实例已在其写路径上更新共享的Redis缓存
+    if (event.fromPeer)
+    {
+        Logger::debug("收到其他实例的学生变更通知，ID: {}，来源: {}", event.id, event.origin);
+        return;
+    }
+
+    // 外部写入方（如直接修改数据库）需要精确失效Redis缓存
+    clearStudentCache(event.id);
+    clearStudentsCache();
+    Logger::info("收到外部学生变更通知，ID: {}，已清除缓存", event.id);
+}
+
+void DatabaseManager::onStudentsResync(const StudentChangeEvent &event)
+{
+    // 无法得知具体变更了哪些记录，本进程私有的状态整体失效
+    markSnapshotStale();
+    forgetAllStudents();
+    rebuildExistenceFilter();
+
+    if (event.fromPeer)
+    {
+        Logger::info("其他实例批量写入学生数据，已清除本地缓存，来源: {}", event.origin);
+        return;
+    }
+
+    // 列表与计数可整体失效；单条Redis缓存无法枚举，依赖过期时间收敛
+    clearStudentsCache();
+    Logger::warn("学生变更通知可能丢失，已清除本地缓存与列表缓存");
+}
+
+void DatabaseManager::onCacheInvalidated(const std::vector<std::string_view> &keys)
+{
+    if (keys.empty())
+    {
+        forgetAllStudents();
+        return;
+    }
+
+    static constexpr std::string_view prefix = "student:";
+    for (std::string_view key : keys)
+    {
+        if (key.substr(0, prefix.size()) != prefix)
+            continue;
+
+        int id;
+        const char *begin = key.data() + prefix.size();
+        const char *end = key.data() + key.size();
+        auto result = std::from_chars(begin, end, id);
+        if (result.ec == std::errc() && result.ptr == end)
+        {
+            forgetStudent(id);
+        }
+    }
+}
+
+void DatabaseManager::clearStudentsCache()
+{
+    // 清除学生数量缓存，递增代数使所有学生列表缓存失效
+    ++countVersion;
+    redisManager.del("students:count");
+    bumpStudentListGeneration();
+}
+
+void DatabaseManager::clearStudentCache(int id)
+{
+    forgetStudent(id);
+    std::string cacheKey = "student:" + std::to_string(id);
+    redisManager.del(cacheKey);
+}
+
+void DatabaseManager::updateStudentCache(int id, const Student &student)
+{
+    std::string cacheKey = "student:" + std::to_string(id);
+    std::string cacheValue = studentToCacheString(student);
+    // 使用配置管理器获取过期时间，如果没有配置管理器则使用默认值
+    int expireSeconds = 300; // 默认5分钟
+    if (configManager)
+    {
+        expireSeconds = configManager->getStudentCacheExpire();
+    }
+    forgetStudent(id);
     redisManager.set(cacheKey, cacheValue, expireSeconds);
 }
+
+void DatabaseManager::fillStudentCache(int id, const Student &student, uint64_t sequence)
+{
+    // 读取期间该id有写入或失效时放弃回填，读到的旧值不能覆盖写路径更新的缓存
+    if (studentVersion(id).load() != sequence)
+        return;
+
+    int expireSeconds = configManager ? configManager->getStudentCacheExpire() : 300;
+    char keyBuffer[32];
+    redisManager.set(std::string(studentCacheKey(keyBuffer, id)), studentToCacheString(student), expireSeconds);
+    admitLocal(id, student, sequence);
+}
+
+void DatabaseManager::admitLocal(int id, const Student &student, uint64_t sequence)
+{
+    // Default跟踪模式下服务端只跟踪本实例GET读取过的键，未经GET的值收不到其他实例修改的失效推送
+    if (redisManager.trackingMode() == RedisManager::TrackingMode::Default)
+        return;
+
+    localCache.insert(id, student, studentVersion(id), sequence);
+}
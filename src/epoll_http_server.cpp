@@ -0,0 +1,662 @@
+#include "epoll_http_server.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cctype>
+#include <charconv>
+#include <mutex>
+#include <optional>
+#include "logger.h"
+
+namespace
+{
+    constexpr int kMaxEvents = 256;
+    constexpr size_t kReadChunk = 16 * 1024;
+    constexpr int kIdleSweepMs = 1000;
+
+    bool equalsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+                return false;
+        }
+        return true;
+    }
+
+    std::string_view trim(std::string_view value)
+    {
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t'))
+            value.remove_prefix(1);
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t'))
+            value.remove_suffix(1);
+        return value;
+    }
+
+    const char *reasonPhrase(int status)
+    {
+        switch (status)
+        {
+        case 200:
+            return "OK";
+        case 400:
+            return "Bad Request";
+        case 404:
+            return "Not Found";
+        case 413:
+            return "Payload Too Large";
+        case 500:
+            return "Internal Server Error";
+        case 501:
+            return "Not Implemented";
+        case 503:
+            return "Service Unavailable";
+        default:
+            return "Unknown";
+        }
+    }
+}
+
+enum class EpollHttpServer::ParseResult
+{
+    Incomplete,  // 数据不足，等待更多输入
+    Complete,    // 已解析出完整请求
+    BadRequest,  // 请求格式错误
+    TooLarge,    // 超过请求大小上限
+    Unsupported  // 不支持的传输方式（如chunked）
+};
+
+// 连接状态：输入缓冲区由连接持有，请求在其上原地解析；
+// 同一连接同一时间只处理一个请求，流水线中的后续请求留在缓冲区中
+struct EpollHttpServer::Connection
+{
+    int fd;
+    uint64_t id;
+    std::string peer;
+    std::string input;
+    std::string output;
+    size_t written = 0;
+    bool busy = false;
+    bool keepAlive = true;
+    bool closeAfterWrite = false;
+    bool peerClosed = false; // 对端已关闭写方向，已收到的请求处理完后关闭
+    std::chrono::steady_clock::time_point lastActive;
+};
+
+// 解析结果中的字段均为指向连接输入缓冲区的视图，仅在分派期间有效
+struct EpollHttpServer::Request
+{
+    std::string_view method;
+    std::string_view path;
+    std::string_view body;
+    std::string_view clientId;
+    bool keepAlive = true;
+    size_t length = 0;
+};
+
+struct EpollHttpServer::CompletionQueue
+{
+    struct Item
+    {
+        int fd;
+        uint64_t connectionId;
+        RouteResponse response;
+    };
+
+    std::mutex mutex;
+    std::vector<Item> items;
+    int wakeFd = -1;
+    bool closed = false;
+
+    void push(Item item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed)
+            return;
+        items.push_back(std::move(item));
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+};
+
+EpollHttpServer::EpollHttpServer(DatabaseManager &dbManager, size_t maxRequestBytes, int idleTimeoutSeconds)
+    : dbManager(dbManager), maxRequestBytes(maxRequestBytes), idleTimeout(idleTimeoutSeconds),
+      lastIdleSweep(std::chrono::steady_clock::now()),
+      epollFd(epoll_create1(EPOLL_CLOEXEC)), listenFd(-1), wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      running(false), nextConnectionId(1), completions(std::make_shared<CompletionQueue>())
+{
+    completions->wakeFd = wakeFd;
+}
+
+EpollHttpServer::~EpollHttpServer()
+{
+    {
+        // 之后完成的请求直接丢弃，不再写入已关闭的eventfd
+        std::lock_guard<std::mutex> lock(completions->mutex);
+        completions->closed = true;
+    }
+
+    for (auto &pair : connections)
+    {
+        ::close(pair.first);
+    }
+    connections.clear();
+
+    if (listenFd >= 0)
+        ::close(listenFd);
+    if (wakeFd >= 0)
+        ::close(wakeFd);
+    if (epollFd >= 0)
+        ::close(epollFd);
+}
+
+bool EpollHttpServer::listen(const std::string &host, int port)
+{
+    if (epollFd < 0 || wakeFd < 0)
+    {
+        Logger::error("epoll初始化失败: {}", std::strerror(errno));
+        return false;
+    }
+    if (!bindListener(host, port))
+    {
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    running = true;
+    Logger::info("epoll前端开始监听 {}:{}", host, port);
+
+    epoll_event events[kMaxEvents];
+    while (running)
+    {
+        int count = epoll_wait(epollFd, events, kMaxEvents, idleTimeout.count() > 0 ? kIdleSweepMs : -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            Logger::error("epoll_wait失败: {}", std::strerror(errno));
+            return false;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            int fd = events[i].data.fd;
+            if (fd == listenFd)
+            {
+                acceptConnections();
+                continue;
+            }
+            if (fd == wakeFd)
+            {
+                drainCompletions();
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end())
+                continue;
+
+            Connection &connection = *it->second;
+            bool keep = !(events[i].events & (EPOLLERR | EPOLLHUP));
+            if (keep && (events[i].events & (EPOLLIN | EPOLLRDHUP)))
+                keep = handleReadable(connection);
+            if (keep && (events[i].events & EPOLLOUT))
+                keep = handleWritable(connection);
+            if (!keep)
+                closeConnection(fd);
+        }
+
+        closeIdleConnections();
+    }
+
+    Logger::info("epoll前端已停止");
+    return true;
+}
+
+void EpollHttpServer::stop()
+{
+    running = false;
+    uint64_t one = 1;
+    ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+    (void)ignored;
+}
+
+bool EpollHttpServer::bindListener(const std::string &host, int port)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    addrinfo *results = nullptr;
+    std::string service = std::to_string(port);
+    int status = getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &results);
+    if (status != 0)
+    {
+        Logger::error("解析监听地址失败: {}:{} ({})", host, port, gai_strerror(status));
+        return false;
+    }
+
+    for (addrinfo *address = results; address; address = address->ai_next)
+    {
+        int fd = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd < 0)
+            continue;
+
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(fd, address->ai_addr, address->ai_addrlen) == 0 && ::listen(fd, SOMAXCONN) == 0)
+        {
+            listenFd = fd;
+            break;
+        }
+        ::close(fd);
+    }
+    freeaddrinfo(results);
+
+    if (listenFd < 0)
+    {
+        Logger::error("绑定监听地址失败: {}:{} ({})", host, port, std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void EpollHttpServer::acceptConnections()
+{
+    // 边沿触发：一次取完所有待接受的连接
+    while (true)
+    {
+        sockaddr_storage address{};
+        socklen_t length = sizeof(address);
+        int fd = accept4(listenFd, reinterpret_cast<sockaddr *>(&address), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                Logger::warn("接受连接失败: {}", std::strerror(errno));
+            return;
+        }
+
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->id = nextConnectionId++;
+        connection->lastActive = std::chrono::steady_clock::now();
+
+        char peer[INET6_ADDRSTRLEN] = {0};
+        if (address.ss_family == AF_INET)
+            inet_ntop(AF_INET, &reinterpret_cast<sockaddr_in *>(&address)->sin_addr, peer, sizeof(peer));
+        else if (address.ss_family == AF_INET6)
+            inet_ntop(AF_INET6, &reinterpret_cast<sockaddr_in6 *>(&address)->sin6_addr, peer, sizeof(peer));
+        connection->peer = peer;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            Logger::warn("注册连接失败: {}", std::strerror(errno));
+            ::close(fd);
+            continue;
+        }
+        connections[fd] = std::move(connection);
+    }
+}
+
+bool EpollHttpServer::handleReadable(Connection &connection)
+{
+    // 边沿触发：读到EAGAIN为止
+    while (true)
+    {
+        size_t offset = connection.input.size();
+        connection.input.resize(offset + kReadChunk);
+        ssize_t received = recv(connection.fd, &connection.input[offset], kReadChunk, 0);
+        connection.input.resize(offset + (received > 0 ? static_cast<size_t>(received) : 0));
+
+        if (received > 0)
+        {
+            connection.lastActive = std::chrono::steady_clock::now();
+            if (connection.input.size() > maxRequestBytes && !limitInput(connection))
+                return false;
+            if (connection.closeAfterWrite)
+                break;
+            continue;
+        }
+        if (received == 0)
+        {
+            // 半关闭：对端可能仍在等待已发出请求的响应
+            connection.peerClosed = true;
+            break;
+        }
+        if (errno == EINTR)
+            continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+        return false;
+    }
+
+    if (connection.busy)
+        return true;
+    return processRequests(connection);
+}
+
+bool EpollHttpServer::limitInput(Connection &connection)
+{
+    // 空闲时先处理已完整到达的请求腾出缓冲；处理中的请求完成前不解析后续数据，积压超过上限时断开
+    if (!connection.busy && !processRequests(connection))
+        return false;
+    if (connection.input.size() <= maxRequestBytes)
+        return true;
+    if (connection.busy)
+        return false;
+
+    // 剩余的是一个不完整且已超过上限的请求：回复413，之后到达的数据不再接收
+    if (!connection.closeAfterWrite)
+    {
+        connection.keepAlive = false;
+        queueResponse(connection, errorResponse(413, "请求过大"));
+    }
+    connection.input.clear();
+    return flush(connection);
+}
+
+bool EpollHttpServer::handleWritable(Connection &connection)
+{
+    if (!flush(connection))
+        return false;
+    if (!connection.busy && connection.output.empty() && !connection.input.empty())
+        return processRequests(connection);
+    return true;
+}
+
+void EpollHttpServer::drainCompletions()
+{
+    uint64_t value;
+    while (::read(wakeFd, &value, sizeof(value)) > 0)
+    {
+    }
+
+    std::vector<CompletionQueue::Item> items;
+    {
+        std::lock_guard<std::mutex> lock(completions->mutex);
+        items.swap(completions->items);
+    }
+
+    for (auto &item : items)
+    {
+        // 连接可能已关闭，fd也可能已被新连接复用
+        auto it = connections.find(item.fd);
+        if (it == connections.end() || it->second->id != item.connectionId)
+            continue;
+
+        Connection &connection = *it->second;
+        connection.busy = false;
+        connection.lastActive = std::chrono::steady_clock::now();
+        queueResponse(connection, item.response);
+        if (!flush(connection) || !processRequests(connection))
+            closeConnection(item.fd);
+    }
+}
+
+void EpollHttpServer::closeConnection(int fd)
+{
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+}
+
+void EpollHttpServer::closeIdleConnections()
+{
+    if (idleTimeout.count() <= 0)
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastIdleSweep < std::chrono::milliseconds(kIdleSweepMs))
+        return;
+    lastIdleSweep = now;
+
+    // 处理中的请求由数据库侧的超时兜底；积压输出而对端不读取的连接同样视为空闲
+    std::vector<int> idle;
+    for (const auto &pair : connections)
+    {
+        const Connection &connection = *pair.second;
+        if (!connection.busy && now - connection.lastActive > idleTimeout)
+            idle.push_back(pair.first);
+    }
+    for (int fd : idle)
+    {
+        closeConnection(fd);
+    }
+    if (!idle.empty())
+        Logger::debug("关闭空闲连接 {} 个", idle.size());
+}
+
+bool EpollHttpServer::processRequests(Connection &connection)
+{
+    while (!connection.busy && !connection.closeAfterWrite && !connection.input.empty())
+    {
+        Request request;
+        ParseResult result = parseRequest(connection, request);
+        if (result == ParseResult::Incomplete)
+            break;
+
+        if (result != ParseResult::Complete)
+        {
+            connection.keepAlive = false;
+            if (result == ParseResult::TooLarge)
+                queueResponse(connection, errorResponse(413, "请求过大"));
+            else if (result == ParseResult::Unsupported)
+                queueResponse(connection, errorResponse(501, "不支持的传输编码"));
+            else
+                queueResponse(connection, errorResponse(400, "无效的请求"));
+            break;
+        }
+
+        connection.keepAlive = request.keepAlive;
+        size_t length = request.length;
+        dispatch(connection, request);
+        connection.input.erase(0, length);
+    }
+
+    // 对端已半关闭且没有可处理的完整请求：写完已排队的响应后关闭
+    if (connection.peerClosed && !connection.busy)
+        connection.closeAfterWrite = true;
+
+    return flush(connection);
+}
+
+EpollHttpServer::ParseResult EpollHttpServer::parseRequest(const Connection &connection, Request &request) const
+{
+    std::string_view data(connection.input);
+    size_t headerEnd = data.find("\r\n\r\n");
+    if (headerEnd == std::string_view::npos)
+        return data.size() > maxRequestBytes ? ParseResult::TooLarge : ParseResult::Incomplete;
+
+    // 请求行：METHOD SP TARGET SP VERSION
+    size_t lineEnd = data.find("\r\n");
+    std::string_view requestLine = data.substr(0, lineEnd);
+    size_t firstSpace = requestLine.find(' ');
+    size_t secondSpace = requestLine.find(' ', firstSpace + 1);
+    if (firstSpace == std::string_view::npos || secondSpace == std::string_view::npos)
+        return ParseResult::BadRequest;
+
+    request.method = requestLine.substr(0, firstSpace);
+    std::string_view target = requestLine.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+    std::string_view version = requestLine.substr(secondSpace + 1);
+    if (version.substr(0, 5) != "HTTP/")
+        return ParseResult::BadRequest;
+    request.path = target.substr(0, target.find('?'));
+    request.keepAlive = version != "HTTP/1.0";
+
+    size_t contentLength = 0;
+    size_t position = lineEnd + 2;
+    while (position < headerEnd)
+    {
+        size_t end = data.find("\r\n", position);
+        std::string_view line = data.substr(position, end - position);
+        position = end + 2;
+
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos)
+            return ParseResult::BadRequest;
+        std::string_view name = trim(line.substr(0, colon));
+        std::string_view value = trim(line.substr(colon + 1));
+
+        if (equalsIgnoreCase(name, "Content-Length"))
+        {
+            auto parsed = std::from_chars(value.data(), value.data() + value.size(), contentLength);
+            if (parsed.ec != std::errc() || parsed.ptr != value.data() + value.size())
+                return ParseResult::BadRequest;
+        }
+        else if (equalsIgnoreCase(name, "Transfer-Encoding"))
+        {
+            return ParseResult::Unsupported;
+        }
+        else if (equalsIgnoreCase(name, "Connection"))
+        {
+            if (equalsIgnoreCase(value, "close"))
+                request.keepAlive = false;
+            else if (equalsIgnoreCase(value, "keep-alive"))
+                request.keepAlive = true;
+        }
+        else if (equalsIgnoreCase(name, "X-Client-Id"))
+        {
+            request.clientId = value;
+        }
+    }
+
+    size_t bodyStart = headerEnd + 4;
+    if (contentLength > maxRequestBytes)
+        return ParseResult::TooLarge;
+    if (data.size() < bodyStart + contentLength)
+        return ParseResult::Incomplete;
+
+    request.body = data.substr(bodyStart, contentLength);
+    request.length = bodyStart + contentLength;
+    return ParseResult::Complete;
+}
+
+void EpollHttpServer::dispatch(Connection &connection, const Request &request)
+{
+    // 视图在此处转为协程参数，之后输入缓冲区可以安全地移除该请求
+    std::string clientId = request.clientId.empty() ? connection.peer : std::string(request.clientId);
+    std::optional<Task<RouteResponse>> task;
+
+    if (request.path == "/students")
+    {
+        if (request.method == "POST")
+            task.emplace(handleAddStudent(dbManager, std::string(request.body), clientId));
+        else if (request.method == "GET")
+            task.emplace(handleListStudents(dbManager, clientId));
+    }
+    else if (request.path.substr(0, 10) == "/students/")
+    {
+        std::string_view digits = request.path.substr(10);
+        int studentId = 0;
+        auto parsed = std::from_chars(digits.data(), digits.data() + digits.size(), studentId);
+        if (!digits.empty() && parsed.ec == std::errc() && parsed.ptr == digits.data() + digits.size())
+        {
+            if (request.method == "GET")
+                task.emplace(handleGetStudent(dbManager, studentId, clientId));
+            else if (request.method == "PUT")
+                task.emplace(handleUpdateStudent(dbManager, studentId, std::string(request.body), clientId));
+            else if (request.method == "DELETE")
+                task.emplace(handleDeleteStudent(dbManager, studentId, clientId));
+        }
+    }
+    else if (request.path == "/health" && request.method == "GET")
+    {
+        task.emplace(handleHealth(dbManager, clientId));
+    }
+    else if (request.path == "/ready" && request.method == "GET")
+    {
+        queueResponse(connection, handleReady(dbManager));
+        return;
+    }
+    else if (request.path == "/metrics" && request.method == "GET")
+    {
+        queueResponse(connection, RouteResponse{200, dbManager.getMetrics().dump()});
+        return;
+    }
+
+    if (!task)
+    {
+        queueResponse(connection, errorResponse(404, "接口不存在"));
+        return;
+    }
+
+    // 协程在调度线程池上完成，响应经完成队列交回事件循环线程
+    connection.busy = true;
+    int fd = connection.fd;
+    uint64_t connectionId = connection.id;
+    std::shared_ptr<CompletionQueue> queue = completions;
+    startTask<RouteResponse>(std::move(*task), [queue, fd, connectionId](std::optional<RouteResponse> response, std::exception_ptr error)
+                             {
+        if (error || !response)
+        {
+            queue->push({fd, connectionId, errorResponse(500, "服务器内部错误")});
+            return;
+        }
+        queue->push({fd, connectionId, std::move(*response)}); });
+}
+
+void EpollHttpServer::queueResponse(Connection &connection, const RouteResponse &response)
+{
+    if (!connection.keepAlive)
+        connection.closeAfterWrite = true;
+
+    std::string &output = connection.output;
+    output.reserve(output.size() + response.body.size() + 128);
+    output += "HTTP/1.1 ";
+    output += std::to_string(response.status);
+    output += ' ';
+    output += reasonPhrase(response.status);
+    output += "\r\nContent-Type: application/json\r\nContent-Length: ";
+    output += std::to_string(response.body.size());
+    output += connection.keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+    output += response.body;
+}
+
+bool EpollHttpServer::flush(Connection &connection)
+{
+    while (connection.written < connection.output.size())
+    {
+        ssize_t sent = send(connection.fd, connection.output.data() + connection.written,
+                            connection.output.size() - connection.written, MSG_NOSIGNAL);
+        if (sent > 0)
+        {
+            connection.written += static_cast<size_t>(sent);
+            connection.lastActive = std::chrono::steady_clock::now();
+            continue;
+        }
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true; // 等待EPOLLOUT
+        return false;
+    }
+
+    connection.output.clear();
+    connection.written = 0;
+    return !connection.closeAfterWrite;
+}
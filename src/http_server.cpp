@@ -11,50 +11,16 @@
 #include "database_manager.h"
 #include "config_manager.h"
 #include "logger.h"
-#include "timer.h"
+#include "student_routes.h"
+#include "epoll_http_server.h"
 
 using json = nlohmann::json;
 
-// 解析JSON格式的学生信息（使用nlohmann/json库）
-Student parseStudentFromJson(const std::string &jsonStr)
+// 获取客户端标识（用于读己之写），优先使用X-Client-Id请求头
+std::string clientIdOf(const httplib::Request &req)
 {
-    try
-    {
-        json j = json::parse(jsonStr);
-
-        std::string name = j.value("name", "");
-        int age = j.value("age", 0);
-        std::string className = j.value("className", "");
-
-        return Student(name, age, className);
-    }
-    catch (const json::parse_error &e)
-    {
-        Logger::error("JSON解析错误: {}", e.what());
-        throw std::runtime_error("无效的JSON格式");
-    }
-    catch (const json::exception &e)
-    {
-        Logger::error("JSON处理错误: {}", e.what());
-        throw std::runtime_error("JSON处理失败");
-    }
-}
-
-// 将Student对象转换为JSON字符串（使用nlohmann/json库）
-std::string studentToJson(const Student &student, int id = -1)
-{
-    json j;
-
-    if (id != -1)
-    {
-        j["id"] = id;
-    }
-
-    j["name"] = student.getName();
-    j["age"] = student.getAge();
-    j["className"] = student.getClassName();
-
-    return j.dump();
+    std::string clientId = req.get_header_value("X-Client-Id");
+    return clientId.empty() ? req.remote_addr : clientId;
 }
 
 // 查找配置文件
@@ -82,6 +48,21 @@ std::string findConfigFile()
     return "config.json"; // 默认
 }
 
+// 输出服务地址与可用接口
+void logEndpoints(const std::string &serverHost, int serverPort)
+{
+    Logger::info("HTTP服务器启动在 http://{}:{}", serverHost, serverPort);
+    Logger::info("可用接口:");
+    Logger::info("  POST   /students     - 添加学生");
+    Logger::info("  GET    /students     - 获取所有学生");
+    Logger::info("  GET    /students/{{id}} - 获取特定学生");
+    Logger::info("  PUT    /students/{{id}} - 更新学生");
+    Logger::info("  DELETE /students/{{id}} - 删除学生");
+    Logger::info("  GET    /health       - 健康检查");
+    Logger::info("  GET    /ready        - 就绪检查");
+    Logger::info("  GET    /metrics      - 运行指标");
+}
+
 // 启动HTTP服务器
 void startHttpServer()
 {
@@ -121,154 +102,63 @@ void startHttpServer()
         return;
     }
 
-    httplib::Server svr;
-
     // 使用配置中的服务器设置
     std::string serverHost = configManager.getServerHost();
     int serverPort = configManager.getServerPort();
 
+    // epoll前端：单线程事件循环承载所有连接，运行相同的路由处理函数
+    if (configManager.getServerFrontend() == "epoll")
+    {
+        EpollHttpServer server(dbManager, static_cast<size_t>(std::max(configManager.getMaxRequestBytes(), 1024)),
+                               std::max(configManager.getIdleTimeoutSeconds(), 0));
+        logEndpoints(serverHost, serverPort);
+        server.listen(serverHost, serverPort);
+        return;
+    }
+
+    httplib::Server svr;
+
+    // 学生接口由协程处理函数完成：syncWait下协程的Redis与数据库操作直接在httplib工作线程上执行，
+    // 每个请求只占用一个线程
+    auto respond = [](httplib::Response &res, const RouteResponse &response)
+    {
+        res.status = response.status;
+        res.set_content(response.body, "application/json");
+    };
+
     // 添加学生信息 - POST /students
-    svr.Post("/students", [&dbManager](const httplib::Request &req, httplib::Response &res)
-             {
-        Logger::info("收到添加学生请求: {}", req.body);
-        
-        try {
-            Student student = parseStudentFromJson(req.body);
-            int studentId = dbManager.addStudent(student);
-            
-            if (studentId > 0) {
-                std::string response = studentToJson(student, studentId);
-                res.set_content(response, "application/json");
-                Logger::info("成功添加学生，ID: {}", studentId);
-            } else {
-                res.status = 500;
-                json errorJson;
-                errorJson["error"] = "数据库操作失败";
-                res.set_content(errorJson.dump(), "application/json");
-                Logger::error("添加学生失败");
-            }
-        } catch (const std::exception& e) {
-            res.status = 400;
-            json errorJson;
-            errorJson["error"] = "无效的学生数据";
-            res.set_content(errorJson.dump(), "application/json");
-            Logger::error("添加学生失败: {}", e.what());
-        } });
+    svr.Post("/students", [&dbManager, &respond](const httplib::Request &req, httplib::Response &res)
+             { respond(res, syncWait(handleAddStudent(dbManager, req.body, clientIdOf(req)))); });
 
     // 获取所有学生信息 - GET /students
-    svr.Get("/students", [&dbManager](const httplib::Request &req, httplib::Response &res)
-            {
-        Timer timer;
-        Logger::info("收到获取所有学生请求");
-        
-        auto students = dbManager.getAllStudents();
-        json j = json::array();
-        
-        for (const auto& pair : students) {
-            json studentJson;
-            studentJson["id"] = pair.first;
-            studentJson["name"] = pair.second.getName();
-            studentJson["age"] = pair.second.getAge();
-            studentJson["className"] = pair.second.getClassName();
-            j.push_back(studentJson);
-        }
-        
-        res.set_content(j.dump(), "application/json");
-        Logger::info("返回 {} 个学生信息", students.size()); });
+    svr.Get("/students", [&dbManager, &respond](const httplib::Request &req, httplib::Response &res)
+            { respond(res, syncWait(handleListStudents(dbManager, clientIdOf(req)))); });
 
     // 获取特定学生信息 - GET /students/{id}
-    svr.Get(R"(/students/(\d+))", [&dbManager](const httplib::Request &req, httplib::Response &res)
-            {
-        int studentId = std::stoi(req.matches[1]);
-        Logger::info("收到获取学生请求，ID: {}", studentId);
-        
-        Student student = dbManager.getStudent(studentId);
-        // 检查学生是否存在，确保所有字段都有有效值
-        if (student.getName() != "" && student.getAge() > 0 && student.getClassName() != "") {
-            std::string response = studentToJson(student, studentId);
-            res.set_content(response, "application/json");
-            Logger::info("成功返回学生信息");
-        } else {
-            res.status = 404;
-            json errorJson;
-            errorJson["error"] = "学生不存在";
-            res.set_content(errorJson.dump(), "application/json");
-            Logger::warn("学生不存在，ID: {}", studentId);
-        } });
+    svr.Get(R"(/students/(\d+))", [&dbManager, &respond](const httplib::Request &req, httplib::Response &res)
+            { respond(res, syncWait(handleGetStudent(dbManager, std::stoi(req.matches[1]), clientIdOf(req)))); });
 
     // 更新学生信息 - PUT /students/{id}
-    svr.Put(R"(/students/(\d+))", [&dbManager](const httplib::Request &req, httplib::Response &res)
-            {
-        int studentId = std::stoi(req.matches[1]);
-        Logger::info("收到更新学生请求，ID: {} 数据: {}", studentId, req.body);
-        
-        try {
-            Student student = parseStudentFromJson(req.body);
-            bool success = dbManager.updateStudent(studentId, student);
-            
-            if (success) {
-                std::string response = studentToJson(student, studentId);
-                res.set_content(response, "application/json");
-                Logger::info("成功更新学生信息");
-            } else {
-                res.status = 404;
-                json errorJson;
-                errorJson["error"] = "学生不存在";
-                res.set_content(errorJson.dump(), "application/json");
-                Logger::warn("学生不存在，ID: {}", studentId);
-            }
-        } catch (const std::exception& e) {
-            res.status = 400;
-            json errorJson;
-            errorJson["error"] = "无效的学生数据";
-            res.set_content(errorJson.dump(), "application/json");
-            Logger::error("更新学生失败: {}", e.what());
-        } });
+    svr.Put(R"(/students/(\d+))", [&dbManager, &respond](const httplib::Request &req, httplib::Response &res)
+            { respond(res, syncWait(handleUpdateStudent(dbManager, std::stoi(req.matches[1]), req.body, clientIdOf(req)))); });
 
     // 删除学生信息 - DELETE /students/{id}
-    svr.Delete(R"(/students/(\d+))", [&dbManager](const httplib::Request &req, httplib::Response &res)
-               {
-        int studentId = std::stoi(req.matches[1]);
-        Logger::info("收到删除学生请求，ID: {}", studentId);
-        
-        bool success = dbManager.deleteStudent(studentId);
-        if (success) {
-            json successJson;
-            successJson["message"] = "学生删除成功";
-            res.set_content(successJson.dump(), "application/json");
-            Logger::info("成功删除学生");
-        } else {
-            res.status = 404;
-            json errorJson;
-            errorJson["error"] = "学生不存在";
-            res.set_content(errorJson.dump(), "application/json");
-            Logger::warn("学生不存在，ID: {}", studentId);
-        } });
+    svr.Delete(R"(/students/(\d+))", [&dbManager, &respond](const httplib::Request &req, httplib::Response &res)
+               { respond(res, syncWait(handleDeleteStudent(dbManager, std::stoi(req.matches[1]), clientIdOf(req)))); });
 
     // 健康检查接口
-    svr.Get("/health", [&dbManager](const httplib::Request &req, httplib::Response &res)
-            { 
-        int count = dbManager.getStudentCount();
-        json j;
-        
-        if (count >= 0) {
-            j["status"] = "ok";
-            j["students_count"] = count;
-            res.set_content(j.dump(), "application/json");
-        } else {
-            res.status = 500;
-            j["error"] = "数据库查询失败";
-            res.set_content(j.dump(), "application/json");
-        } });
+    svr.Get("/health", [&dbManager, &respond](const httplib::Request &req, httplib::Response &res)
+            { respond(res, syncWait(handleHealth(dbManager, clientIdOf(req)))); });
 
-    Logger::info("HTTP服务器启动在 http://{}:{}", serverHost, serverPort);
-    Logger::info("可用接口:");
-    Logger::info("  POST   /students     - 添加学生");
-    Logger::info("  GET    /students     - 获取所有学生");
-    Logger::info("  GET    /students/{{id}} - 获取特定学生");
-    Logger::info("  PUT    /students/{{id}} - 更新学生");
-    Logger::info("  DELETE /students/{{id}} - 删除学生");
-    Logger::info("  GET    /health       - 健康检查");
+    // 就绪检查接口
+    svr.Get("/ready", [&dbManager, &respond](const httplib::Request &, httplib::Response &res)
+            { respond(res, handleReady(dbManager)); });
+
+    // 运行指标接口
+    svr.Get("/metrics", [&dbManager](const httplib::Request &, httplib::Response &res)
+            { res.set_content(dbManager.getMetrics().dump(), "application/json"); });
+
+    logEndpoints(serverHost, serverPort);
 
     Logger::info("开始监听端口 {}...", serverPort);
     svr.listen(serverHost.c_str(), serverPort);
@@ -0,0 +1,169 @@
+#include "io_executor.h"
+#include "logger.h"
+
+const char *asyncStatusName(AsyncStatus status)
+{
+    switch (status)
+    {
+    case AsyncStatus::Ok:
+        return "ok";
+    case AsyncStatus::Timeout:
+        return "timeout";
+    case AsyncStatus::Cancelled:
+        return "cancelled";
+    case AsyncStatus::Rejected:
+        return "rejected";
+    case AsyncStatus::Failed:
+        return "failed";
+    }
+    return "unknown";
+}
+
+CancellationToken::CancellationToken()
+    : state(std::make_shared<State>())
+{
+}
+
+void CancellationToken::cancel() const
+{
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->cancelled)
+            return;
+        state->cancelled = true;
+        callbacks.swap(state->callbacks);
+    }
+
+    for (auto &callback : callbacks)
+    {
+        callback();
+    }
+}
+
+bool CancellationToken::isCancelled() const
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->cancelled;
+}
+
+void CancellationToken::onCancel(std::function<void()> callback) const
+{
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->cancelled)
+        {
+            state->callbacks.push_back(std::move(callback));
+            return;
+        }
+    }
+    callback();
+}
+
+IoExecutor::IoExecutor(size_t threadCount, size_t queueCapacity, std::chrono::milliseconds defaultTimeout)
+    : pool(threadCount, queueCapacity), defaultTimeout(defaultTimeout), running(true),
+      completedCount(0), timeoutCount(0), cancelledCount(0), rejectedCount(0), failedCount(0)
+{
+    timerThread = std::thread(&IoExecutor::timerLoop, this);
+    Logger::info("I/O执行器启动，线程数: {}，队列上限: {}", pool.size(), queueCapacity);
+}
+
+IoExecutor::~IoExecutor()
+{
+    shutdown();
+}
+
+void IoExecutor::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        if (!running)
+            return;
+        running = false;
+    }
+    timerCv.notify_all();
+    if (timerThread.joinable())
+    {
+        timerThread.join();
+    }
+
+    pool.shutdown();
+}
+
+IoExecutor::Stats IoExecutor::getStats() const
+{
+    Stats stats;
+    stats.threads = pool.size();
+    stats.queued = pool.pending();
+    stats.capacity = pool.capacity();
+    stats.completed = completedCount.load();
+    stats.timeouts = timeoutCount.load();
+    stats.cancelled = cancelledCount.load();
+    stats.rejected = rejectedCount.load();
+    stats.failed = failedCount.load();
+    return stats;
+}
+
+void IoExecutor::schedule(Clock::time_point deadline, std::function<void()> action)
+{
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        earliest = timers.empty() || deadline < timers.top().deadline;
+        timers.push({deadline, std::move(action)});
+    }
+
+    // 新的截止时间早于当前等待目标时唤醒定时器线程
+    if (earliest)
+    {
+        timerCv.notify_one();
+    }
+}
+
+void IoExecutor::timerLoop()
+{
+    std::unique_lock<std::mutex> lock(timerMutex);
+    while (running)
+    {
+        if (timers.empty())
+        {
+            timerCv.wait(lock);
+            continue;
+        }
+
+        Clock::time_point deadline = timers.top().deadline;
+        if (Clock::now() < deadline)
+        {
+            timerCv.wait_until(lock, deadline);
+            continue;
+        }
+
+        std::function<void()> action = timers.top().action;
+        timers.pop();
+        lock.unlock();
+        action();
+        lock.lock();
+    }
+}
+
+void IoExecutor::record(AsyncStatus status)
+{
+    switch (status)
+    {
+    case AsyncStatus::Ok:
+        ++completedCount;
+        break;
+    case AsyncStatus::Timeout:
+        ++timeoutCount;
+        break;
+    case AsyncStatus::Cancelled:
+        ++cancelledCount;
+        break;
+    case AsyncStatus::Rejected:
+        ++rejectedCount;
+        break;
+    case AsyncStatus::Failed:
+        ++failedCount;
+        break;
+    }
+}
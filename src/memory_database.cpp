@@ -0,0 +1,1087 @@
+#include "memory_database.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <new>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include "logger.h"
+
+namespace
+{
+    const size_t kInitialIndexCapacity = 1024;
+    const size_t kArenaChunkSize = 1 << 20;
+    const size_t kReadShards = 64;
+    const size_t kSnapshotWriteBuffer = 1 << 20;
+    const uint32_t kSnapshotMagic = 0x534D5348;
+    const uint32_t kSnapshotVersion = 1;
+    const uint32_t kChecksumSeed = 2166136261u;
+
+    // FNV-1a，可分段累加
+    uint32_t checksum(const char *data, size_t length, uint32_t hash = kChecksumSeed)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    void appendUint32(std::string &buffer, uint32_t value)
+    {
+        buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    void appendUint64(std::string &buffer, uint64_t value)
+    {
+        buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    void appendString(std::string &buffer, const char *data, uint32_t length)
+    {
+        appendUint32(buffer, length);
+        buffer.append(data, length);
+    }
+
+    bool readUint32(const char *&cursor, const char *end, uint32_t &value)
+    {
+        if (end - cursor < static_cast<std::ptrdiff_t>(sizeof(value)))
+            return false;
+        std::memcpy(&value, cursor, sizeof(value));
+        cursor += sizeof(value);
+        return true;
+    }
+
+    bool readUint64(const char *&cursor, const char *end, uint64_t &value)
+    {
+        if (end - cursor < static_cast<std::ptrdiff_t>(sizeof(value)))
+            return false;
+        std::memcpy(&value, cursor, sizeof(value));
+        cursor += sizeof(value);
+        return true;
+    }
+
+    bool readString(const char *&cursor, const char *end, std::string &value)
+    {
+        uint32_t length;
+        if (!readUint32(cursor, end, length) || end - cursor < static_cast<std::ptrdiff_t>(length))
+            return false;
+        value.assign(cursor, length);
+        cursor += length;
+        return true;
+    }
+
+    bool writeAll(int fd, const char *data, size_t length)
+    {
+        while (length > 0)
+        {
+            ssize_t written = ::write(fd, data, length);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool readFile(const std::string &path, std::string &data)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    // 重命名后同步所在目录，保证目录项落盘
+    void syncDirectory(const std::string &path)
+    {
+        size_t slash = path.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "." : path.substr(0, slash);
+        int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0)
+        {
+            ::fsync(fd);
+            ::close(fd);
+        }
+    }
+
+    // 每个线程固定映射到一个读计数分片
+    size_t threadShard()
+    {
+        static thread_local size_t shard = std::hash<std::thread::id>()(std::this_thread::get_id()) % kReadShards;
+        return shard;
+    }
+}
+
+// 记录头部后紧跟姓名字节，班级只保存字典id，发布后不再修改
+struct MemoryDatabase::Record
+{
+    int32_t id;
+    int32_t age;
+    uint32_t nameLength;
+    uint32_t classId;
+
+    const char *name() const { return reinterpret_cast<const char *>(this + 1); }
+    const std::string &className() const { return ClassNameTable::instance().name(classId); }
+    size_t size() const { return sizeof(Record) + nameLength; }
+
+    Student toStudent() const
+    {
+        return Student::withClassId(std::string(name(), nameLength), age, classId);
+    }
+};
+
+// 按块分配的记录区，记录连续存放；旧版本只计入垃圾字节，由压缩统一回收
+class MemoryDatabase::RecordArena
+{
+public:
+    const Record *create(int id, int age, const std::string &name, uint32_t classId)
+    {
+        Record header{id, age, static_cast<uint32_t>(name.size()), classId};
+        char *memory = allocate(alignedSize(header.size()));
+        Record *record = new (memory) Record(header);
+        std::memcpy(memory + sizeof(Record), name.data(), name.size());
+        return record;
+    }
+
+    const Record *copy(const Record &source)
+    {
+        char *memory = allocate(alignedSize(source.size()));
+        std::memcpy(memory, &source, source.size());
+        return reinterpret_cast<const Record *>(memory);
+    }
+
+    void retire(const Record *record)
+    {
+        size_t size = alignedSize(record->size());
+        liveBytes -= size;
+        garbageBytes += size;
+    }
+
+    size_t live() const { return liveBytes; }
+    size_t garbage() const { return garbageBytes; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t chunkUsed = 0;
+    size_t chunkCapacity = 0;
+    size_t liveBytes = 0;
+    size_t garbageBytes = 0;
+
+    static size_t alignedSize(size_t size)
+    {
+        return (size + alignof(Record) - 1) & ~(alignof(Record) - 1);
+    }
+
+    char *allocate(size_t size)
+    {
+        if (chunks.empty() || chunkUsed + size > chunkCapacity)
+        {
+            chunkCapacity = std::max(kArenaChunkSize, size);
+            chunks.emplace_back(new char[chunkCapacity]);
+            chunkUsed = 0;
+        }
+
+        char *memory = chunks.back().get() + chunkUsed;
+        chunkUsed += size;
+        liveBytes += size;
+        return memory;
+    }
+};
+
+// 线性探测哈希索引。键一旦写入槽位便不再移除，删除只清空记录指针（墓碑），
+// 因此读者无需加锁：看到键即可读取其记录指针
+struct MemoryDatabase::IndexTable
+{
+    struct Slot
+    {
+        std::atomic<int> key{0}; // 0表示空槽，id从1开始
+        std::atomic<const Record *> record{nullptr};
+    };
+
+    size_t capacity;
+    size_t mask;
+    int shift;
+    std::unique_ptr<Slot[]> slots;
+    size_t usedSlots = 0; // 含墓碑，仅写者访问
+    size_t liveCount = 0;
+
+    explicit IndexTable(size_t capacity)
+        : capacity(capacity), mask(capacity - 1), shift(64), slots(new Slot[capacity])
+    {
+        for (size_t value = capacity; value > 1; value >>= 1)
+        {
+            --shift;
+        }
+    }
+
+    size_t home(int id) const
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(id)) * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+
+    const Record *find(int id) const
+    {
+        for (size_t i = home(id);; i = (i + 1) & mask)
+        {
+            int key = slots[i].key.load(std::memory_order_acquire);
+            if (key == id)
+                return slots[i].record.load(std::memory_order_acquire);
+            if (key == 0)
+                return nullptr;
+        }
+    }
+
+    // 返回id所在槽位或其应插入的空槽
+    Slot &locate(int id)
+    {
+        for (size_t i = home(id);; i = (i + 1) & mask)
+        {
+            int key = slots[i].key.load(std::memory_order_relaxed);
+            if (key == id || key == 0)
+                return slots[i];
+        }
+    }
+
+    // 写入空槽：先发布记录再发布键
+    void publish(Slot &slot, int id, const Record *record)
+    {
+        slot.record.store(record, std::memory_order_release);
+        slot.key.store(id, std::memory_order_release);
+        ++usedSlots;
+        ++liveCount;
+    }
+
+    bool needsRebuild() const
+    {
+        return (usedSlots + 1) * 10 > capacity * 7;
+    }
+};
+
+// 分片读计数 + 双阶段翻转的宽限期（SRCU风格）：
+// 读者只增减本线程分片的计数，写者翻转阶段后等待旧阶段计数归零
+class MemoryDatabase::ReadDomain
+{
+public:
+    class Guard
+    {
+    public:
+        explicit Guard(ReadDomain &domain) : domain(domain), phase(domain.enter()) {}
+        ~Guard() { domain.leave(phase); }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+    private:
+        ReadDomain &domain;
+        unsigned phase;
+    };
+
+    // 返回后，调用前进入的读者均已离开
+    void synchronize()
+    {
+        for (int round = 0; round < 2; ++round)
+        {
+            unsigned phase = epoch.fetch_add(1) & 1;
+            while (hasReaders(phase))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct alignas(64) Shard
+    {
+        std::atomic<long> readers[2];
+
+        Shard()
+        {
+            readers[0].store(0);
+            readers[1].store(0);
+        }
+    };
+
+    Shard shards[kReadShards];
+    std::atomic<unsigned> epoch{0};
+
+    unsigned enter()
+    {
+        unsigned phase = epoch.load() & 1;
+        shards[threadShard()].readers[phase].fetch_add(1);
+        return phase;
+    }
+
+    void leave(unsigned phase)
+    {
+        shards[threadShard()].readers[phase].fetch_sub(1);
+    }
+
+    bool hasReaders(unsigned phase) const
+    {
+        for (const auto &shard : shards)
+        {
+            if (shard.readers[phase].load() != 0)
+                return true;
+        }
+        return false;
+    }
+};
+
+// WAL条目：[负载长度][校验和][类型][id][年龄][姓名][班级]
+struct MemoryDatabase::WalOp
+{
+    enum Type : uint8_t
+    {
+        Insert = 1,
+        Update = 2,
+        Delete = 3
+    };
+
+    Type type = Insert;
+    int id = 0;
+    Student student;
+    bool result = false;
+    bool done = false;
+
+    void encode(std::string &buffer) const
+    {
+        std::string payload;
+        payload.push_back(static_cast<char>(type));
+        appendUint32(payload, static_cast<uint32_t>(id));
+        if (type != Delete)
+        {
+            std::string name = student.getName();
+            std::string className = student.getClassName();
+            appendUint32(payload, static_cast<uint32_t>(student.getAge()));
+            appendString(payload, name.data(), static_cast<uint32_t>(name.size()));
+            appendString(payload, className.data(), static_cast<uint32_t>(className.size()));
+        }
+
+        appendUint32(buffer, static_cast<uint32_t>(payload.size()));
+        appendUint32(buffer, checksum(payload.data(), payload.size()));
+        buffer += payload;
+    }
+
+    bool decode(const char *cursor, const char *end)
+    {
+        if (cursor == end)
+            return false;
+
+        type = static_cast<Type>(*cursor++);
+        uint32_t value;
+        if (!readUint32(cursor, end, value))
+            return false;
+        id = static_cast<int>(value);
+
+        if (type == Delete)
+            return cursor == end;
+        if (type != Insert && type != Update)
+            return false;
+
+        uint32_t age;
+        std::string name;
+        std::string className;
+        if (!readUint32(cursor, end, age) || !readString(cursor, end, name) || !readString(cursor, end, className))
+            return false;
+
+        student = Student(name, static_cast<int>(age), className);
+        return cursor == end;
+    }
+};
+
+MemoryDatabase::MemoryDatabase(const ConfigManager &configManager)
+    : walPath(configManager.getMemoryWalPath()),
+      snapshotPath(configManager.getMemorySnapshotPath()),
+      snapshotInterval(configManager.getMemorySnapshotInterval()),
+      groupCommitWindow(configManager.getMemoryGroupCommitWindowUs()),
+      syncWrites(configManager.getMemorySyncWrites()),
+      index(nullptr), readDomain(std::make_unique<ReadDomain>()), recordCount(0),
+      walFd(-1), walBytes(0), arenaLiveBytes(0), arenaGarbageBytes(0),
+      leaderActive(false), nextId(1), groupCommits(0), committedOps(0), running(false)
+{
+}
+
+MemoryDatabase::~MemoryDatabase()
+{
+    close();
+}
+
+bool MemoryDatabase::open()
+{
+    if (index.load())
+        return true;
+
+    arena = std::make_unique<RecordArena>();
+    index.store(new IndexTable(kInitialIndexCapacity));
+    recordCount = 0;
+    nextId = 1;
+
+    if (!loadSnapshot() || !replayWal())
+    {
+        releaseStorage();
+        return false;
+    }
+    publishArenaStats();
+
+    walFd = ::open(walPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (walFd < 0)
+    {
+        Logger::error("无法打开WAL文件 {}: {}", walPath, std::strerror(errno));
+        releaseStorage();
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        running = true;
+    }
+    if (snapshotInterval.count() > 0)
+    {
+        snapshotThread = std::thread(&MemoryDatabase::snapshotLoop, this);
+    }
+
+    Logger::info("内存数据库已打开，记录数: {}", recordCount.load());
+    return true;
+}
+
+void MemoryDatabase::close()
+{
+    bool wasRunning;
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        wasRunning = running;
+        running = false;
+    }
+    snapshotCv.notify_all();
+
+    if (snapshotThread.joinable())
+    {
+        snapshotThread.join();
+    }
+
+    // 关闭前生成快照，下次启动无需重放WAL
+    if (wasRunning)
+    {
+        becomeLeader();
+        writeSnapshot();
+        resignLeader();
+        Logger::info("内存数据库已关闭");
+    }
+
+    releaseStorage();
+}
+
+void MemoryDatabase::releaseStorage()
+{
+    if (walFd >= 0)
+    {
+        ::close(walFd);
+        walFd = -1;
+    }
+
+    delete index.exchange(nullptr);
+    arena.reset();
+}
+
+bool MemoryDatabase::createStudentTable()
+{
+    return true;
+}
+
+int MemoryDatabase::addStudent(const Student &student)
+{
+    WalOp op;
+    op.type = WalOp::Insert;
+    op.student = student;
+    submit({&op});
+    return op.result ? op.id : -1;
+}
+
+bool MemoryDatabase::updateStudent(int id, const Student &student)
+{
+    WalOp op;
+    op.type = WalOp::Update;
+    op.id = id;
+    op.student = student;
+    submit({&op});
+    return op.result;
+}
+
+bool MemoryDatabase::deleteStudent(int id)
+{
+    WalOp op;
+    op.type = WalOp::Delete;
+    op.id = id;
+    submit({&op});
+    return op.result;
+}
+
+std::vector<int> MemoryDatabase::addStudents(const std::vector<Student> &students)
+{
+    std::vector<int> ids;
+    if (students.empty())
+        return ids;
+
+    std::vector<WalOp> ops(students.size());
+    std::vector<WalOp *> pending;
+    pending.reserve(ops.size());
+    for (size_t i = 0; i < students.size(); ++i)
+    {
+        ops[i].type = WalOp::Insert;
+        ops[i].student = students[i];
+        pending.push_back(&ops[i]);
+    }
+    submit(pending);
+
+    ids.reserve(ops.size());
+    for (const auto &op : ops)
+    {
+        ids.push_back(op.result ? op.id : -1);
+    }
+    return ids;
+}
+
+int MemoryDatabase::deleteStudents(const std::vector<int> &ids)
+{
+    if (ids.empty())
+        return 0;
+
+    std::vector<WalOp> ops(ids.size());
+    std::vector<WalOp *> pending;
+    pending.reserve(ops.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        ops[i].type = WalOp::Delete;
+        ops[i].id = ids[i];
+        pending.push_back(&ops[i]);
+    }
+    submit(pending);
+
+    return static_cast<int>(std::count_if(ops.begin(), ops.end(), [](const WalOp &op)
+                                          { return op.result; }));
+}
+
+Student MemoryDatabase::getStudent(int id)
+{
+    ReadDomain::Guard guard(*readDomain);
+    const IndexTable *table = index.load();
+    if (!table)
+        return Student();
+
+    const Record *record = table->find(id);
+    return record ? record->toStudent() : Student();
+}
+
+StudentBatch MemoryDatabase::getAllStudents()
+{
+    StudentBatch students;
+    {
+        ReadDomain::Guard guard(*readDomain);
+        const IndexTable *table = index.load();
+        if (!table)
+            return students;
+
+        students.reserve(static_cast<size_t>(recordCount.load()), arenaLiveBytes.load());
+        for (size_t i = 0; i < table->capacity; ++i)
+        {
+            const Record *record = table->slots[i].record.load(std::memory_order_acquire);
+            if (record)
+            {
+                students.add(record->id, record->age, std::string_view(record->name(), record->nameLength), record->classId);
+            }
+        }
+    }
+
+    students.sortById();
+    return students;
+}
+
+int MemoryDatabase::getStudentCount()
+{
+    return index.load() ? static_cast<int>(recordCount.load()) : -1;
+}
+
+long long MemoryDatabase::getMaxStudentId()
+{
+    ReadDomain::Guard guard(*readDomain);
+    const IndexTable *table = index.load();
+    if (!table)
+        return -1;
+
+    long long maxId = 0;
+    for (size_t i = 0; i < table->capacity; ++i)
+    {
+        const Record *record = table->slots[i].record.load(std::memory_order_acquire);
+        if (record && record->id > maxId)
+            maxId = record->id;
+    }
+    return maxId;
+}
+
+json MemoryDatabase::getMetrics() const
+{
+    uint64_t commits = groupCommits.load();
+    uint64_t ops = committedOps.load();
+
+    json metrics;
+    metrics["records"] = recordCount.load();
+    metrics["wal_bytes"] = walBytes.load();
+    metrics["arena_live_bytes"] = arenaLiveBytes.load();
+    metrics["arena_garbage_bytes"] = arenaGarbageBytes.load();
+    metrics["group_commits"] = commits;
+    metrics["committed_ops"] = ops;
+    metrics["avg_group_size"] = commits > 0 ? static_cast<double>(ops) / commits : 0.0;
+    return metrics;
+}
+
+void MemoryDatabase::submit(const std::vector<WalOp *> &ops)
+{
+    std::unique_lock<std::mutex> lock(commitMutex);
+    for (WalOp *op : ops)
+    {
+        if (op->type == WalOp::Insert)
+        {
+            op->id = nextId++;
+        }
+        commitQueue.push_back(op);
+    }
+
+    // 同一次提交的操作连续入队，必定落在同一批次中
+    WalOp *last = ops.back();
+    while (!last->done)
+    {
+        if (leaderActive)
+        {
+            commitCv.wait(lock);
+            continue;
+        }
+
+        // 成为leader：取走当前队列中所有操作，一次写入、一次同步
+        leaderActive = true;
+        if (groupCommitWindow.count() > 0)
+        {
+            lock.unlock();
+            std::this_thread::sleep_for(groupCommitWindow);
+            lock.lock();
+        }
+
+        std::vector<WalOp *> batch(commitQueue.begin(), commitQueue.end());
+        commitQueue.clear();
+        lock.unlock();
+
+        if (writeWal(batch))
+        {
+            for (WalOp *op : batch)
+            {
+                apply(*op);
+            }
+            publishArenaStats();
+        }
+
+        lock.lock();
+        for (WalOp *op : batch)
+        {
+            op->done = true;
+        }
+        ++groupCommits;
+        committedOps += batch.size();
+        leaderActive = false;
+        commitCv.notify_all();
+    }
+}
+
+bool MemoryDatabase::writeWal(const std::vector<WalOp *> &batch)
+{
+    if (walFd < 0 || !index.load())
+    {
+        Logger::error("内存数据库未打开");
+        return false;
+    }
+
+    std::string buffer;
+    for (const WalOp *op : batch)
+    {
+        op->encode(buffer);
+    }
+
+    if (!writeAll(walFd, buffer.data(), buffer.size()))
+    {
+        Logger::error("写入WAL失败: {}", std::strerror(errno));
+        // 丢弃写了一半的记录，避免后续追加的条目在恢复时被截断
+        truncateWal();
+        return false;
+    }
+
+    if (syncWrites && ::fdatasync(walFd) != 0)
+    {
+        Logger::error("同步WAL失败: {}", std::strerror(errno));
+        // 本批已向调用方报告失败，记录不能留在WAL中，否则恢复时会被重放
+        truncateWal();
+        return false;
+    }
+
+    walBytes += buffer.size();
+    return true;
+}
+
+void MemoryDatabase::truncateWal()
+{
+    if (::ftruncate(walFd, static_cast<off_t>(walBytes.load())) != 0)
+    {
+        Logger::error("回滚WAL失败: {}", std::strerror(errno));
+    }
+}
+
+void MemoryDatabase::apply(WalOp &op)
+{
+    switch (op.type)
+    {
+    case WalOp::Insert:
+        upsertRecord(op.id, op.student.getAge(), op.student.getName(), op.student.getClassId());
+        op.result = true;
+        break;
+    case WalOp::Update:
+        op.result = index.load()->find(op.id) != nullptr;
+        if (op.result)
+        {
+            upsertRecord(op.id, op.student.getAge(), op.student.getName(), op.student.getClassId());
+        }
+        break;
+    case WalOp::Delete:
+        op.result = eraseRecord(op.id);
+        break;
+    }
+}
+
+void MemoryDatabase::upsertRecord(int id, int age, const std::string &name, uint32_t classId)
+{
+    IndexTable *table = index.load();
+    if (table->needsRebuild())
+    {
+        // 重建后存活记录不超过一半容量，墓碑较多时仅原地清理
+        size_t capacity = table->capacity;
+        while ((table->liveCount + 1) * 2 > capacity)
+        {
+            capacity <<= 1;
+        }
+        rebuildIndex(capacity);
+        table = index.load();
+    }
+
+    const Record *record = arena->create(id, age, name, classId);
+    IndexTable::Slot &slot = table->locate(id);
+    if (slot.key.load(std::memory_order_relaxed) == 0)
+    {
+        table->publish(slot, id, record);
+        ++recordCount;
+        return;
+    }
+
+    const Record *old = slot.record.exchange(record, std::memory_order_acq_rel);
+    if (old)
+    {
+        arena->retire(old);
+    }
+    else
+    {
+        ++table->liveCount;
+        ++recordCount;
+    }
+}
+
+bool MemoryDatabase::eraseRecord(int id)
+{
+    IndexTable *table = index.load();
+    IndexTable::Slot &slot = table->locate(id);
+    if (slot.key.load(std::memory_order_relaxed) != id)
+        return false;
+
+    const Record *old = slot.record.exchange(nullptr, std::memory_order_acq_rel);
+    if (!old)
+        return false;
+
+    arena->retire(old);
+    --table->liveCount;
+    --recordCount;
+    return true;
+}
+
+void MemoryDatabase::rebuildIndex(size_t capacity)
+{
+    IndexTable *old = index.load();
+    IndexTable *table = new IndexTable(capacity);
+    for (size_t i = 0; i < old->capacity; ++i)
+    {
+        const Record *record = old->slots[i].record.load(std::memory_order_relaxed);
+        if (record)
+        {
+            table->publish(table->locate(record->id), record->id, record);
+        }
+    }
+
+    index.store(table);
+    readDomain->synchronize();
+    delete old;
+}
+
+void MemoryDatabase::compactArena()
+{
+    auto fresh = std::make_unique<RecordArena>();
+    IndexTable *old = index.load();
+    IndexTable *table = new IndexTable(old->capacity);
+    for (size_t i = 0; i < old->capacity; ++i)
+    {
+        const Record *record = old->slots[i].record.load(std::memory_order_relaxed);
+        if (record)
+        {
+            table->publish(table->locate(record->id), record->id, fresh->copy(*record));
+        }
+    }
+
+    size_t reclaimed = arena->garbage();
+    index.store(table);
+    readDomain->synchronize();
+    delete old;
+    arena = std::move(fresh);
+    publishArenaStats();
+
+    Logger::info("内存数据库记录区压缩完成，回收: {} 字节", reclaimed);
+}
+
+void MemoryDatabase::publishArenaStats()
+{
+    arenaLiveBytes = arena->live();
+    arenaGarbageBytes = arena->garbage();
+}
+
+bool MemoryDatabase::loadSnapshot()
+{
+    std::string data;
+    if (!readFile(snapshotPath, data))
+        return true;
+
+    // 头部：魔数、版本、下一个id、记录数；尾部：全文校验和
+    const char *cursor = data.data();
+    const char *end = data.data() + data.size();
+    uint32_t magic, version, storedNextId, storedChecksum;
+    uint64_t count;
+    if (data.size() < sizeof(uint32_t) ||
+        !readUint32(cursor, end, magic) || magic != kSnapshotMagic ||
+        !readUint32(cursor, end, version) || version != kSnapshotVersion ||
+        !readUint32(cursor, end, storedNextId) || !readUint64(cursor, end, count))
+    {
+        Logger::error("快照文件格式无效: {}", snapshotPath);
+        return false;
+    }
+
+    end -= sizeof(uint32_t);
+    std::memcpy(&storedChecksum, end, sizeof(storedChecksum));
+    if (cursor > end || checksum(data.data(), data.size() - sizeof(uint32_t)) != storedChecksum)
+    {
+        Logger::error("快照文件校验失败: {}", snapshotPath);
+        return false;
+    }
+
+    size_t capacity = kInitialIndexCapacity;
+    while (capacity < count * 2)
+    {
+        capacity <<= 1;
+    }
+    delete index.exchange(new IndexTable(capacity));
+
+    std::string name;
+    std::string className;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        uint32_t id, age;
+        if (!readUint32(cursor, end, id) || !readUint32(cursor, end, age) ||
+            !readString(cursor, end, name) || !readString(cursor, end, className))
+        {
+            Logger::error("快照文件记录不完整: {}", snapshotPath);
+            return false;
+        }
+        upsertRecord(static_cast<int>(id), static_cast<int>(age), name, ClassNameTable::instance().intern(className));
+    }
+
+    nextId = static_cast<int>(storedNextId);
+    Logger::info("已加载快照，记录数: {}", count);
+    return true;
+}
+
+bool MemoryDatabase::replayWal()
+{
+    std::string data;
+    if (!readFile(walPath, data))
+        return true;
+
+    size_t offset = 0;
+    long long applied = 0;
+    while (data.size() - offset >= 2 * sizeof(uint32_t))
+    {
+        const char *cursor = data.data() + offset;
+        const char *end = data.data() + data.size();
+        uint32_t length, storedChecksum;
+        readUint32(cursor, end, length);
+        readUint32(cursor, end, storedChecksum);
+        if (end - cursor < static_cast<std::ptrdiff_t>(length) || checksum(cursor, length) != storedChecksum)
+            break;
+
+        WalOp op;
+        if (!op.decode(cursor, cursor + length))
+            break;
+
+        if (op.type == WalOp::Insert)
+        {
+            nextId = std::max(nextId, op.id + 1);
+        }
+        apply(op);
+
+        offset += 2 * sizeof(uint32_t) + length;
+        ++applied;
+    }
+
+    // 崩溃时最后一批可能只写了一部分，截断到最后一条完整记录
+    if (offset < data.size())
+    {
+        Logger::warn("WAL尾部存在不完整记录，截断 {} 字节", data.size() - offset);
+        if (::truncate(walPath.c_str(), static_cast<off_t>(offset)) != 0)
+        {
+            Logger::error("截断WAL失败: {}", std::strerror(errno));
+            return false;
+        }
+    }
+
+    walBytes = offset;
+    if (applied > 0)
+    {
+        Logger::info("WAL重放完成，应用 {} 条记录", applied);
+    }
+    return true;
+}
+
+bool MemoryDatabase::writeSnapshot()
+{
+    IndexTable *table = index.load();
+    if (!table || walFd < 0)
+        return false;
+
+    std::string tempPath = snapshotPath + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        Logger::error("无法创建快照文件 {}: {}", tempPath, std::strerror(errno));
+        return false;
+    }
+
+    std::string buffer;
+    appendUint32(buffer, kSnapshotMagic);
+    appendUint32(buffer, kSnapshotVersion);
+    {
+        std::lock_guard<std::mutex> lock(commitMutex);
+        appendUint32(buffer, static_cast<uint32_t>(nextId));
+    }
+    appendUint64(buffer, table->liveCount);
+
+    uint32_t hash = kChecksumSeed;
+    bool ok = true;
+    auto flush = [&]()
+    {
+        hash = checksum(buffer.data(), buffer.size(), hash);
+        ok = ok && writeAll(fd, buffer.data(), buffer.size());
+        buffer.clear();
+    };
+
+    for (size_t i = 0; i < table->capacity && ok; ++i)
+    {
+        const Record *record = table->slots[i].record.load(std::memory_order_relaxed);
+        if (!record)
+            continue;
+
+        appendUint32(buffer, static_cast<uint32_t>(record->id));
+        appendUint32(buffer, static_cast<uint32_t>(record->age));
+        appendString(buffer, record->name(), record->nameLength);
+        const std::string &className = record->className();
+        appendString(buffer, className.data(), static_cast<uint32_t>(className.size()));
+        if (buffer.size() >= kSnapshotWriteBuffer)
+        {
+            flush();
+        }
+    }
+    flush();
+
+    ok = ok && writeAll(fd, reinterpret_cast<const char *>(&hash), sizeof(hash)) && ::fsync(fd) == 0;
+    ::close(fd);
+
+    if (!ok || std::rename(tempPath.c_str(), snapshotPath.c_str()) != 0)
+    {
+        Logger::error("写入快照失败: {}", std::strerror(errno));
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    syncDirectory(snapshotPath);
+
+    // 快照已包含全部已提交操作，WAL可清空
+    if (::ftruncate(walFd, 0) != 0)
+    {
+        Logger::error("截断WAL失败: {}", std::strerror(errno));
+        return true;
+    }
+    walBytes = 0;
+
+    Logger::info("内存数据库快照完成，记录数: {}", table->liveCount);
+    return true;
+}
+
+void MemoryDatabase::snapshotLoop()
+{
+    std::unique_lock<std::mutex> lock(snapshotMutex);
+    while (running)
+    {
+        snapshotCv.wait_for(lock, snapshotInterval, [this]()
+                            { return !running; });
+        if (!running)
+            break;
+
+        lock.unlock();
+        becomeLeader();
+        if (walBytes.load() > 0)
+        {
+            writeSnapshot();
+        }
+        // 垃圾超过存活数据时压缩记录区
+        if (arena->garbage() > kArenaChunkSize && arena->garbage() > arena->live())
+        {
+            compactArena();
+        }
+        resignLeader();
+        lock.lock();
+    }
+}
+
+void MemoryDatabase::becomeLeader()
+{
+    std::unique_lock<std::mutex> lock(commitMutex);
+    commitCv.wait(lock, [this]()
+                  { return !leaderActive; });
+    leaderActive = true;
+}
+
+void MemoryDatabase::resignLeader()
+{
+    {
+        std::lock_guard<std::mutex> lock(commitMutex);
+        leaderActive = false;
+    }
+    commitCv.notify_all();
+}
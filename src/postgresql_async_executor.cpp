@@ -0,0 +1,625 @@
+#include "postgresql_async_executor.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include "logger.h"
+
+namespace
+{
+    const int kMaxEvents = 64;
+    const int kLoopTickMs = 1000;
+    const int kReconnectIntervalMs = 1000;
+    const int kConnectTimeoutMs = 10000;
+}
+
+PostgreSQLAsyncExecutor::PostgreSQLAsyncExecutor(const std::string &connectionString, size_t connectionCount)
+    : connectionString(connectionString), connectionCount(connectionCount > 0 ? connectionCount : 1),
+      epollFd(-1), wakeFd(-1), running(false), inFlightCount(0)
+{
+}
+
+PostgreSQLAsyncExecutor::~PostgreSQLAsyncExecutor()
+{
+    stop();
+}
+
+void PostgreSQLAsyncExecutor::prepare(const std::string &name, const std::string &sql)
+{
+    statements.emplace_back(name, sql);
+}
+
+bool PostgreSQLAsyncExecutor::start()
+{
+    if (running)
+        return true;
+
+#ifndef LIBPQ_HAS_PIPELINING
+    Logger::error("当前libpq不支持pipeline模式，无法启动异步执行器");
+    return false;
+#else
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0)
+    {
+        Logger::error("创建epoll/eventfd失败: {}", std::strerror(errno));
+        stop();
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    for (size_t i = 0; i < connectionCount; ++i)
+    {
+        auto connection = std::make_unique<Connection>();
+        if (!openConnection(*connection))
+        {
+            connections.push_back(std::move(connection));
+            stop();
+            return false;
+        }
+        connections.push_back(std::move(connection));
+    }
+
+    running = true;
+    loopThread = std::thread(&PostgreSQLAsyncExecutor::eventLoop, this);
+
+    Logger::info("PostgreSQL异步执行器启动，连接数: {}", connectionCount);
+    return true;
+#endif
+}
+
+void PostgreSQLAsyncExecutor::stop()
+{
+    if (running.exchange(false))
+    {
+        uint64_t one = 1;
+        ssize_t written = write(wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+
+    if (loopThread.joinable())
+    {
+        loopThread.join();
+    }
+
+    // 未完成的请求全部以失败结束
+    std::deque<Request> remaining;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        remaining.swap(queue);
+    }
+    for (auto &request : remaining)
+    {
+        --inFlightCount;
+        if (request.callback)
+            request.callback(nullptr);
+    }
+
+    for (auto &connection : connections)
+    {
+        failAll(*connection);
+        closeConnection(*connection);
+    }
+    connections.clear();
+
+    if (wakeFd >= 0)
+    {
+        ::close(wakeFd);
+        wakeFd = -1;
+    }
+    if (epollFd >= 0)
+    {
+        ::close(epollFd);
+        epollFd = -1;
+    }
+}
+
+bool PostgreSQLAsyncExecutor::submit(const std::string &statementName, std::vector<std::string> params, ResultCallback callback)
+{
+    if (!running)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back({statementName, std::move(params), std::move(callback)});
+    }
+    ++inFlightCount;
+
+    // 唤醒事件循环
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;
+    return true;
+}
+
+bool PostgreSQLAsyncExecutor::openConnection(Connection &connection)
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    PGconn *conn = PQconnectdb(connectionString.c_str());
+    if (PQstatus(conn) != CONNECTION_OK)
+    {
+        Logger::error("异步执行器PostgreSQL连接失败: {}", PQerrorMessage(conn));
+        PQfinish(conn);
+        return false;
+    }
+
+    // 在阻塞模式下预编译语句
+    for (const auto &statement : statements)
+    {
+        PGresult *result = PQprepare(conn, statement.first.c_str(), statement.second.c_str(), 0, nullptr);
+        bool ok = PQresultStatus(result) == PGRES_COMMAND_OK;
+        if (!ok)
+        {
+            Logger::error("预编译语句 {} 失败: {}", statement.first, PQresultErrorMessage(result));
+        }
+        PQclear(result);
+        if (!ok)
+        {
+            PQfinish(conn);
+            return false;
+        }
+    }
+
+    if (PQsetnonblocking(conn, 1) != 0 || PQenterPipelineMode(conn) != 1)
+    {
+        Logger::error("设置非阻塞pipeline模式失败: {}", PQerrorMessage(conn));
+        PQfinish(conn);
+        return false;
+    }
+
+    connection.conn = conn;
+    connection.socket = PQsocket(conn);
+    connection.writeWatched = false;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = &connection;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, connection.socket, &event) != 0)
+    {
+        Logger::error("注册PostgreSQL套接字失败: {}", std::strerror(errno));
+        closeConnection(connection);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PostgreSQLAsyncExecutor::closeConnection(Connection &connection)
+{
+    if (!connection.conn)
+        return;
+
+    if (epollFd >= 0 && connection.socket >= 0)
+    {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, connection.socket, nullptr);
+    }
+    PQfinish(connection.conn);
+    connection.conn = nullptr;
+    connection.socket = -1;
+    connection.writeWatched = false;
+    connection.connecting = false;
+    connection.broken = false;
+}
+
+void PostgreSQLAsyncExecutor::reconnect(Connection &connection)
+{
+    failAll(connection);
+    closeConnection(connection);
+    beginConnect(connection);
+}
+
+void PostgreSQLAsyncExecutor::beginConnect(Connection &connection)
+{
+    PGconn *conn = PQconnectStart(connectionString.c_str());
+    if (!conn || PQstatus(conn) == CONNECTION_BAD)
+    {
+        Logger::warn("异步执行器发起重连失败: {}", conn ? PQerrorMessage(conn) : "内存不足");
+        PQfinish(conn);
+        retryLater(connection);
+        return;
+    }
+
+    connection.conn = conn;
+    connection.connecting = true;
+    connection.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kConnectTimeoutMs);
+
+    // 握手从写套接字开始
+    if (!watchSocket(connection, EPOLLOUT))
+    {
+        closeConnection(connection);
+        retryLater(connection);
+    }
+}
+
+void PostgreSQLAsyncExecutor::advanceConnect(Connection &connection)
+{
+    PostgresPollingStatusType status = PQconnectPoll(connection.conn);
+    if (status == PGRES_POLLING_FAILED)
+    {
+        Logger::warn("异步执行器重连失败，{}ms后重试: {}", kReconnectIntervalMs, PQerrorMessage(connection.conn));
+        closeConnection(connection);
+        retryLater(connection);
+        return;
+    }
+
+    bool ok = status == PGRES_POLLING_OK
+                  ? finishConnect(connection)
+                  : watchSocket(connection, status == PGRES_POLLING_READING ? EPOLLIN : EPOLLOUT);
+    if (!ok)
+    {
+        closeConnection(connection);
+        retryLater(connection);
+    }
+}
+
+bool PostgreSQLAsyncExecutor::finishConnect(Connection &connection)
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    if (PQsetnonblocking(connection.conn, 1) != 0 || PQenterPipelineMode(connection.conn) != 1)
+    {
+        Logger::error("设置非阻塞pipeline模式失败: {}", PQerrorMessage(connection.conn));
+        return false;
+    }
+    connection.connecting = false;
+    if (!watchSocket(connection, EPOLLIN))
+        return false;
+
+    // 预编译语句与普通请求一样排入pipeline，随后分发的查询在服务端按序执行于其后
+    for (const auto &statement : statements)
+    {
+        if (PQsendPrepare(connection.conn, statement.first.c_str(), statement.second.c_str(), 0, nullptr) != 1 ||
+            PQpipelineSync(connection.conn) != 1)
+        {
+            Logger::error("预编译语句 {} 发送失败: {}", statement.first, PQerrorMessage(connection.conn));
+            failAll(connection);
+            return false;
+        }
+
+        Pending pending;
+        pending.callback = [&connection](PGresult *result)
+        {
+            if (!result)
+                connection.broken = true;
+        };
+        connection.pending.push_back(std::move(pending));
+        ++inFlightCount;
+    }
+
+    Logger::info("异步执行器连接已恢复");
+    flush(connection);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PostgreSQLAsyncExecutor::retryLater(Connection &connection)
+{
+    connection.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kReconnectIntervalMs);
+}
+
+void PostgreSQLAsyncExecutor::maintainConnections()
+{
+    auto now = std::chrono::steady_clock::now();
+    for (auto &connection : connections)
+    {
+        if (!connection->conn && now >= connection->deadline)
+        {
+            beginConnect(*connection);
+        }
+        else if (connection->connecting && now >= connection->deadline)
+        {
+            Logger::warn("异步执行器连接握手超时，{}ms后重试", kReconnectIntervalMs);
+            closeConnection(*connection);
+            retryLater(*connection);
+        }
+    }
+}
+
+bool PostgreSQLAsyncExecutor::watchSocket(Connection &connection, uint32_t events)
+{
+    // 握手过程中libpq可能关闭旧套接字另建新的，旧套接字关闭时已自动移出epoll
+    int socket = PQsocket(connection.conn);
+    if (socket < 0)
+    {
+        Logger::error("PostgreSQL连接套接字无效: {}", PQerrorMessage(connection.conn));
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = events;
+    event.data.ptr = &connection;
+    int op = socket == connection.socket ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(epollFd, op, socket, &event) != 0 &&
+        epoll_ctl(epollFd, op == EPOLL_CTL_MOD ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, socket, &event) != 0)
+    {
+        Logger::error("注册PostgreSQL套接字失败: {}", std::strerror(errno));
+        return false;
+    }
+    connection.socket = socket;
+    connection.writeWatched = (events & EPOLLOUT) != 0;
+    return true;
+}
+
+void PostgreSQLAsyncExecutor::eventLoop()
+{
+    epoll_event events[kMaxEvents];
+
+    while (running)
+    {
+        int count = epoll_wait(epollFd, events, kMaxEvents, kLoopTickMs);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            Logger::error("epoll_wait失败: {}", std::strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            if (events[i].data.ptr == nullptr)
+            {
+                uint64_t value;
+                while (read(wakeFd, &value, sizeof(value)) > 0)
+                {
+                }
+                continue;
+            }
+
+            Connection &connection = *static_cast<Connection *>(events[i].data.ptr);
+            if (!connection.conn)
+                continue;
+
+            if (connection.connecting)
+            {
+                advanceConnect(connection);
+                continue;
+            }
+
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+            {
+                handleReadable(connection);
+            }
+            if (connection.conn && (events[i].events & EPOLLOUT))
+            {
+                flush(connection);
+            }
+        }
+
+        // 与事件数无关，每轮检查重连时间与握手超时；epoll_wait最多等待一个tick
+        maintainConnections();
+        dispatchQueued();
+    }
+}
+
+void PostgreSQLAsyncExecutor::dispatchQueued()
+{
+    std::deque<Request> batch;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        batch.swap(queue);
+    }
+
+    for (auto &request : batch)
+    {
+        // 选择在途查询最少的可用连接
+        Connection *target = nullptr;
+        for (auto &connection : connections)
+        {
+            if (connection->conn && !connection->connecting &&
+                (!target || connection->pending.size() < target->pending.size()))
+            {
+                target = connection.get();
+            }
+        }
+
+        if (!target)
+        {
+            Logger::error("异步执行器无可用连接");
+            --inFlightCount;
+            if (request.callback)
+                request.callback(nullptr);
+            continue;
+        }
+
+        dispatch(*target, request);
+    }
+
+    for (auto &connection : connections)
+    {
+        if (connection->conn && !connection->connecting && !connection->pending.empty())
+        {
+            flush(*connection);
+        }
+    }
+}
+
+void PostgreSQLAsyncExecutor::dispatch(Connection &connection, Request &request)
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    std::vector<const char *> paramValues;
+    paramValues.reserve(request.params.size());
+    for (const auto &param : request.params)
+    {
+        paramValues.push_back(param.c_str());
+    }
+
+    if (PQsendQueryPrepared(connection.conn, request.statementName.c_str(), paramValues.size(),
+                            paramValues.empty() ? nullptr : paramValues.data(), nullptr, nullptr, 0) != 1 ||
+        PQpipelineSync(connection.conn) != 1)
+    {
+        Logger::error("异步发送查询失败: {}", PQerrorMessage(connection.conn));
+        --inFlightCount;
+        if (request.callback)
+            request.callback(nullptr);
+        reconnect(connection);
+        return;
+    }
+
+    Pending pending;
+    pending.callback = std::move(request.callback);
+    connection.pending.push_back(std::move(pending));
+#endif
+}
+
+void PostgreSQLAsyncExecutor::flush(Connection &connection)
+{
+    int rc = PQflush(connection.conn);
+    if (rc < 0)
+    {
+        Logger::error("PostgreSQL发送缓冲刷新失败: {}", PQerrorMessage(connection.conn));
+        reconnect(connection);
+        return;
+    }
+
+    // 仍有数据未发出时监听可写事件
+    updateWatch(connection, rc == 1);
+}
+
+void PostgreSQLAsyncExecutor::handleReadable(Connection &connection)
+{
+    if (PQconsumeInput(connection.conn) != 1)
+    {
+        Logger::error("PostgreSQL读取结果失败: {}", PQerrorMessage(connection.conn));
+        reconnect(connection);
+        return;
+    }
+
+    // 丢弃异步通知
+    while (PGnotify *notify = PQnotifies(connection.conn))
+    {
+        PQfreemem(notify);
+    }
+
+    processResults(connection);
+
+    if (connection.broken)
+    {
+        Logger::error("异步执行器连接预编译语句失败，重新连接");
+        reconnect(connection);
+        return;
+    }
+
+    if (connection.conn && connection.writeWatched)
+    {
+        flush(connection);
+    }
+}
+
+void PostgreSQLAsyncExecutor::processResults(Connection &connection)
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    // 每个请求的结果序列为：结果... nullptr PGRES_PIPELINE_SYNC
+    while (!connection.pending.empty() && !PQisBusy(connection.conn))
+    {
+        PGresult *result = PQgetResult(connection.conn);
+        Pending &front = connection.pending.front();
+
+        if (front.awaitingSync)
+        {
+            if (!result)
+                break;
+
+            ExecStatusType status = PQresultStatus(result);
+            PQclear(result);
+            if (status == PGRES_PIPELINE_SYNC)
+            {
+                connection.pending.pop_front();
+            }
+            continue;
+        }
+
+        if (!result)
+        {
+            complete(front);
+            front.awaitingSync = true;
+            continue;
+        }
+
+        if (front.result == nullptr)
+        {
+            front.result = result;
+        }
+        else
+        {
+            PQclear(result);
+        }
+    }
+#endif
+}
+
+void PostgreSQLAsyncExecutor::complete(Pending &pending)
+{
+    PGresult *result = pending.result;
+    pending.result = nullptr;
+
+    if (result && PQresultStatus(result) != PGRES_COMMAND_OK && PQresultStatus(result) != PGRES_TUPLES_OK)
+    {
+        Logger::error("异步SQL执行错误: {}", PQresultErrorMessage(result));
+        PQclear(result);
+        result = nullptr;
+    }
+
+    ResultCallback callback = std::move(pending.callback);
+    pending.callback = nullptr;
+    --inFlightCount;
+
+    if (callback)
+    {
+        try
+        {
+            callback(result);
+        }
+        catch (const std::exception &e)
+        {
+            Logger::error("异步查询回调异常: {}", e.what());
+        }
+    }
+
+    if (result)
+    {
+        PQclear(result);
+    }
+}
+
+void PostgreSQLAsyncExecutor::failAll(Connection &connection)
+{
+    for (auto &pending : connection.pending)
+    {
+        if (pending.awaitingSync)
+            continue;
+
+        if (pending.result)
+        {
+            PQclear(pending.result);
+            pending.result = nullptr;
+        }
+        complete(pending);
+    }
+    connection.pending.clear();
+}
+
+void PostgreSQLAsyncExecutor::updateWatch(Connection &connection, bool watchWrite)
+{
+    if (connection.writeWatched == watchWrite)
+        return;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    if (watchWrite)
+    {
+        event.events |= EPOLLOUT;
+    }
+    event.data.ptr = &connection;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.socket, &event);
+    connection.writeWatched = watchWrite;
+}
@@ -0,0 +1,359 @@
+#include "postgresql_connection_pool.h"
+#include <vector>
+#include <algorithm>
+#include "logger.h"
+
+PostgreSQLConnectionPool::PostgreSQLConnectionPool(const Options &options)
+    : options(options), total(0), waiters(0), running(false),
+      acquiredCount(0), timeoutCount(0), createdCount(0), retiredCount(0),
+      totalWaitMs(0.0), maxWaitMs(0.0)
+{
+    if (this->options.maxSize == 0)
+    {
+        this->options.maxSize = 1;
+    }
+    if (this->options.minSize > this->options.maxSize)
+    {
+        this->options.minSize = this->options.maxSize;
+    }
+}
+
+PostgreSQLConnectionPool::~PostgreSQLConnectionPool()
+{
+    stop();
+}
+
+bool PostgreSQLConnectionPool::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running)
+            return true;
+        running = true;
+    }
+
+    // 预先建立最小连接数
+    for (size_t i = 0; i < options.minSize; ++i)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++total;
+        }
+
+        PGconn *conn = createConnection();
+        if (!conn)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --total;
+            }
+            stop();
+            return false;
+        }
+        release(conn);
+    }
+
+    if (options.healthCheckInterval.count() > 0)
+    {
+        healthThread = std::thread(&PostgreSQLConnectionPool::healthCheckLoop, this);
+    }
+
+    Logger::info("PostgreSQL连接池启动，最小: {}，最大: {}", options.minSize, options.maxSize);
+    return true;
+}
+
+void PostgreSQLConnectionPool::stop()
+{
+    std::deque<IdleConnection> toClose;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running)
+            return;
+        running = false;
+        toClose.swap(idle);
+    }
+
+    available.notify_all();
+    healthCv.notify_all();
+    if (healthThread.joinable())
+    {
+        healthThread.join();
+    }
+
+    for (const auto &item : toClose)
+    {
+        retire(item.conn);
+    }
+}
+
+PGconn *PostgreSQLConnectionPool::acquire()
+{
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + options.acquireTimeout;
+
+    auto recordWait = [this, start]()
+    {
+        double waitMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        ++acquiredCount;
+        totalWaitMs += waitMs;
+        maxWaitMs = std::max(maxWaitMs, waitMs);
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        if (!running)
+        {
+            Logger::error("PostgreSQL连接池未启动");
+            return nullptr;
+        }
+
+        // 优先复用最近归还的空闲连接
+        if (!idle.empty())
+        {
+            PGconn *conn = idle.back().conn;
+            idle.pop_back();
+            bool expired = isExpired(conn, Clock::now());
+            lock.unlock();
+
+            if (expired || !isHealthy(conn))
+            {
+                retire(conn);
+                lock.lock();
+                continue;
+            }
+
+            lock.lock();
+            recordWait();
+            return conn;
+        }
+
+        // 未达上限时在锁外新建连接
+        if (total < options.maxSize)
+        {
+            ++total;
+            lock.unlock();
+            PGconn *conn = createConnection();
+            lock.lock();
+
+            if (!conn)
+            {
+                --total;
+                available.notify_one();
+                return nullptr;
+            }
+
+            recordWait();
+            return conn;
+        }
+
+        // 连接池已满，等待归还
+        ++waiters;
+        bool signalled = available.wait_until(lock, deadline, [this]()
+                                              { return !running || !idle.empty() || total < options.maxSize; });
+        --waiters;
+
+        if (!signalled)
+        {
+            ++timeoutCount;
+            Logger::warn("获取PostgreSQL连接超时，等待: {}ms", options.acquireTimeout.count());
+            return nullptr;
+        }
+    }
+}
+
+void PostgreSQLConnectionPool::release(PGconn *conn)
+{
+    if (!conn)
+        return;
+
+    // 连接断开或仍处于事务/pipeline中时不再复用
+    bool broken = PQstatus(conn) != CONNECTION_OK || PQtransactionStatus(conn) != PQTRANS_IDLE;
+#ifdef LIBPQ_HAS_PIPELINING
+    broken = broken || PQpipelineStatus(conn) != PQ_PIPELINE_OFF;
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Clock::time_point now = Clock::now();
+        if (running && !broken && !isExpired(conn, now))
+        {
+            idle.push_back({conn, now});
+            available.notify_one();
+            return;
+        }
+    }
+
+    retire(conn);
+}
+
+void PostgreSQLConnectionPool::discard(PGconn *conn)
+{
+    if (!conn)
+        return;
+
+    retire(conn);
+}
+
+PostgreSQLConnectionPool::Stats PostgreSQLConnectionPool::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Stats stats;
+    stats.total = total;
+    stats.idle = idle.size();
+    stats.inUse = total - idle.size();
+    stats.waiters = waiters;
+    stats.acquired = acquiredCount;
+    stats.timeouts = timeoutCount;
+    stats.created = createdCount;
+    stats.retired = retiredCount;
+    stats.avgWaitMs = acquiredCount > 0 ? totalWaitMs / acquiredCount : 0.0;
+    stats.maxWaitMs = maxWaitMs;
+    return stats;
+}
+
+PGconn *PostgreSQLConnectionPool::createConnection()
+{
+    PGconn *conn = PQconnectdb(options.connectionString.c_str());
+    if (PQstatus(conn) != CONNECTION_OK)
+    {
+        Logger::error("PostgreSQL连接失败: {}", PQerrorMessage(conn));
+        PQfinish(conn);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    createdAt[conn] = Clock::now();
+    ++createdCount;
+    return conn;
+}
+
+void PostgreSQLConnectionPool::retire(PGconn *conn)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        createdAt.erase(conn);
+        --total;
+        ++retiredCount;
+    }
+
+    PQfinish(conn);
+    available.notify_one();
+}
+
+bool PostgreSQLConnectionPool::isExpired(PGconn *conn, Clock::time_point now) const
+{
+    if (options.maxLifetime.count() <= 0)
+        return false;
+
+    auto it = createdAt.find(conn);
+    return it != createdAt.end() && now - it->second >= options.maxLifetime;
+}
+
+bool PostgreSQLConnectionPool::isHealthy(PGconn *conn) const
+{
+    if (PQstatus(conn) == CONNECTION_OK)
+        return true;
+
+    Logger::warn("PostgreSQL连接已断开，尝试重置");
+    PQreset(conn);
+    return PQstatus(conn) == CONNECTION_OK;
+}
+
+void PostgreSQLConnectionPool::healthCheckLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running)
+    {
+        healthCv.wait_for(lock, options.healthCheckInterval, [this]()
+                          { return !running; });
+        if (!running)
+            break;
+
+        lock.unlock();
+        runHealthCheck();
+        lock.lock();
+    }
+}
+
+void PostgreSQLConnectionPool::runHealthCheck()
+{
+    // 取出过期连接和空闲超过检查间隔的连接，在锁外处理
+    std::vector<PGconn *> expired;
+    std::vector<PGconn *> toCheck;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Clock::time_point now = Clock::now();
+        for (auto it = idle.begin(); it != idle.end();)
+        {
+            if (isExpired(it->conn, now))
+            {
+                expired.push_back(it->conn);
+                it = idle.erase(it);
+            }
+            else if (now - it->idleSince >= options.healthCheckInterval)
+            {
+                toCheck.push_back(it->conn);
+                it = idle.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    for (PGconn *conn : expired)
+    {
+        retire(conn);
+    }
+
+    for (PGconn *conn : toCheck)
+    {
+        PGresult *result = PQexec(conn, "SELECT 1;");
+        bool ok = result && PQresultStatus(result) == PGRES_TUPLES_OK;
+        PQclear(result);
+
+        if (!ok)
+        {
+            Logger::warn("PostgreSQL连接健康检查失败，尝试重置: {}", PQerrorMessage(conn));
+            PQreset(conn);
+            ok = PQstatus(conn) == CONNECTION_OK;
+        }
+
+        if (ok)
+        {
+            release(conn);
+        }
+        else
+        {
+            retire(conn);
+        }
+    }
+
+    // 补足最小连接数
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running || total >= options.minSize)
+                break;
+            ++total;
+        }
+
+        PGconn *conn = createConnection();
+        if (!conn)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --total;
+            break;
+        }
+        release(conn);
+    }
+
+    if (!expired.empty() || !toCheck.empty())
+    {
+        Logger::debug("PostgreSQL连接池健康检查完成，回收: {}，检查: {}", expired.size(), toCheck.size());
+    }
+}
@@ -2,12 +2,250 @@
 #include <libpq-fe.h>
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
 #include "logger.h"
 
+namespace
+{
+    // 单次pipeline同步点之间的最大语句数，避免输出缓冲无限增长
+    const size_t kPipelineBatchSize = 1000;
+
+    // 每个副本保留的延迟样本数
+    const size_t kLatencyWindow = 256;
+    // 按类型统计延迟的只读查询种类数（见ReadKind）
+    const size_t kReadKinds = 3;
+
+    // 变更通知频道及服务实例application_name前缀
+    const char *kChangeChannel = "students_changed";
+    const std::string kInstancePrefix = "huangh-cpp";
+
+    // COPY二进制格式文件头：签名、标志位、扩展区长度
+    const char kCopyBinarySignature[] = "PGCOPY\n\377\r\n";
+    const size_t kCopySignatureSize = 11;
+    const size_t kCopyHeaderSize = kCopySignatureSize + 8;
+
+    // 导入时每累积这么多字节发送一次PQputCopyData
+    const size_t kCopyBufferSize = 64 * 1024;
+
+    void appendInt16(std::string &buffer, int16_t value)
+    {
+        uint16_t network = htons(static_cast<uint16_t>(value));
+        buffer.append(reinterpret_cast<const char *>(&network), sizeof(network));
+    }
+
+    void appendInt32(std::string &buffer, int32_t value)
+    {
+        uint32_t network = htonl(static_cast<uint32_t>(value));
+        buffer.append(reinterpret_cast<const char *>(&network), sizeof(network));
+    }
+
+    void appendField(std::string &buffer, const std::string &value)
+    {
+        appendInt32(buffer, static_cast<int32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    int32_t readInt32(const char *data)
+    {
+        uint32_t network;
+        std::memcpy(&network, data, sizeof(network));
+        return static_cast<int32_t>(ntohl(network));
+    }
+
+    int16_t readInt16(const char *data)
+    {
+        uint16_t network;
+        std::memcpy(&network, data, sizeof(network));
+        return static_cast<int16_t>(ntohs(network));
+    }
+
+    // 本实例标识：前缀-主机名-进程号（application_name最长63字节）
+    std::string makeInstanceName()
+    {
+        char hostname[256] = {0};
+        gethostname(hostname, sizeof(hostname) - 1);
+        std::string name = kInstancePrefix + "-" + hostname + "-" + std::to_string(getpid());
+        return name.substr(0, 63);
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool sendQuery(PGconn *conn, const std::string &sql, const std::vector<std::string> &params)
+    {
+        std::vector<const char *> paramValues;
+        paramValues.reserve(params.size());
+        for (const auto &param : params)
+        {
+            paramValues.push_back(param.c_str());
+        }
+
+        if (PQsendQueryParams(conn, sql.c_str(), params.size(), nullptr,
+                              paramValues.empty() ? nullptr : paramValues.data(), nullptr, nullptr, 0) != 1)
+        {
+            Logger::error("发送SQL失败: {}", PQerrorMessage(conn));
+            return false;
+        }
+        return true;
+    }
+
+    // 读取一条查询的全部结果，保留第一个成功结果
+    PGresult *collectResult(PGconn *conn)
+    {
+        PGresult *kept = nullptr;
+        while (PGresult *result = PQgetResult(conn))
+        {
+            ExecStatusType status = PQresultStatus(result);
+            if (!kept && (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK))
+            {
+                kept = result;
+                continue;
+            }
+            if (status == PGRES_FATAL_ERROR)
+            {
+                Logger::error("SQL执行错误: {}", PQresultErrorMessage(result));
+            }
+            PQclear(result);
+        }
+        return kept;
+    }
+
+    // 取消进行中的查询并丢弃其结果，使连接可归还连接池
+    void cancelAndDrain(PGconn *conn)
+    {
+        PGcancel *cancel = PQgetCancel(conn);
+        if (cancel)
+        {
+            char errbuf[256];
+            PQcancel(cancel, errbuf, sizeof(errbuf));
+            PQfreeCancel(cancel);
+        }
+        while (PGresult *result = PQgetResult(conn))
+        {
+            PQclear(result);
+        }
+    }
+
+    // 等待任一连接的结果就绪，返回其下标；超时返回-1
+    int waitForResult(const std::vector<PGconn *> &conns, std::chrono::milliseconds timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::vector<pollfd> fds(conns.size());
+
+        while (true)
+        {
+            for (size_t i = 0; i < conns.size(); ++i)
+            {
+                // 读取失败时交给collectResult处理错误
+                if (PQconsumeInput(conns[i]) != 1 || !PQisBusy(conns[i]))
+                {
+                    return static_cast<int>(i);
+                }
+                fds[i].fd = PQsocket(conns[i]);
+                fds[i].events = POLLIN;
+                fds[i].revents = 0;
+            }
+
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0)
+            {
+                return -1;
+            }
+
+            if (poll(fds.data(), fds.size(), static_cast<int>(remaining.count())) < 0 && errno != EINTR)
+            {
+                return -1;
+            }
+        }
+    }
+
+    // 将 (id, name, age, className) 结果集转换为批量结果，按结果规模一次性预留
+    StudentBatch batchFromResult(PGresult *result)
+    {
+        StudentBatch students;
+        int numRows = PQntuples(result);
+        size_t textBytes = 0;
+        for (int i = 0; i < numRows; ++i)
+        {
+            textBytes += static_cast<size_t>(PQgetlength(result, i, 1)) + static_cast<size_t>(PQgetlength(result, i, 3));
+        }
+
+        students.reserve(static_cast<size_t>(numRows), textBytes);
+        for (int i = 0; i < numRows; ++i)
+        {
+            students.add(std::stoi(PQgetvalue(result, i, 0)), std::stoi(PQgetvalue(result, i, 2)),
+                         std::string_view(PQgetvalue(result, i, 1), PQgetlength(result, i, 1)),
+                         std::string_view(PQgetvalue(result, i, 3), PQgetlength(result, i, 3)));
+        }
+        return students;
+    }
+}
+
+// 只读副本：独立连接池、在途请求数与最近延迟样本。
+// 点查、扫描与计数的延迟相差数个数量级，按查询类型分别统计，对冲阈值取同类查询的p95
+struct PostgreSQLDatabase::Replica
+{
+    std::string name;
+    std::unique_ptr<PostgreSQLConnectionPool> pool;
+    std::atomic<int> outstanding{0};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> hedges{0};
+    std::atomic<uint64_t> hedgeWins{0};
+
+    struct LatencyWindow
+    {
+        std::vector<double> samples;
+        size_t next = 0;
+        double p95Ms = 0.0;
+    };
+
+    std::mutex latencyMutex;
+    LatencyWindow latency[kReadKinds];
+
+    void recordLatency(ReadKind kind, double ms)
+    {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        LatencyWindow &window = latency[static_cast<size_t>(kind)];
+        if (window.samples.size() < kLatencyWindow)
+        {
+            window.samples.push_back(ms);
+        }
+        else
+        {
+            window.samples[window.next] = ms;
+        }
+        window.next = (window.next + 1) % kLatencyWindow;
+
+        // 每16个样本重新计算一次p95
+        if (window.next % 16 == 0)
+        {
+            std::vector<double> sorted = window.samples;
+            size_t index = sorted.size() * 95 / 100;
+            std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+            window.p95Ms = sorted[index];
+        }
+    }
+
+    double p95(ReadKind kind)
+    {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        return latency[static_cast<size_t>(kind)].p95Ms;
+    }
+};
+
 PostgreSQLDatabase::PostgreSQLDatabase(const ConfigManager &configManager)
-    : configManager(&configManager)
+    : hedgedReads(false), hedgeMinDelay(5), cancelRunning(false),
+      instanceName(makeInstanceName()), listening(false), configManager(&configManager)
 {
-    connectionPool = std::make_shared<ConnectionPool>();
 }
 
 PostgreSQLDatabase::~PostgreSQLDatabase()
@@ -15,6 +253,32 @@ PostgreSQLDatabase::~PostgreSQLDatabase()
     close();
 }
 
+std::string PostgreSQLDatabase::buildConnectionString() const
+{
+    std::stringstream connStr;
+    connStr << "host=" << configManager->getPostgresqlHost()
+            << " port=" << configManager->getPostgresqlPort()
+            << " dbname=" << configManager->getPostgresqlDatabase()
+            << " user=" << configManager->getPostgresqlUsername()
+            << " password=" << configManager->getPostgresqlPassword()
+            << " connect_timeout=" << configManager->getPostgresqlConnectionTimeout()
+            << " application_name=" << instanceName;
+    return connStr.str();
+}
+
+std::string PostgreSQLDatabase::buildConnectionString(const PostgresqlReplicaConfig &endpoint) const
+{
+    std::stringstream connStr;
+    connStr << "host=" << endpoint.host
+            << " port=" << endpoint.port
+            << " dbname=" << endpoint.database
+            << " user=" << endpoint.username
+            << " password=" << endpoint.password
+            << " connect_timeout=" << configManager->getPostgresqlConnectionTimeout()
+            << " application_name=" << instanceName;
+    return connStr.str();
+}
+
 bool PostgreSQLDatabase::createConnectionPool()
 {
     if (!configManager)
@@ -23,72 +287,335 @@ bool PostgreSQLDatabase::createConnectionPool()
         return false;
     }
 
-    // 构建连接字符串
-    std::stringstream connStr;
-    connStr << "host=" << configManager->getPostgresqlHost()
-            << " port=" << configManager->getPostgresqlPort()
-            << " dbname=" << configManager->getPostgresqlDatabase()
-            << " user=" << configManager->getPostgresqlUsername()
-            << " password=" << configManager->getPostgresqlPassword()
-            << " connect_timeout=" << configManager->getPostgresqlConnectionTimeout();
+    PostgreSQLConnectionPool::Options options;
+    options.connectionString = buildConnectionString();
+    options.minSize = configManager->getPostgresqlMinPoolSize();
+    options.maxSize = configManager->getPostgresqlConnectionPoolSize();
+    options.acquireTimeout = std::chrono::milliseconds(configManager->getPostgresqlAcquireTimeoutMs());
+    options.maxLifetime = std::chrono::seconds(configManager->getPostgresqlMaxLifetime());
+    options.healthCheckInterval = std::chrono::seconds(configManager->getPostgresqlHealthCheckInterval());
+
+    connectionPool = std::make_unique<PostgreSQLConnectionPool>(options);
+    if (!connectionPool->start())
+    {
+        connectionPool.reset();
+        return false;
+    }
+
+    Logger::info("PostgreSQL连接池创建成功，大小: {}-{}", options.minSize, options.maxSize);
+    return true;
+}
 
-    connectionPool->connectionString = connStr.str();
-    connectionPool->maxSize = configManager->getPostgresqlConnectionPoolSize();
+bool PostgreSQLDatabase::createReplicaPools()
+{
+    hedgedReads = configManager->getPostgresqlHedgedReads();
+    hedgeMinDelay = std::chrono::milliseconds(configManager->getPostgresqlHedgeMinDelayMs());
 
-    // 创建初始连接
-    for (size_t i = 0; i < connectionPool->maxSize; ++i)
+    for (const auto &replicaConfig : configManager->getPostgresqlReplicas())
     {
-        PGconn *conn = PQconnectdb(connectionPool->connectionString.c_str());
-        if (PQstatus(conn) != CONNECTION_OK)
+        PostgreSQLConnectionPool::Options options;
+        options.connectionString = buildConnectionString(replicaConfig);
+        options.minSize = configManager->getPostgresqlMinPoolSize();
+        options.maxSize = replicaConfig.connectionPoolSize;
+        options.acquireTimeout = std::chrono::milliseconds(configManager->getPostgresqlAcquireTimeoutMs());
+        options.maxLifetime = std::chrono::seconds(configManager->getPostgresqlMaxLifetime());
+        options.healthCheckInterval = std::chrono::seconds(configManager->getPostgresqlHealthCheckInterval());
+
+        auto replica = std::make_unique<Replica>();
+        replica->name = replicaConfig.host + ":" + std::to_string(replicaConfig.port);
+        replica->pool = std::make_unique<PostgreSQLConnectionPool>(options);
+
+        // 副本不可用不影响启动，读请求会回退到主库
+        if (!replica->pool->start())
         {
-            Logger::error("PostgreSQL连接失败: {}", PQerrorMessage(conn));
-            PQfinish(conn);
-            return false;
+            Logger::warn("PostgreSQL只读副本 {} 连接失败，已跳过", replica->name);
+            continue;
         }
-        connectionPool->connections.push_back(conn);
+
+        Logger::info("PostgreSQL只读副本已连接: {}", replica->name);
+        replicas.push_back(std::move(replica));
+    }
+
+    if (hedgedReads && replicas.size() > 1)
+    {
+        cancelRunning = true;
+        cancelThread = std::thread(&PostgreSQLDatabase::cancelLoop, this);
     }
 
-    Logger::info("PostgreSQL连接池创建成功，大小: {}", connectionPool->maxSize);
     return true;
 }
 
-PGconn *PostgreSQLDatabase::acquireConnection()
+PostgreSQLDatabase::Replica *PostgreSQLDatabase::pickReplica(const Replica *exclude)
 {
-    std::lock_guard<std::mutex> lock(connectionPool->mutex);
+    Replica *best = nullptr;
+    for (auto &replica : replicas)
+    {
+        if (replica.get() == exclude)
+            continue;
+
+        if (!best || replica->outstanding.load() < best->outstanding.load())
+        {
+            best = replica.get();
+        }
+    }
+    return best;
+}
 
-    if (connectionPool->connections.empty())
+PGresult *PostgreSQLDatabase::executeRead(ReadKind kind, const std::string &sql, const std::vector<std::string> &params)
+{
+    if (!replicas.empty() && !PrimaryReadScope::active())
     {
-        // 连接池为空，创建新连接
-        PGconn *conn = PQconnectdb(connectionPool->connectionString.c_str());
-        if (PQstatus(conn) != CONNECTION_OK)
+        Replica *replica = pickReplica();
+        PGresult *result = (hedgedReads && replicas.size() > 1)
+                               ? executeHedged(*replica, kind, sql, params)
+                               : executeOnReplica(*replica, kind, sql, params);
+        if (result)
         {
-            Logger::error("无法创建新连接: {}", PQerrorMessage(conn));
-            PQfinish(conn);
-            return nullptr;
+            return result;
         }
-        return conn;
+        Logger::warn("只读副本 {} 查询失败，回退到主库", replica->name);
     }
 
-    PGconn *conn = connectionPool->connections.back();
-    connectionPool->connections.pop_back();
-    return conn;
+    PGconn *conn = acquireConnection();
+    if (!conn)
+        return nullptr;
+
+    PGresult *result = executeQuery(conn, sql, params);
+    releaseConnection(conn);
+    return result;
 }
 
-void PostgreSQLDatabase::releaseConnection(PGconn *conn)
+PGconn *PostgreSQLDatabase::acquireReadConnection(Replica *&replica)
 {
-    if (!conn)
+    replica = nullptr;
+    if (!replicas.empty() && !PrimaryReadScope::active())
+    {
+        Replica *candidate = pickReplica();
+        ++candidate->outstanding;
+        PGconn *conn = candidate->pool->acquire();
+        if (conn)
+        {
+            replica = candidate;
+            return conn;
+        }
+        --candidate->outstanding;
+        Logger::warn("只读副本 {} 无可用连接，回退到主库", candidate->name);
+    }
+    return acquireConnection();
+}
+
+void PostgreSQLDatabase::releaseReadConnection(PGconn *conn, Replica *replica, bool reusable)
+{
+    if (!replica)
+    {
+        reusable ? releaseConnection(conn) : discardConnection(conn);
         return;
+    }
 
-    std::lock_guard<std::mutex> lock(connectionPool->mutex);
+    reusable ? replica->pool->release(conn) : replica->pool->discard(conn);
+    ++replica->reads;
+    --replica->outstanding;
+}
 
-    if (connectionPool->connections.size() < connectionPool->maxSize)
+PGresult *PostgreSQLDatabase::executeOnReplica(Replica &replica, ReadKind kind, const std::string &sql, const std::vector<std::string> &params)
+{
+    ++replica.outstanding;
+    auto start = std::chrono::steady_clock::now();
+
+    PGconn *conn = replica.pool->acquire();
+    if (!conn)
+    {
+        --replica.outstanding;
+        return nullptr;
+    }
+
+    PGresult *result = executeQuery(conn, sql, params);
+    replica.pool->release(conn);
+
+    replica.recordLatency(kind, elapsedMs(start));
+    ++replica.reads;
+    --replica.outstanding;
+    return result;
+}
+
+PGresult *PostgreSQLDatabase::executeHedged(Replica &first, ReadKind kind, const std::string &sql, const std::vector<std::string> &params)
+{
+    PGconn *firstConn = first.pool->acquire();
+    if (!firstConn)
+        return nullptr;
+
+    ++first.outstanding;
+    auto firstStart = std::chrono::steady_clock::now();
+    if (!sendQuery(firstConn, sql, params))
+    {
+        first.pool->release(firstConn);
+        --first.outstanding;
+        return nullptr;
+    }
+
+    // 在p95延迟内完成则无需对冲
+    auto hedgeDelay = std::max(hedgeMinDelay, std::chrono::milliseconds(static_cast<long>(first.p95(kind))));
+    if (waitForResult({firstConn}, hedgeDelay) == 0)
+    {
+        PGresult *result = collectResult(firstConn);
+        first.pool->release(firstConn);
+        first.recordLatency(kind, elapsedMs(firstStart));
+        ++first.reads;
+        --first.outstanding;
+        return result;
+    }
+
+    // 首个请求超过p95，向另一副本发起对冲请求
+    Replica *second = pickReplica(&first);
+    PGconn *secondConn = second ? second->pool->acquire() : nullptr;
+    auto secondStart = std::chrono::steady_clock::now();
+    if (secondConn && !sendQuery(secondConn, sql, params))
+    {
+        second->pool->release(secondConn);
+        secondConn = nullptr;
+    }
+
+    std::vector<PGconn *> conns = {firstConn};
+    if (secondConn)
     {
-        connectionPool->connections.push_back(conn);
+        ++first.hedges;
+        ++second->outstanding;
+        conns.push_back(secondConn);
+    }
+
+    auto timeout = std::chrono::seconds(configManager->getPostgresqlConnectionTimeout());
+    int winner = waitForResult(conns, timeout);
+
+    // 先取出胜出的结果并归还其连接；落败（或都超时）的请求交给后台线程取消，不拖慢本次读取
+    PGresult *result = nullptr;
+    first.recordLatency(kind, elapsedMs(firstStart));
+    if (winner == 0)
+    {
+        result = collectResult(firstConn);
+        first.pool->release(firstConn);
+        ++first.reads;
+        --first.outstanding;
     }
     else
     {
-        PQfinish(conn);
+        cancelLater(firstConn, &first);
+    }
+
+    if (secondConn)
+    {
+        if (winner == 1)
+        {
+            result = collectResult(secondConn);
+            second->recordLatency(kind, elapsedMs(secondStart));
+            ++second->hedgeWins;
+            second->pool->release(secondConn);
+            ++second->reads;
+            --second->outstanding;
+        }
+        else
+        {
+            cancelLater(secondConn, second);
+        }
+    }
+
+    return result;
+}
+
+void PostgreSQLDatabase::cancelLater(PGconn *conn, Replica *replica)
+{
+    {
+        std::lock_guard<std::mutex> lock(cancelMutex);
+        if (cancelRunning)
+        {
+            pendingCancels.push_back({conn, replica});
+            cancelCv.notify_one();
+            return;
+        }
+    }
+
+    // 取消线程未运行（正在关闭）时就地取消
+    cancelAndDrain(conn);
+    replica->pool->release(conn);
+    ++replica->reads;
+    --replica->outstanding;
+}
+
+void PostgreSQLDatabase::cancelLoop()
+{
+    std::unique_lock<std::mutex> lock(cancelMutex);
+    while (true)
+    {
+        cancelCv.wait(lock, [this]()
+                      { return !cancelRunning || !pendingCancels.empty(); });
+        if (pendingCancels.empty())
+            return;
+
+        // PQcancel需要新建一条到服务端的连接，在锁外逐个完成；停止时先处理完已排队的请求
+        std::vector<PendingCancel> batch;
+        batch.swap(pendingCancels);
+        lock.unlock();
+        for (const PendingCancel &pending : batch)
+        {
+            cancelAndDrain(pending.conn);
+            pending.replica->pool->release(pending.conn);
+            ++pending.replica->reads;
+            --pending.replica->outstanding;
+        }
+        lock.lock();
+    }
+}
+
+bool PostgreSQLDatabase::createAsyncExecutor()
+{
+    int asyncConnections = configManager ? configManager->getPostgresqlAsyncConnections() : 0;
+    if (asyncConnections <= 0)
+    {
+        return false;
+    }
+
+    asyncExecutor = std::make_unique<PostgreSQLAsyncExecutor>(buildConnectionString(), asyncConnections);
+    asyncExecutor->prepare("get_student", "SELECT name, age, className FROM students WHERE id = $1;");
+    asyncExecutor->prepare("add_student", "INSERT INTO students (name, age, className) VALUES ($1, $2, $3) RETURNING id;");
+    asyncExecutor->prepare("update_student", "UPDATE students SET name = $1, age = $2, className = $3 WHERE id = $4;");
+    asyncExecutor->prepare("delete_student", "DELETE FROM students WHERE id = $1;");
+    asyncExecutor->prepare("all_students", "SELECT id, name, age, className FROM students;");
+    asyncExecutor->prepare("count_students", "SELECT COUNT(*) FROM students;");
+
+    if (!asyncExecutor->start())
+    {
+        Logger::warn("PostgreSQL异步执行器启动失败，异步操作将同步执行");
+        asyncExecutor.reset();
+        return false;
+    }
+
+    return true;
+}
+
+PGconn *PostgreSQLDatabase::acquireConnection()
+{
+    if (!connectionPool)
+    {
+        Logger::error("PostgreSQL连接池未创建");
+        return nullptr;
     }
+
+    return connectionPool->acquire();
+}
+
+void PostgreSQLDatabase::releaseConnection(PGconn *conn)
+{
+    if (!conn || !connectionPool)
+        return;
+
+    connectionPool->release(conn);
+}
+
+void PostgreSQLDatabase::discardConnection(PGconn *conn)
+{
+    if (!conn || !connectionPool)
+        return;
+
+    connectionPool->discard(conn);
 }
 
 PGresult *PostgreSQLDatabase::executeQuery(PGconn *conn, const std::string &sql, const std::vector<std::string> &params)
@@ -134,6 +661,121 @@ PGresult *PostgreSQLDatabase::executeQuery(PGconn *conn, const std::string &sql,
     return result;
 }
 
+bool PostgreSQLDatabase::executePipeline(PGconn *conn, const std::string &sql,
+                                         const std::vector<std::vector<std::string>> &paramsList,
+                                         std::vector<PGresult *> &results)
+{
+    results.assign(paramsList.size(), nullptr);
+    if (!conn)
+    {
+        Logger::error("数据库连接无效");
+        return false;
+    }
+
+#ifdef LIBPQ_HAS_PIPELINING
+    if (PQenterPipelineMode(conn) != 1)
+    {
+        Logger::error("进入pipeline模式失败: {}", PQerrorMessage(conn));
+        return false;
+    }
+
+    std::vector<const char *> paramValues;
+    for (size_t begin = 0; begin < paramsList.size(); begin += kPipelineBatchSize)
+    {
+        size_t end = std::min(begin + kPipelineBatchSize, paramsList.size());
+
+        // 发送本批所有语句，最后一个同步点；发送或同步失败时协议状态未知，连接不再复用
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto &params = paramsList[i];
+            paramValues.clear();
+            for (const auto &param : params)
+            {
+                paramValues.push_back(param.c_str());
+            }
+
+            if (PQsendQueryParams(conn, sql.c_str(), params.size(), nullptr,
+                                  paramValues.empty() ? nullptr : paramValues.data(),
+                                  nullptr, nullptr, 0) != 1)
+            {
+                Logger::error("pipeline发送SQL失败: {}", PQerrorMessage(conn));
+                return false;
+            }
+        }
+
+        if (PQpipelineSync(conn) != 1)
+        {
+            Logger::error("pipeline同步失败: {}", PQerrorMessage(conn));
+            return false;
+        }
+
+        // 同步点之间的语句是一个隐式事务：任一语句失败，服务器回滚整批，
+        // 之前已返回成功的结果也一并丢弃
+        bool segmentFailed = false;
+        for (size_t i = begin; i < end; ++i)
+        {
+            PGresult *result;
+            while ((result = PQgetResult(conn)) != nullptr)
+            {
+                ExecStatusType status = PQresultStatus(result);
+                if (results[i] == nullptr && (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK))
+                {
+                    results[i] = result;
+                    continue;
+                }
+                if (status == PGRES_FATAL_ERROR)
+                {
+                    Logger::error("SQL执行错误: {}", PQresultErrorMessage(result));
+                }
+                segmentFailed = true;
+                PQclear(result);
+            }
+            if (results[i] == nullptr)
+            {
+                segmentFailed = true;
+            }
+        }
+
+        if (segmentFailed)
+        {
+            Logger::error("pipeline批次执行失败，已回滚 {} 条语句", end - begin);
+            for (size_t i = begin; i < end; ++i)
+            {
+                PQclear(results[i]);
+                results[i] = nullptr;
+            }
+        }
+
+        // 读取同步点结果，不是同步点说明结果流已错位
+        PGresult *syncResult = PQgetResult(conn);
+        bool synced = syncResult && PQresultStatus(syncResult) == PGRES_PIPELINE_SYNC;
+        if (!synced)
+        {
+            Logger::error("pipeline同步结果异常: {}", syncResult ? PQresStatus(PQresultStatus(syncResult)) : "无结果");
+        }
+        PQclear(syncResult);
+        if (!synced)
+        {
+            return false;
+        }
+    }
+
+    if (PQexitPipelineMode(conn) != 1)
+    {
+        Logger::error("退出pipeline模式失败: {}", PQerrorMessage(conn));
+        return false;
+    }
+#else
+    // libpq < 14 不支持pipeline，退化为逐条执行
+    for (size_t i = 0; i < paramsList.size(); ++i)
+    {
+        results[i] = executeQuery(conn, sql, paramsList[i]);
+    }
+#endif
+
+    return true;
+}
+
 bool PostgreSQLDatabase::open()
 {
     if (!createConnectionPool())
@@ -149,22 +791,96 @@ bool PostgreSQLDatabase::open()
         return false;
     }
 
+    createReplicaPools();
+
+    // 异步执行器依赖学生表预编译语句，需在建表后创建
+    createAsyncExecutor();
+
+    if (configManager->getPostgresqlListenNotify() && createNotifyTrigger())
+    {
+        startChangeListener();
+    }
+
     Logger::info("PostgreSQL数据库连接成功");
     return true;
 }
 
 void PostgreSQLDatabase::close()
 {
+    stopChangeListener();
+
+    if (asyncExecutor)
+    {
+        asyncExecutor->stop();
+        asyncExecutor.reset();
+    }
+
+    // 落败的对冲请求持有副本连接，先等取消线程处理完再停止副本连接池
+    {
+        std::lock_guard<std::mutex> lock(cancelMutex);
+        cancelRunning = false;
+    }
+    cancelCv.notify_all();
+    if (cancelThread.joinable())
+    {
+        cancelThread.join();
+    }
+
+    for (auto &replica : replicas)
+    {
+        replica->pool->stop();
+    }
+    replicas.clear();
+
     if (!connectionPool)
         return;
 
-    std::lock_guard<std::mutex> lock(connectionPool->mutex);
-    for (PGconn *conn : connectionPool->connections)
+    connectionPool->stop();
+    connectionPool.reset();
+    Logger::info("PostgreSQL数据库连接已关闭");
+}
+
+json PostgreSQLDatabase::getMetrics() const
+{
+    json metrics = json::object();
+    if (!connectionPool)
+        return metrics;
+
+    PostgreSQLConnectionPool::Stats stats = connectionPool->getStats();
+    metrics["pool"] = {
+        {"total", stats.total},
+        {"idle", stats.idle},
+        {"in_use", stats.inUse},
+        {"waiters", stats.waiters},
+        {"acquired", stats.acquired},
+        {"timeouts", stats.timeouts},
+        {"created", stats.created},
+        {"retired", stats.retired},
+        {"avg_wait_ms", stats.avgWaitMs},
+        {"max_wait_ms", stats.maxWaitMs}};
+    if (asyncExecutor)
     {
-        PQfinish(conn);
+        metrics["async_in_flight"] = asyncExecutor->inFlight();
     }
-    connectionPool->connections.clear();
-    Logger::info("PostgreSQL数据库连接已关闭");
+
+    json replicaMetrics = json::array();
+    for (const auto &replica : replicas)
+    {
+        PostgreSQLConnectionPool::Stats replicaStats = replica->pool->getStats();
+        replicaMetrics.push_back({{"name", replica->name},
+                                  {"outstanding", replica->outstanding.load()},
+                                  {"reads", replica->reads.load()},
+                                  {"p95_ms", {{"point", replica->p95(ReadKind::Point)},
+                                              {"scan", replica->p95(ReadKind::Scan)},
+                                              {"count", replica->p95(ReadKind::Count)}}},
+                                  {"hedges", replica->hedges.load()},
+                                  {"hedge_wins", replica->hedgeWins.load()},
+                                  {"pool_total", replicaStats.total},
+                                  {"pool_idle", replicaStats.idle},
+                                  {"pool_waiters", replicaStats.waiters}});
+    }
+    metrics["replicas"] = replicaMetrics;
+    return metrics;
 }
 
 bool PostgreSQLDatabase::createStudentTable()
@@ -184,11 +900,211 @@ bool PostgreSQLDatabase::createStudentTable()
 
     if (!result)
     {
-        return false;
+        return false;
+    }
+
+    PQclear(result);
+    return true;
+}
+
+bool PostgreSQLDatabase::createNotifyTrigger()
+{
+    PGconn *conn = acquireConnection();
+    if (!conn)
+        return false;
+
+    // 负载格式：操作:ID:写入方application_name
+    // 批量导入期间（事务内设置了students.bulk_import）不逐行通知，导入结束后统一发送resync
+    const char *functionSql =
+        "CREATE OR REPLACE FUNCTION students_notify() RETURNS trigger AS $$ "
+        "BEGIN "
+        "IF current_setting('students.bulk_import', true) = 'on' THEN RETURN NULL; END IF; "
+        "PERFORM pg_notify('students_changed', lower(TG_OP) || ':' || "
+        "(CASE WHEN TG_OP = 'DELETE' THEN OLD.id ELSE NEW.id END) || ':' || "
+        "current_setting('application_name')); "
+        "RETURN NULL; "
+        "END; $$ LANGUAGE plpgsql;";
+
+    const char *triggerSql =
+        "DO $$ BEGIN "
+        "IF NOT EXISTS (SELECT 1 FROM pg_trigger WHERE tgname = 'students_notify_trigger') THEN "
+        "CREATE TRIGGER students_notify_trigger AFTER INSERT OR UPDATE OR DELETE ON students "
+        "FOR EACH ROW EXECUTE PROCEDURE students_notify(); "
+        "END IF; "
+        "END $$;";
+
+    PGresult *result = executeQuery(conn, functionSql);
+    if (result)
+    {
+        PQclear(result);
+        result = executeQuery(conn, triggerSql);
+    }
+    releaseConnection(conn);
+
+    if (!result)
+    {
+        Logger::error("创建学生变更通知触发器失败");
+        return false;
+    }
+
+    PQclear(result);
+    return true;
+}
+
+void PostgreSQLDatabase::setChangeListener(StudentChangeListener listener)
+{
+    std::lock_guard<std::mutex> lock(changeListenerMutex);
+    changeListener = std::move(listener);
+}
+
+void PostgreSQLDatabase::startChangeListener()
+{
+    if (listening.exchange(true))
+        return;
+
+    listenerThread = std::thread(&PostgreSQLDatabase::changeListenerLoop, this);
+}
+
+void PostgreSQLDatabase::stopChangeListener()
+{
+    listening = false;
+    if (listenerThread.joinable())
+    {
+        listenerThread.join();
+    }
+}
+
+void PostgreSQLDatabase::changeListenerLoop()
+{
+    std::string connStr = buildConnectionString();
+    std::string listenSql = std::string("LISTEN ") + kChangeChannel + ";";
+    PGconn *conn = nullptr;
+    int backoffMs = 500;
+    bool connectedBefore = false;
+
+    while (listening)
+    {
+        if (!conn)
+        {
+            conn = PQconnectdb(connStr.c_str());
+            PGresult *result = nullptr;
+            if (PQstatus(conn) == CONNECTION_OK)
+            {
+                result = PQexec(conn, listenSql.c_str());
+            }
+
+            bool ok = result && PQresultStatus(result) == PGRES_COMMAND_OK;
+            PQclear(result);
+            if (!ok)
+            {
+                Logger::warn("变更通知监听连接失败，{}ms后重试: {}", backoffMs, PQerrorMessage(conn));
+                PQfinish(conn);
+                conn = nullptr;
+
+                for (int waited = 0; waited < backoffMs && listening; waited += 100)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+                backoffMs = std::min(backoffMs * 2, 30000);
+                continue;
+            }
+
+            backoffMs = 500;
+            Logger::info("已开始监听学生变更通知: {}", kChangeChannel);
+
+            // 断开期间的通知已丢失，要求监听方整体失效
+            if (connectedBefore)
+            {
+                StudentChangeEvent event{StudentChangeEvent::Operation::Resync, 0, instanceName, false};
+                notifyChangeListener(event);
+            }
+            connectedBefore = true;
+        }
+
+        pollfd pfd{};
+        pfd.fd = PQsocket(conn);
+        pfd.events = POLLIN;
+        int rc = poll(&pfd, 1, 500);
+        if (rc < 0 && errno != EINTR)
+        {
+            Logger::error("变更通知连接poll失败: {}", std::strerror(errno));
+        }
+        if (rc <= 0)
+            continue;
+
+        if (PQconsumeInput(conn) != 1)
+        {
+            Logger::warn("变更通知连接断开: {}", PQerrorMessage(conn));
+            PQfinish(conn);
+            conn = nullptr;
+            continue;
+        }
+
+        while (PGnotify *notify = PQnotifies(conn))
+        {
+            dispatchNotification(notify->extra ? notify->extra : "");
+            PQfreemem(notify);
+        }
+    }
+
+    if (conn)
+    {
+        PQfinish(conn);
+    }
+}
+
+void PostgreSQLDatabase::dispatchNotification(const std::string &payload)
+{
+    size_t first = payload.find(':');
+    size_t second = first == std::string::npos ? std::string::npos : payload.find(':', first + 1);
+    if (second == std::string::npos)
+    {
+        Logger::warn("无法解析学生变更通知: {}", payload);
+        return;
+    }
+
+    StudentChangeEvent event;
+    std::string operation = payload.substr(0, first);
+    event.origin = payload.substr(second + 1);
+
+    // 本实例的写入已在写路径上处理
+    if (event.origin == instanceName)
+        return;
+
+    try
+    {
+        event.id = std::stoi(payload.substr(first + 1, second - first - 1));
+    }
+    catch (const std::exception &e)
+    {
+        Logger::warn("学生变更通知ID无效: {}", payload);
+        return;
+    }
+
+    if (operation == "insert")
+        event.operation = StudentChangeEvent::Operation::Insert;
+    else if (operation == "update")
+        event.operation = StudentChangeEvent::Operation::Update;
+    else if (operation == "resync")
+        event.operation = StudentChangeEvent::Operation::Resync;
+    else
+        event.operation = StudentChangeEvent::Operation::Delete;
+    event.fromPeer = event.origin.compare(0, kInstancePrefix.size(), kInstancePrefix) == 0;
+
+    notifyChangeListener(event);
+}
+
+void PostgreSQLDatabase::notifyChangeListener(const StudentChangeEvent &event)
+{
+    StudentChangeListener listener;
+    {
+        std::lock_guard<std::mutex> lock(changeListenerMutex);
+        listener = changeListener;
+    }
+    if (listener)
+    {
+        listener(event);
     }
-
-    PQclear(result);
-    return true;
 }
 
 int PostgreSQLDatabase::addStudent(const Student &student)
@@ -273,15 +1189,10 @@ bool PostgreSQLDatabase::deleteStudent(int id)
 
 Student PostgreSQLDatabase::getStudent(int id)
 {
-    PGconn *conn = acquireConnection();
-    if (!conn)
-        return Student();
-
     std::string sql = "SELECT name, age, className FROM students WHERE id = $1;";
     std::vector<std::string> params = {std::to_string(id)};
 
-    PGresult *result = executeQuery(conn, sql, params);
-    releaseConnection(conn);
+    PGresult *result = executeRead(ReadKind::Point, sql, params);
 
     if (!result)
     {
@@ -304,55 +1215,542 @@ Student PostgreSQLDatabase::getStudent(int id)
     return Student(name, age, className);
 }
 
-std::vector<std::pair<int, Student>> PostgreSQLDatabase::getAllStudents()
+StudentBatch PostgreSQLDatabase::getAllStudents()
 {
-    std::vector<std::pair<int, Student>> students;
-
-    PGconn *conn = acquireConnection();
-    if (!conn)
-        return students;
+    StudentBatch students;
 
     std::string sql = "SELECT id, name, age, className FROM students;";
-    PGresult *result = executeQuery(conn, sql);
-    releaseConnection(conn);
+    PGresult *result = executeRead(ReadKind::Scan, sql);
 
     if (!result)
     {
         return students;
     }
 
-    int numRows = PQntuples(result);
-    for (int i = 0; i < numRows; ++i)
+    students = batchFromResult(result);
+    PQclear(result);
+    Logger::info("从数据库获取所有学生，数量: {}", students.size());
+    return students;
+}
+
+int PostgreSQLDatabase::getStudentCount()
+{
+    std::string sql = "SELECT COUNT(*) FROM students;";
+    PGresult *result = executeRead(ReadKind::Count, sql);
+
+    if (!result)
     {
-        int id = std::stoi(PQgetvalue(result, i, 0));
-        std::string name = PQgetvalue(result, i, 1);
-        int age = std::stoi(PQgetvalue(result, i, 2));
-        std::string className = PQgetvalue(result, i, 3);
-        students.emplace_back(id, Student(name, age, className));
+        return -1;
     }
 
+    int count = std::stoi(PQgetvalue(result, 0, 0));
     PQclear(result);
-    Logger::info("从数据库获取所有学生，数量: {}", students.size());
+
+    return count;
+}
+
+long long PostgreSQLDatabase::getMaxStudentId()
+{
+    std::string sql = "SELECT COALESCE(MAX(id), 0) FROM students;";
+    PGresult *result = executeRead(ReadKind::Count, sql);
+
+    if (!result)
+    {
+        return -1;
+    }
+
+    long long maxId = std::stoll(PQgetvalue(result, 0, 0));
+    PQclear(result);
+
+    return maxId;
+}
+
+StudentBatch PostgreSQLDatabase::getStudents(const std::vector<int> &ids)
+{
+    StudentBatch students;
+    if (ids.empty())
+        return students;
+
+    Replica *replica;
+    PGconn *conn = acquireReadConnection(replica);
+    if (!conn)
+        return students;
+
+    std::string sql = "SELECT name, age, className FROM students WHERE id = $1;";
+    std::vector<std::vector<std::string>> paramsList;
+    paramsList.reserve(ids.size());
+    for (int id : ids)
+    {
+        paramsList.push_back({std::to_string(id)});
+    }
+
+    std::vector<PGresult *> results;
+    bool reusable = executePipeline(conn, sql, paramsList, results);
+    releaseReadConnection(conn, replica, reusable);
+
+    students.reserve(ids.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        PGresult *result = results[i];
+        if (!result)
+            continue;
+
+        if (PQntuples(result) > 0)
+        {
+            students.add(ids[i], std::stoi(PQgetvalue(result, 0, 1)),
+                         std::string_view(PQgetvalue(result, 0, 0), PQgetlength(result, 0, 0)),
+                         std::string_view(PQgetvalue(result, 0, 2), PQgetlength(result, 0, 2)));
+        }
+        PQclear(result);
+    }
+
+    Logger::info("批量获取学生，请求: {}，命中: {}", ids.size(), students.size());
     return students;
 }
 
-int PostgreSQLDatabase::getStudentCount()
+std::vector<int> PostgreSQLDatabase::addStudents(const std::vector<Student> &students)
 {
+    std::vector<int> ids(students.size(), -1);
+    if (students.empty())
+        return ids;
+
+    PGconn *conn = acquireConnection();
+    if (!conn)
+        return ids;
+
+    std::string sql = "INSERT INTO students (name, age, className) VALUES ($1, $2, $3) RETURNING id;";
+    std::vector<std::vector<std::string>> paramsList;
+    paramsList.reserve(students.size());
+    for (const auto &student : students)
+    {
+        paramsList.push_back({student.getName(), std::to_string(student.getAge()), student.getClassName()});
+    }
+
+    std::vector<PGresult *> results;
+    if (executePipeline(conn, sql, paramsList, results))
+        releaseConnection(conn);
+    else
+        discardConnection(conn);
+
+    size_t added = 0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        PGresult *result = results[i];
+        if (!result)
+            continue;
+
+        if (PQntuples(result) > 0)
+        {
+            ids[i] = std::stoi(PQgetvalue(result, 0, 0));
+            ++added;
+        }
+        PQclear(result);
+    }
+
+    Logger::info("批量添加学生，请求: {}，成功: {}", students.size(), added);
+    return ids;
+}
+
+int PostgreSQLDatabase::deleteStudents(const std::vector<int> &ids)
+{
+    if (ids.empty())
+        return 0;
+
     PGconn *conn = acquireConnection();
     if (!conn)
         return -1;
 
-    std::string sql = "SELECT COUNT(*) FROM students;";
-    PGresult *result = executeQuery(conn, sql);
-    releaseConnection(conn);
+    std::string sql = "DELETE FROM students WHERE id = $1;";
+    std::vector<std::vector<std::string>> paramsList;
+    paramsList.reserve(ids.size());
+    for (int id : ids)
+    {
+        paramsList.push_back({std::to_string(id)});
+    }
 
-    if (!result)
+    std::vector<PGresult *> results;
+    if (executePipeline(conn, sql, paramsList, results))
+        releaseConnection(conn);
+    else
+        discardConnection(conn);
+
+    int deleted = 0;
+    for (PGresult *result : results)
+    {
+        if (!result)
+            continue;
+
+        if (PQcmdTuples(result)[0] != '0')
+        {
+            ++deleted;
+        }
+        PQclear(result);
+    }
+
+    Logger::info("批量删除学生，请求: {}，成功: {}", ids.size(), deleted);
+    return deleted;
+}
+
+void PostgreSQLDatabase::getStudentAsync(int id, std::function<void(Student)> callback)
+{
+    // 执行器只连接主库；配置了副本且未要求读主库时按同步读路由到副本
+    if (!asyncExecutor || (!replicas.empty() && !PrimaryReadScope::active()))
+    {
+        DatabaseInterface::getStudentAsync(id, std::move(callback));
+        return;
+    }
+
+    bool submitted = asyncExecutor->submit("get_student", {std::to_string(id)}, [callback](PGresult *result)
+                                           {
+        if (!result || PQntuples(result) == 0) {
+            callback(Student());
+            return;
+        }
+        callback(Student(PQgetvalue(result, 0, 0), std::stoi(PQgetvalue(result, 0, 1)), PQgetvalue(result, 0, 2))); });
+    if (!submitted)
+    {
+        callback(Student());
+    }
+}
+
+void PostgreSQLDatabase::addStudentAsync(const Student &student, std::function<void(int)> callback)
+{
+    if (!asyncExecutor)
+    {
+        DatabaseInterface::addStudentAsync(student, std::move(callback));
+        return;
+    }
+
+    std::vector<std::string> params = {student.getName(), std::to_string(student.getAge()), student.getClassName()};
+    bool submitted = asyncExecutor->submit("add_student", std::move(params), [callback](PGresult *result)
+                                           {
+        if (!result || PQntuples(result) == 0) {
+            callback(-1);
+            return;
+        }
+        callback(std::stoi(PQgetvalue(result, 0, 0))); });
+    if (!submitted)
+    {
+        callback(-1);
+    }
+}
+
+void PostgreSQLDatabase::updateStudentAsync(int id, const Student &student, std::function<void(bool)> callback)
+{
+    if (!asyncExecutor)
+    {
+        DatabaseInterface::updateStudentAsync(id, student, std::move(callback));
+        return;
+    }
+
+    std::vector<std::string> params = {student.getName(), std::to_string(student.getAge()), student.getClassName(), std::to_string(id)};
+    bool submitted = asyncExecutor->submit("update_student", std::move(params), [callback](PGresult *result)
+                                           { callback(result && PQcmdTuples(result)[0] != '0'); });
+    if (!submitted)
+    {
+        callback(false);
+    }
+}
+
+void PostgreSQLDatabase::deleteStudentAsync(int id, std::function<void(bool)> callback)
+{
+    if (!asyncExecutor)
+    {
+        DatabaseInterface::deleteStudentAsync(id, std::move(callback));
+        return;
+    }
+
+    bool submitted = asyncExecutor->submit("delete_student", {std::to_string(id)}, [callback](PGresult *result)
+                                           { callback(result && PQcmdTuples(result)[0] != '0'); });
+    if (!submitted)
+    {
+        callback(false);
+    }
+}
+
+void PostgreSQLDatabase::getAllStudentsAsync(std::function<void(StudentBatch)> callback)
+{
+    // 执行器只连接主库；配置了副本且未要求读主库时按同步读路由到副本
+    if (!asyncExecutor || (!replicas.empty() && !PrimaryReadScope::active()))
     {
+        DatabaseInterface::getAllStudentsAsync(std::move(callback));
+        return;
+    }
+
+    bool submitted = asyncExecutor->submit("all_students", {}, [callback](PGresult *result)
+                                           {
+        callback(result ? batchFromResult(result) : StudentBatch()); });
+    if (!submitted)
+    {
+        callback({});
+    }
+}
+
+void PostgreSQLDatabase::getStudentCountAsync(std::function<void(int)> callback)
+{
+    // 执行器只连接主库；配置了副本且未要求读主库时按同步读路由到副本
+    if (!asyncExecutor || (!replicas.empty() && !PrimaryReadScope::active()))
+    {
+        DatabaseInterface::getStudentCountAsync(std::move(callback));
+        return;
+    }
+
+    bool submitted = asyncExecutor->submit("count_students", {}, [callback](PGresult *result)
+                                           { callback(result ? std::stoi(PQgetvalue(result, 0, 0)) : -1); });
+    if (!submitted)
+    {
+        callback(-1);
+    }
+}
+
+long long PostgreSQLDatabase::importStudents(const StudentSource &source)
+{
+    PGconn *conn = acquireConnection();
+    if (!conn)
         return -1;
+
+    // 在事务内关闭逐行变更通知，提交前发送一条resync代替N条通知
+    for (const char *sql : {"BEGIN;", "SELECT set_config('students.bulk_import', 'on', true);"})
+    {
+        PGresult *result = executeQuery(conn, sql);
+        if (!result)
+        {
+            discardConnection(conn);
+            return -1;
+        }
+        PQclear(result);
     }
 
-    int count = std::stoi(PQgetvalue(result, 0, 0));
+    PGresult *result = PQexec(conn, "COPY students (name, age, className) FROM STDIN (FORMAT binary);");
+    if (PQresultStatus(result) != PGRES_COPY_IN)
+    {
+        Logger::error("启动COPY导入失败: {}", PQresultErrorMessage(result));
+        PQclear(result);
+        finishImportTransaction(conn, false);
+        return -1;
+    }
     PQclear(result);
 
-    return count;
+    std::string buffer;
+    buffer.reserve(kCopyBufferSize + 1024);
+    buffer.append(kCopyBinarySignature, kCopySignatureSize);
+    appendInt32(buffer, 0); // 标志位
+    appendInt32(buffer, 0); // 扩展区长度
+
+    long long rows = 0;
+    bool failed = false;
+    Student student;
+    while (source(student))
+    {
+        appendInt16(buffer, 3);
+        appendField(buffer, student.getName());
+        appendInt32(buffer, sizeof(int32_t));
+        appendInt32(buffer, student.getAge());
+        appendField(buffer, student.getClassName());
+        ++rows;
+
+        if (buffer.size() >= kCopyBufferSize)
+        {
+            if (PQputCopyData(conn, buffer.data(), buffer.size()) != 1)
+            {
+                failed = true;
+                break;
+            }
+            buffer.clear();
+        }
+    }
+
+    if (!failed)
+    {
+        appendInt16(buffer, -1); // 文件尾
+        failed = PQputCopyData(conn, buffer.data(), buffer.size()) != 1;
+    }
+
+    if (PQputCopyEnd(conn, failed ? "导入中止" : nullptr) != 1)
+    {
+        failed = true;
+    }
+
+    long long imported = -1;
+    while ((result = PQgetResult(conn)) != nullptr)
+    {
+        if (PQresultStatus(result) == PGRES_COMMAND_OK && !failed)
+        {
+            imported = std::stoll(PQcmdTuples(result));
+        }
+        else if (PQresultStatus(result) != PGRES_COMMAND_OK)
+        {
+            Logger::error("COPY导入失败: {}", PQresultErrorMessage(result));
+        }
+        PQclear(result);
+    }
+    if (!finishImportTransaction(conn, imported >= 0))
+    {
+        imported = -1;
+    }
+
+    if (imported >= 0)
+    {
+        Logger::info("COPY导入学生完成，数量: {}", imported);
+    }
+    else
+    {
+        Logger::error("COPY导入学生失败，已发送: {}", rows);
+    }
+    return imported;
+}
+
+bool PostgreSQLDatabase::finishImportTransaction(PGconn *conn, bool commit)
+{
+    std::vector<std::string> statements;
+    if (commit)
+    {
+        statements.push_back(std::string("SELECT pg_notify('") + kChangeChannel +
+                             "', 'resync:0:' || current_setting('application_name'));");
+        statements.push_back("COMMIT;");
+    }
+    else
+    {
+        statements.push_back("ROLLBACK;");
+    }
+
+    for (const std::string &sql : statements)
+    {
+        PGresult *result = executeQuery(conn, sql);
+        if (!result)
+        {
+            // 事务状态未知，连接不能回到池中
+            discardConnection(conn);
+            return false;
+        }
+        PQclear(result);
+    }
+    releaseConnection(conn);
+    return true;
+}
+
+long long PostgreSQLDatabase::exportStudents(const StudentSink &sink)
+{
+    Replica *replica;
+    PGconn *conn = acquireReadConnection(replica);
+    if (!conn)
+        return -1;
+
+    PGresult *result = PQexec(conn, "COPY students (id, name, age, className) TO STDOUT (FORMAT binary);");
+    if (PQresultStatus(result) != PGRES_COPY_OUT)
+    {
+        Logger::error("启动COPY导出失败: {}", PQresultErrorMessage(result));
+        PQclear(result);
+        releaseReadConnection(conn, replica);
+        return -1;
+    }
+    PQclear(result);
+
+    // pending保存尚未解析完的字节，内存占用与单行大小相当
+    std::string pending;
+    bool headerParsed = false;
+    bool stopped = false;
+    bool malformed = false;
+    long long exported = 0;
+
+    char *chunk = nullptr;
+    int length;
+    while ((length = PQgetCopyData(conn, &chunk, 0)) > 0)
+    {
+        pending.append(chunk, length);
+        PQfreemem(chunk);
+
+        size_t pos = 0;
+        if (!headerParsed)
+        {
+            if (pending.size() < kCopyHeaderSize)
+                continue;
+
+            int32_t extensionLength = readInt32(pending.data() + kCopySignatureSize + 4);
+            if (pending.size() < kCopyHeaderSize + extensionLength)
+                continue;
+
+            pos = kCopyHeaderSize + extensionLength;
+            headerParsed = true;
+        }
+
+        // 逐行解析：字段数 + (长度 + 数据) * 字段数
+        while (!stopped && !malformed && pending.size() - pos >= 2)
+        {
+            int16_t fieldCount = readInt16(pending.data() + pos);
+            if (fieldCount == -1)
+            {
+                pos = pending.size();
+                break;
+            }
+            if (fieldCount != 4)
+            {
+                malformed = true;
+                break;
+            }
+
+            size_t cursor = pos + 2;
+            std::string fields[4];
+            bool complete = true;
+            for (int i = 0; i < 4; ++i)
+            {
+                if (pending.size() - cursor < 4)
+                {
+                    complete = false;
+                    break;
+                }
+                int32_t fieldLength = readInt32(pending.data() + cursor);
+                cursor += 4;
+                if (fieldLength < 0)
+                    continue;
+                if (pending.size() - cursor < static_cast<size_t>(fieldLength))
+                {
+                    complete = false;
+                    break;
+                }
+                fields[i].assign(pending.data() + cursor, fieldLength);
+                cursor += fieldLength;
+            }
+            if (!complete)
+                break;
+
+            pos = cursor;
+            int id = fields[0].size() == 4 ? readInt32(fields[0].data()) : 0;
+            int age = fields[2].size() == 4 ? readInt32(fields[2].data()) : 0;
+            ++exported;
+            if (!sink(id, Student(fields[1], age, fields[3])))
+            {
+                stopped = true;
+            }
+        }
+
+        pending.erase(0, pos);
+
+        // 接收方停止或格式错误时继续读取剩余数据以结束COPY
+        if (stopped || malformed)
+        {
+            pending.clear();
+        }
+    }
+
+    bool ok = length == -1 && !malformed;
+    while ((result = PQgetResult(conn)) != nullptr)
+    {
+        if (PQresultStatus(result) != PGRES_COMMAND_OK)
+        {
+            Logger::error("COPY导出失败: {}", PQresultErrorMessage(result));
+            ok = false;
+        }
+        PQclear(result);
+    }
+    releaseReadConnection(conn, replica);
+
+    if (!ok)
+    {
+        Logger::error("COPY导出学生失败，已导出: {}", exported);
+        return -1;
+    }
+
+    Logger::info("COPY导出学生完成，数量: {}", exported);
+    return exported;
 }
@@ -1,510 +1,1145 @@
 #include "redis_manager.h"
 #include <vector>
-#include <sstream>
-
-RedisManager::RedisManager(const std::string &host, int port, const std::string &password)
-    : host(host), port(port), password(password), context(nullptr), connected(false)
-{
-}
-
-RedisManager::~RedisManager()
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <utility>
+#include <charconv>
+#include <sys/socket.h>
+
+namespace
 {
-    disconnect();
-}
+    struct timeval toTimeval(std::chrono::milliseconds duration)
+    {
+        struct timeval tv;
+        tv.tv_sec = static_cast<time_t>(duration.count() / 1000);
+        tv.tv_usec = static_cast<suseconds_t>((duration.count() % 1000) * 1000);
+        return tv;
+    }
 
-bool RedisManager::connect()
-{
-    if (connected)
+    // 每个线程固定一个起始槽位，线程数不超过池大小时各线程互不争用
+    size_t threadSlotHint()
     {
-        return true;
+        static std::atomic<size_t> nextHint{0};
+        static thread_local size_t hint = nextHint.fetch_add(1, std::memory_order_relaxed);
+        return hint;
     }
 
-    struct timeval timeout = {1, 500000}; // 1.5 seconds
-    context = redisConnectWithTimeout(host.c_str(), port, timeout);
+    constexpr size_t kInlineArgs = 8;
 
-    if (context == nullptr || context->err)
+    // 在指定连接上执行一条argv命令（建连握手与跟踪连接使用，不经过连接池）
+    redisReply *commandOn(redisContext *context, std::initializer_list<std::string_view> args)
     {
-        if (context)
+        const char *argv[kInlineArgs];
+        size_t argvlen[kInlineArgs];
+        int argc = 0;
+        for (std::string_view arg : args)
         {
-            Logger::error("Redis连接错误: {}", context->errstr);
-            redisFree(context);
-            context = nullptr;
+            argv[argc] = arg.data();
+            argvlen[argc] = arg.size();
+            ++argc;
         }
-        else
+        return static_cast<redisReply *>(redisCommandArgv(context, argc, argv, argvlen));
+    }
+
+    std::string_view formatInt(char (&buffer)[24], long long value)
+    {
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        return std::string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+
+    // 写命令的通用结果：非错误回复即成功
+    bool replySucceeded(redisReply *reply, const char *name)
+    {
+        if (reply == nullptr)
+            return false;
+
+        bool success = (reply->type != REDIS_REPLY_ERROR);
+        if (!success)
         {
-            Logger::error("无法分配Redis连接");
+            Logger::error("Redis {}命令错误: {}", name, std::string_view(reply->str, reply->len));
         }
-        connected = false;
-        return false;
+        freeReplyObject(reply);
+        return success;
     }
 
-    // 如果设置了密码，进行认证
-    if (!password.empty())
+    std::string stringReply(redisReply *reply, const char *name)
     {
-        redisReply *reply = (redisReply *)redisCommand(context, "AUTH %s", password.c_str());
+        std::string result;
         if (reply == nullptr)
+            return result;
+
+        if (reply->type == REDIS_REPLY_STRING)
         {
-            Logger::error("Redis AUTH命令失败: {}", context->errstr);
-            redisFree(context);
-            context = nullptr;
-            connected = false;
-            return false;
+            result.assign(reply->str, reply->len);
+        }
+        else if (reply->type != REDIS_REPLY_NIL)
+        {
+            Logger::error("Redis {}命令错误: 类型 {}", name, reply->type);
         }
-
-        bool authSuccess = (reply->type != REDIS_REPLY_ERROR);
         freeReplyObject(reply);
+        return result;
+    }
 
-        if (!authSuccess)
+    std::vector<std::string> arrayReply(redisReply *reply, const char *name)
+    {
+        std::vector<std::string> result;
+        if (reply == nullptr)
+            return result;
+
+        if (reply->type == REDIS_REPLY_ARRAY || reply->type == REDIS_REPLY_SET)
         {
-            Logger::error("Redis认证失败: 密码错误");
-            redisFree(context);
-            context = nullptr;
-            connected = false;
-            return false;
+            result.reserve(reply->elements);
+            for (size_t i = 0; i < reply->elements; i++)
+            {
+                redisReply *element = reply->element[i];
+                if (element->type == REDIS_REPLY_STRING)
+                {
+                    result.emplace_back(element->str, element->len);
+                }
+            }
         }
-
-        Logger::info("Redis认证成功");
+        else if (reply->type != REDIS_REPLY_ERROR)
+        {
+            Logger::error("Redis {}命令错误: 类型 {}", name, reply->type);
+        }
+        freeReplyObject(reply);
+        return result;
     }
 
-    connected = true;
-    Logger::info("Redis连接成功: {}:{}", host, port);
-    return true;
+    RedisResult toResult(redisReply *reply)
+    {
+        RedisResult result;
+        if (reply == nullptr)
+            return result;
+
+        switch (reply->type)
+        {
+        case REDIS_REPLY_ERROR:
+            result.value.assign(reply->str, reply->len);
+            break;
+        case REDIS_REPLY_NIL:
+            result.ok = true;
+            result.nil = true;
+            break;
+        case REDIS_REPLY_INTEGER:
+            result.ok = true;
+            result.integer = reply->integer;
+            break;
+        case REDIS_REPLY_STRING:
+        case REDIS_REPLY_STATUS:
+        case REDIS_REPLY_VERB:
+            result.ok = true;
+            result.value.assign(reply->str, reply->len);
+            break;
+        default:
+            result.ok = true;
+            break;
+        }
+        freeReplyObject(reply);
+        return result;
+    }
 }
 
-void RedisManager::disconnect()
+struct RedisManager::Slot
+{
+    std::atomic<bool> busy{false};
+    redisContext *context = nullptr; // 只由占有busy的线程访问
+    uint64_t generation = 0;         // 建立连接时的跟踪连接代数
+};
+
+// 借出的连接，析构时归还槽位
+class RedisManager::Connection
 {
-    if (context)
+public:
+    explicit Connection(Slot *slot = nullptr) : slot(slot) {}
+    Connection(Connection &&other) noexcept : slot(std::exchange(other.slot, nullptr)) {}
+    Connection &operator=(Connection &&) = delete;
+
+    ~Connection()
     {
-        redisFree(context);
-        context = nullptr;
+        if (slot)
+        {
+            slot->busy.store(false, std::memory_order_release);
+        }
     }
-    connected = false;
-}
 
-bool RedisManager::reconnect()
-{
-    disconnect();
-    return connect();
-}
+    explicit operator bool() const { return slot != nullptr; }
+    redisContext *get() const { return slot->context; }
 
-bool RedisManager::set(const std::string &key, const std::string &value, int expireSeconds)
+    // 命令失败后连接状态未知，关闭后由下次借出时重连
+    void discard()
+    {
+        redisFree(slot->context);
+        slot->context = nullptr;
+    }
+
+private:
+    Slot *slot;
+};
+
+// 自动流水线：调用方把命令放入队列后阻塞等待，刷写线程每次取出一批，
+// 在一个连接上全部追加后统一写出，再按顺序读取回复并唤醒调用方
+class RedisManager::AutoPipeline
 {
-    if (!connected && !connect())
+public:
+    AutoPipeline(RedisManager &manager, size_t connections, size_t maxBatch)
+        : manager(manager), maxBatch(std::max<size_t>(maxBatch, 1)), stopping(false)
     {
-        return false;
+        for (size_t i = 0; i < std::max<size_t>(connections, 1); ++i)
+        {
+            flushers.emplace_back(&AutoPipeline::run, this);
+        }
     }
 
-    redisReply *reply = nullptr;
-    if (expireSeconds > 0)
+    ~AutoPipeline()
     {
-        reply = (redisReply *)redisCommand(context, "SETEX %s %d %s",
-                                           key.c_str(), expireSeconds, value.c_str());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        pending.notify_all();
+        for (auto &flusher : flushers)
+        {
+            flusher.join();
+        }
     }
-    else
+
+    redisReply *submit(int argc, const char **argv, const size_t *argvlen)
     {
-        reply = (redisReply *)redisCommand(context, "SET %s %s",
-                                           key.c_str(), value.c_str());
+        Request request{argc, argv, argvlen, nullptr, false};
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stopping)
+            return nullptr;
+
+        queue.push_back(&request);
+        pending.notify_one();
+        completed.wait(lock, [&request]
+                       { return request.done; });
+        return request.reply;
     }
 
-    if (reply == nullptr)
+private:
+    // 请求位于调用方栈上，调用方在done置位前一直阻塞
+    struct Request
     {
-        Logger::error("Redis SET命令失败: {}", context->errstr);
-        reconnect();
-        return false;
+        int argc;
+        const char **argv;
+        const size_t *argvlen;
+        redisReply *reply;
+        bool done;
+    };
+
+    RedisManager &manager;
+    size_t maxBatch;
+
+    std::mutex mutex;
+    std::condition_variable pending;
+    std::condition_variable completed;
+    std::deque<Request *> queue;
+    bool stopping;
+    std::vector<std::thread> flushers;
+
+    void run()
+    {
+        std::vector<Request *> batch;
+        batch.reserve(maxBatch);
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                pending.wait(lock, [this]
+                             { return stopping || !queue.empty(); });
+                if (queue.empty())
+                    return;
+
+                while (!queue.empty() && batch.size() < maxBatch)
+                {
+                    batch.push_back(queue.front());
+                    queue.pop_front();
+                }
+            }
+
+            flush(batch);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (Request *request : batch)
+                {
+                    request->done = true;
+                }
+            }
+            completed.notify_all();
+            batch.clear();
+        }
     }
 
-    bool success = (reply->type != REDIS_REPLY_ERROR);
-    if (!success)
+    // 填充本批每个请求的回复，失败的请求回复为nullptr
+    void flush(std::vector<Request *> &batch)
     {
-        Logger::error("Redis SET命令错误: {}", reply->str);
+        Connection conn = manager.acquire();
+        if (!conn)
+            return;
+
+        size_t appended = 0;
+        for (; appended < batch.size(); ++appended)
+        {
+            Request *request = batch[appended];
+            if (redisAppendCommandArgv(conn.get(), request->argc, request->argv, request->argvlen) != REDIS_OK)
+            {
+                Logger::error("Redis流水线追加命令失败: {}", conn.get()->errstr);
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < appended; ++i)
+        {
+            void *reply = nullptr;
+            if (redisGetReply(conn.get(), &reply) != REDIS_OK)
+            {
+                // 连接已不可用，本批剩余命令都视为失败
+                Logger::error("Redis流水线读取回复失败: {}", conn.get()->errstr);
+                conn.discard();
+                manager.recordFailure();
+                break;
+            }
+            batch[i]->reply = static_cast<redisReply *>(reply);
+        }
+        if (appended > 0 && batch[appended - 1]->reply)
+        {
+            manager.recordSuccess();
+        }
+
+        manager.pipelineBatchCount.fetch_add(1, std::memory_order_relaxed);
+        manager.pipelinedCommandCount.fetch_add(batch.size(), std::memory_order_relaxed);
     }
+};
 
-    freeReplyObject(reply);
-    return success;
+RedisManager::RedisManager(const std::string &host, int port, const std::string &password)
+    : RedisManager(Options{host, port, password})
+{
 }
 
-std::string RedisManager::get(const std::string &key)
+RedisManager::RedisManager(const Options &options)
+    : options(options), slotCount(options.poolSize > 0 ? options.poolSize : std::max<size_t>(std::thread::hardware_concurrency(), 1)),
+      connected(false), connectCount(0), acquireTimeoutCount(0), pipelineBatchCount(0), pipelinedCommandCount(0),
+      breakerOpen(false), consecutiveFailures(0), breakerTripCount(0), bypassedCount(0), probeStopping(false),
+      trackingContext(nullptr), trackingStopping(false), trackingConnected(false), trackingClientId(0),
+      trackingGeneration(0), invalidationCount(0)
 {
-    if (!connected && !connect())
+    if (this->options.failureThreshold == 0)
     {
-        return "";
+        this->options.failureThreshold = 1;
     }
-
-    redisReply *reply = (redisReply *)redisCommand(context, "GET %s", key.c_str());
-    if (reply == nullptr)
+    if (this->options.initialBackoff.count() <= 0)
     {
-        Logger::error("Redis GET命令失败: {}", context->errstr);
-        reconnect();
-        return "";
+        this->options.initialBackoff = std::chrono::milliseconds(100);
     }
+    this->options.maxBackoff = std::max(this->options.maxBackoff, this->options.initialBackoff);
 
-    std::string result;
-    if (reply->type == REDIS_REPLY_STRING)
+    slots.reset(new Slot[slotCount]);
+    probeThread = std::thread(&RedisManager::probeLoop, this);
+    if (options.autoPipeline)
     {
-        result = std::string(reply->str, reply->len);
+        autoPipeline = std::make_unique<AutoPipeline>(*this, options.pipelineConnections, options.pipelineMaxBatch);
     }
-    else if (reply->type == REDIS_REPLY_NIL)
+}
+
+RedisManager::~RedisManager()
+{
+    // 先停止跟踪、刷写与探测线程，再关闭连接
     {
-        // 键不存在，返回空字符串
+        std::lock_guard<std::mutex> lock(trackingMutex);
+        trackingStopping = true;
+        // 跟踪线程阻塞在读取推送上，关闭套接字将其唤醒
+        if (trackingContext)
+        {
+            ::shutdown(trackingContext->fd, SHUT_RDWR);
+        }
     }
-    else
+    trackingCv.notify_all();
+    if (trackingThread.joinable())
     {
-        Logger::error("Redis GET命令错误: 类型 {}", reply->type);
+        trackingThread.join();
     }
 
-    freeReplyObject(reply);
-    return result;
+    autoPipeline.reset();
+    {
+        std::lock_guard<std::mutex> lock(probeMutex);
+        probeStopping = true;
+    }
+    probeCv.notify_all();
+    if (probeThread.joinable())
+    {
+        probeThread.join();
+    }
+    disconnect();
 }
 
-bool RedisManager::del(const std::string &key)
+redisContext *RedisManager::connectContext()
 {
-    if (!connected && !connect())
-    {
-        return false;
-    }
+    redisContext *context = redisConnectWithTimeout(options.host.c_str(), options.port, toTimeval(options.timeout));
 
-    redisReply *reply = (redisReply *)redisCommand(context, "DEL %s", key.c_str());
-    if (reply == nullptr)
+    if (context == nullptr || context->err)
     {
-        Logger::error("Redis DEL命令失败: {}", context->errstr);
-        reconnect();
-        return false;
+        if (context)
+        {
+            Logger::error("Redis连接错误: {}", context->errstr);
+            redisFree(context);
+        }
+        else
+        {
+            Logger::error("无法分配Redis连接");
+        }
+        return nullptr;
     }
 
-    bool success = (reply->type != REDIS_REPLY_ERROR);
-    if (!success)
+    // 命令超时与连接超时一致，避免Redis无响应时长期占用连接
+    redisSetTimeout(context, toTimeval(options.timeout));
+
+    // 如果设置了密码，进行认证
+    if (!options.password.empty())
     {
-        Logger::error("Redis DEL命令错误: {}", reply->str);
+        redisReply *reply = commandOn(context, {"AUTH", options.password});
+        if (reply == nullptr)
+        {
+            Logger::error("Redis AUTH命令失败: {}", context->errstr);
+            redisFree(context);
+            return nullptr;
+        }
+
+        bool authSuccess = (reply->type != REDIS_REPLY_ERROR);
+        freeReplyObject(reply);
+
+        if (!authSuccess)
+        {
+            Logger::error("Redis认证失败: 密码错误");
+            redisFree(context);
+            return nullptr;
+        }
     }
 
-    freeReplyObject(reply);
-    return success;
+    return context;
 }
 
-bool RedisManager::exists(const std::string &key)
+bool RedisManager::open(Slot &slot)
 {
-    if (!connected && !connect())
+    // 先读取代数：建连期间跟踪连接若重建，该连接会在下次借出时再次重连
+    uint64_t generation = trackingGeneration.load();
+    slot.context = connectContext();
+    if (!slot.context)
     {
+        connected = false;
+        recordFailure();
         return false;
     }
+    slot.generation = generation;
 
-    redisReply *reply = (redisReply *)redisCommand(context, "EXISTS %s", key.c_str());
-    if (reply == nullptr)
+    // Default模式：本连接读取的键由服务端跟踪，失效消息发往跟踪连接；
+    // 跟踪连接尚未建立时不开启，跟踪连接建立后代数变化会促使本连接重连
+    long long clientId = trackingClientId.load();
+    if (options.tracking == TrackingMode::Default && clientId > 0)
     {
-        Logger::error("Redis EXISTS命令失败: {}", context->errstr);
-        reconnect();
-        return false;
+        char id[24];
+        redisReply *reply = commandOn(slot.context, {"CLIENT", "TRACKING", "ON", "REDIRECT", formatInt(id, clientId)});
+        if (reply == nullptr || reply->type == REDIS_REPLY_ERROR)
+        {
+            Logger::warn("Redis开启客户端缓存跟踪失败: {}", reply ? reply->str : slot.context->errstr);
+        }
+        if (reply)
+            freeReplyObject(reply);
     }
 
-    bool exists = false;
-    if (reply->type == REDIS_REPLY_INTEGER)
+    connected = true;
+    ++connectCount;
+    Logger::debug("Redis连接池新建连接: {}:{}", options.host, options.port);
+    return true;
+}
+
+void RedisManager::recordSuccess()
+{
+    if (consecutiveFailures.load(std::memory_order_relaxed) != 0)
     {
-        exists = (reply->integer == 1);
+        consecutiveFailures.store(0, std::memory_order_relaxed);
     }
-    else
+}
+
+void RedisManager::recordFailure()
+{
+    uint32_t failures = consecutiveFailures.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (failures >= options.failureThreshold)
     {
-        Logger::error("Redis EXISTS命令错误: 类型 {}", reply->type);
+        openBreaker();
     }
-
-    freeReplyObject(reply);
-    return exists;
 }
 
-bool RedisManager::expire(const std::string &key, int seconds)
+void RedisManager::openBreaker()
 {
-    if (!connected && !connect())
+    if (breakerOpen.exchange(true))
+        return;
+
+    ++breakerTripCount;
+    Logger::warn("Redis不可用，熔断器打开，缓存暂时旁路: {}:{}", options.host, options.port);
     {
-        return false;
+        std::lock_guard<std::mutex> lock(probeMutex);
     }
+    probeCv.notify_one();
+}
 
-    redisReply *reply = (redisReply *)redisCommand(context, "EXPIRE %s %d", key.c_str(), seconds);
-    if (reply == nullptr)
-    {
-        Logger::error("Redis EXPIRE命令失败: {}", context->errstr);
-        reconnect();
+bool RedisManager::probe()
+{
+    redisContext *context = connectContext();
+    if (!context)
         return false;
+
+    redisReply *reply = commandOn(context, {"PING"});
+    bool healthy = reply != nullptr && reply->type == REDIS_REPLY_STATUS &&
+                   std::string_view(reply->str, reply->len) == "PONG";
+    if (reply)
+        freeReplyObject(reply);
+    redisFree(context);
+    return healthy;
+}
+
+void RedisManager::probeLoop()
+{
+    std::unique_lock<std::mutex> lock(probeMutex);
+    while (!probeStopping)
+    {
+        probeCv.wait(lock, [this]
+                     { return probeStopping || breakerOpen.load(); });
+
+        // 熔断期间按指数退避探测，PING成功后关闭熔断器
+        std::chrono::milliseconds backoff = options.initialBackoff;
+        while (!probeStopping && breakerOpen.load())
+        {
+            if (probeCv.wait_for(lock, backoff, [this]
+                                 { return probeStopping; }))
+                break;
+
+            lock.unlock();
+            bool healthy = probe();
+            lock.lock();
+
+            if (healthy)
+            {
+                consecutiveFailures.store(0);
+                breakerOpen.store(false);
+                connected = true;
+                Logger::info("Redis探测成功，熔断器关闭: {}:{}", options.host, options.port);
+            }
+            else
+            {
+                backoff = std::min(backoff * 2, options.maxBackoff);
+                Logger::debug("Redis探测失败，{} 毫秒后重试", backoff.count());
+            }
+        }
     }
+}
 
-    bool success = (reply->type != REDIS_REPLY_ERROR);
-    if (!success)
+RedisManager::Connection RedisManager::acquire()
+{
+    // 熔断期间直接旁路，不再等待建连超时
+    if (breakerOpen.load(std::memory_order_relaxed))
     {
-        Logger::error("Redis EXPIRE命令错误: {}", reply->str);
+        ++bypassedCount;
+        return Connection();
     }
 
-    freeReplyObject(reply);
-    return success;
+    auto deadline = std::chrono::steady_clock::now() + options.acquireTimeout;
+    size_t start = threadSlotHint() % slotCount;
+
+    for (unsigned attempt = 0;; ++attempt)
+    {
+        for (size_t i = 0; i < slotCount; ++i)
+        {
+            Slot &slot = slots[(start + i) % slotCount];
+            if (slot.busy.load(std::memory_order_relaxed) || slot.busy.exchange(true, std::memory_order_acquire))
+                continue;
+
+            if (slot.context && options.tracking == TrackingMode::Default &&
+                slot.generation != trackingGeneration.load(std::memory_order_relaxed))
+            {
+                redisFree(slot.context);
+                slot.context = nullptr;
+            }
+
+            if (!slot.context && !open(slot))
+            {
+                slot.busy.store(false, std::memory_order_release);
+                return Connection();
+            }
+            return Connection(&slot);
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            ++acquireTimeoutCount;
+            Logger::warn("Redis连接池繁忙，获取连接超时");
+            return Connection();
+        }
+
+        // 所有连接都被占用：先让出CPU，持续繁忙时短暂休眠
+        if (attempt < 16)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
 }
 
-bool RedisManager::hset(const std::string &key, const std::string &field, const std::string &value)
+bool RedisManager::connect()
 {
-    if (!connected && !connect())
+    Connection conn = acquire();
+    if (!conn)
     {
+        // 启动时即不可用则直接熔断，由后台线程负责重连
+        openBreaker();
         return false;
     }
 
-    redisReply *reply = (redisReply *)redisCommand(context, "HSET %s %s %s",
-                                                   key.c_str(), field.c_str(), value.c_str());
-    if (reply == nullptr)
+    Logger::info("Redis连接成功: {}:{}，连接池大小: {}", options.host, options.port, slotCount);
+    return true;
+}
+
+void RedisManager::disconnect()
+{
+    for (size_t i = 0; i < slotCount; ++i)
     {
-        Logger::error("Redis HSET命令失败: {}", context->errstr);
-        reconnect();
-        return false;
+        Slot &slot = slots[i];
+        if (slot.busy.exchange(true, std::memory_order_acquire))
+            continue;
+
+        if (slot.context)
+        {
+            redisFree(slot.context);
+            slot.context = nullptr;
+        }
+        slot.busy.store(false, std::memory_order_release);
     }
+    connected = false;
+}
 
-    bool success = (reply->type != REDIS_REPLY_ERROR);
-    if (!success)
+RedisManager::Stats RedisManager::getStats() const
+{
+    Stats stats;
+    stats.poolSize = slotCount;
+    for (size_t i = 0; i < slotCount; ++i)
     {
-        Logger::error("Redis HSET命令错误: {}", reply->str);
+        if (slots[i].busy.load(std::memory_order_relaxed))
+            ++stats.inUse;
     }
-
-    freeReplyObject(reply);
-    return success;
+    stats.connects = connectCount.load();
+    stats.acquireTimeouts = acquireTimeoutCount.load();
+    stats.pipelineBatches = pipelineBatchCount.load();
+    stats.pipelinedCommands = pipelinedCommandCount.load();
+    stats.breakerOpen = breakerOpen.load();
+    stats.consecutiveFailures = consecutiveFailures.load();
+    stats.breakerTrips = breakerTripCount.load();
+    stats.bypassed = bypassedCount.load();
+    stats.trackingConnected = trackingConnected.load();
+    stats.invalidations = invalidationCount.load();
+    return stats;
 }
 
-std::string RedisManager::hget(const std::string &key, const std::string &field)
+void RedisManager::setInvalidationListener(InvalidationListener listener)
 {
-    if (!connected && !connect())
+    invalidationListener = std::move(listener);
+    if (options.tracking != TrackingMode::Off && invalidationListener && !trackingThread.joinable())
     {
-        return "";
+        trackingThread = std::thread(&RedisManager::trackingLoop, this);
     }
+}
 
-    redisReply *reply = (redisReply *)redisCommand(context, "HGET %s %s", key.c_str(), field.c_str());
-    if (reply == nullptr)
+redisContext *RedisManager::openTrackingContext()
+{
+    redisContext *context = connectContext();
+    if (!context)
+        return nullptr;
+
+    // 推送消息由redisGetReply直接返回，不交给hiredis默认的自动释放回调
+    redisSetPushCallback(context, nullptr);
+
+    auto succeeded = [context](redisReply *reply, const char *what)
+    {
+        bool ok = reply != nullptr && reply->type != REDIS_REPLY_ERROR;
+        if (!ok)
+        {
+            Logger::error("Redis跟踪连接{}失败: {}", what, reply ? reply->str : context->errstr);
+        }
+        if (reply)
+            freeReplyObject(reply);
+        return ok;
+    };
+
+    // 推送消息需要RESP3（Redis 6及以上）
+    if (!succeeded(commandOn(context, {"HELLO", "3"}), "切换RESP3"))
     {
-        Logger::error("Redis HGET命令失败: {}", context->errstr);
-        reconnect();
-        return "";
+        redisFree(context);
+        return nullptr;
     }
 
-    std::string result;
-    if (reply->type == REDIS_REPLY_STRING)
+    long long clientId = 0;
+    redisReply *reply = commandOn(context, {"CLIENT", "ID"});
+    if (reply && reply->type == REDIS_REPLY_INTEGER)
     {
-        result = std::string(reply->str, reply->len);
+        clientId = reply->integer;
     }
-    else if (reply->type == REDIS_REPLY_NIL)
+    if (!succeeded(reply, "获取CLIENT ID") || clientId <= 0)
     {
-        // 字段不存在，返回空字符串
+        redisFree(context);
+        return nullptr;
     }
-    else
+
+    if (options.tracking == TrackingMode::Broadcast)
     {
-        Logger::error("Redis HGET命令错误: 类型 {}", reply->type);
+        bool ok = options.trackingPrefix.empty()
+                      ? succeeded(commandOn(context, {"CLIENT", "TRACKING", "ON", "BCAST"}), "开启广播跟踪")
+                      : succeeded(commandOn(context, {"CLIENT", "TRACKING", "ON", "BCAST", "PREFIX", options.trackingPrefix}), "开启广播跟踪");
+        if (!ok)
+        {
+            redisFree(context);
+            return nullptr;
+        }
     }
 
-    freeReplyObject(reply);
-    return result;
+    // 跟踪连接只等待推送，不设读取超时；关闭时由析构函数关闭套接字唤醒
+    redisSetTimeout(context, toTimeval(std::chrono::milliseconds(0)));
+    trackingClientId = clientId;
+    return context;
 }
 
-bool RedisManager::hdel(const std::string &key, const std::string &field)
+void RedisManager::trackingLoop()
 {
-    if (!connected && !connect())
+    std::chrono::milliseconds backoff = options.initialBackoff;
+    while (true)
     {
-        return false;
-    }
+        {
+            std::lock_guard<std::mutex> lock(trackingMutex);
+            if (trackingStopping)
+                break;
+        }
 
-    redisReply *reply = (redisReply *)redisCommand(context, "HDEL %s %s", key.c_str(), field.c_str());
-    if (reply == nullptr)
-    {
-        Logger::error("Redis HDEL命令失败: {}", context->errstr);
-        reconnect();
-        return false;
+        redisContext *context = openTrackingContext();
+        {
+            std::unique_lock<std::mutex> lock(trackingMutex);
+            if (trackingStopping)
+            {
+                if (context)
+                    redisFree(context);
+                break;
+            }
+            if (!context)
+            {
+                trackingCv.wait_for(lock, backoff, [this]
+                                    { return trackingStopping; });
+                backoff = std::min(backoff * 2, options.maxBackoff);
+                continue;
+            }
+            trackingContext = context;
+        }
+
+        backoff = options.initialBackoff;
+        // 新的跟踪连接建立前缓存的内容无人跟踪，全部丢弃；Default模式下池中连接需重定向到新连接
+        ++trackingGeneration;
+        trackingConnected = true;
+        invalidationListener({});
+        Logger::info("Redis客户端缓存跟踪已开启，模式: {}",
+                     options.tracking == TrackingMode::Broadcast ? "broadcast" : "default");
+
+        void *reply = nullptr;
+        while (redisGetReply(context, &reply) == REDIS_OK)
+        {
+            handlePush(static_cast<redisReply *>(reply));
+            freeReplyObject(reply);
+            reply = nullptr;
+        }
+
+        trackingConnected = false;
+        trackingClientId = 0;
+        bool stopping;
+        {
+            std::lock_guard<std::mutex> lock(trackingMutex);
+            trackingContext = nullptr;
+            stopping = trackingStopping;
+        }
+        if (stopping)
+        {
+            redisFree(context);
+            break;
+        }
+
+        Logger::warn("Redis跟踪连接断开: {}", context->errstr);
+        redisFree(context);
+
+        // 断开期间可能漏掉失效消息
+        invalidationListener({});
     }
+}
+
+void RedisManager::handlePush(redisReply *reply)
+{
+    if (reply == nullptr || (reply->type != REDIS_REPLY_PUSH && reply->type != REDIS_REPLY_ARRAY) || reply->elements < 2)
+        return;
 
-    bool success = (reply->type != REDIS_REPLY_ERROR);
-    if (!success)
+    // 失效消息为 ["invalidate", [key...]]；键列表为空回复表示FLUSHALL/FLUSHDB
+    redisReply *kind = reply->element[0];
+    if (kind->type != REDIS_REPLY_STRING || std::string_view(kind->str, kind->len) != "invalidate")
+        return;
+
+    redisReply *keys = reply->element[1];
+    std::vector<std::string_view> invalidated;
+    if (keys->type == REDIS_REPLY_ARRAY)
     {
-        Logger::error("Redis HDEL命令错误: {}", reply->str);
+        invalidated.reserve(keys->elements);
+        for (size_t i = 0; i < keys->elements; ++i)
+        {
+            redisReply *key = keys->element[i];
+            if (key->type == REDIS_REPLY_STRING)
+                invalidated.emplace_back(key->str, key->len);
+        }
+        if (invalidated.empty())
+            return;
     }
 
-    freeReplyObject(reply);
-    return success;
+    invalidationCount += invalidated.empty() ? 1 : invalidated.size();
+    invalidationListener(invalidated);
 }
 
-bool RedisManager::lpush(const std::string &key, const std::string &value)
+redisReply *RedisManager::command(int argc, const char **argv, const size_t *argvlen)
 {
-    if (!connected && !connect())
+    std::string_view name(argv[0], argvlen[0]);
+    if (autoPipeline)
     {
-        return false;
+        if (breakerOpen.load(std::memory_order_relaxed))
+        {
+            ++bypassedCount;
+            return nullptr;
+        }
+
+        // 连接失败已由刷写线程计入熔断器
+        redisReply *reply = autoPipeline->submit(argc, argv, argvlen);
+        if (reply == nullptr)
+        {
+            Logger::debug("Redis {}命令失败: 流水线连接不可用", name);
+        }
+        return reply;
     }
 
-    redisReply *reply = (redisReply *)redisCommand(context, "LPUSH %s %s", key.c_str(), value.c_str());
-    if (reply == nullptr)
+    Connection conn = acquire();
+    if (!conn)
     {
-        Logger::error("Redis LPUSH命令失败: {}", context->errstr);
-        reconnect();
-        return false;
+        return nullptr;
     }
 
-    bool success = (reply->type != REDIS_REPLY_ERROR);
-    if (!success)
+    redisReply *reply = (redisReply *)redisCommandArgv(conn.get(), argc, argv, argvlen);
+    if (reply == nullptr)
     {
-        Logger::error("Redis LPUSH命令错误: {}", reply->str);
+        Logger::error("Redis {}命令失败: {}", name, conn.get()->errstr);
+        conn.discard();
+        recordFailure();
+        return nullptr;
     }
 
-    freeReplyObject(reply);
-    return success;
+    recordSuccess();
+    return reply;
 }
 
-bool RedisManager::rpush(const std::string &key, const std::string &value)
+redisReply *RedisManager::command(std::initializer_list<std::string_view> args)
 {
-    if (!connected && !connect())
+    if (args.size() > kInlineArgs)
     {
-        return false;
+        Logger::error("Redis命令参数过多: {}", args.size());
+        return nullptr;
     }
 
-    redisReply *reply = (redisReply *)redisCommand(context, "RPUSH %s %s", key.c_str(), value.c_str());
-    if (reply == nullptr)
+    // 参数数组在栈上组装，命令执行期间参数视图保持有效
+    const char *argv[kInlineArgs];
+    size_t argvlen[kInlineArgs];
+    int argc = 0;
+    for (std::string_view arg : args)
     {
-        Logger::error("Redis RPUSH命令失败: {}", context->errstr);
-        reconnect();
-        return false;
+        argv[argc] = arg.data();
+        argvlen[argc] = arg.size();
+        ++argc;
     }
+    return command(argc, argv, argvlen);
+}
+
+size_t RedisManager::Pipeline::get(std::string_view key)
+{
+    return command({"GET", key});
+}
 
-    bool success = (reply->type != REDIS_REPLY_ERROR);
-    if (!success)
+size_t RedisManager::Pipeline::set(std::string_view key, std::string_view value, int expireSeconds)
+{
+    if (expireSeconds > 0)
     {
-        Logger::error("Redis RPUSH命令错误: {}", reply->str);
+        char seconds[24];
+        return command({"SETEX", key, formatInt(seconds, expireSeconds), value});
     }
-
-    freeReplyObject(reply);
-    return success;
+    return command({"SET", key, value});
 }
 
-std::vector<std::string> RedisManager::lrange(const std::string &key, int start, int end)
+size_t RedisManager::Pipeline::del(std::string_view key)
 {
-    std::vector<std::string> result;
+    return command({"DEL", key});
+}
 
-    if (!connected && !connect())
+size_t RedisManager::Pipeline::command(std::initializer_list<std::string_view> args)
+{
+    for (std::string_view arg : args)
     {
-        return result;
+        arguments.emplace_back(arg);
     }
+    argc.push_back(args.size());
+    return argc.size() - 1;
+}
 
-    redisReply *reply = (redisReply *)redisCommand(context, "LRANGE %s %d %d", key.c_str(), start, end);
-    if (reply == nullptr)
+std::vector<RedisResult> RedisManager::Pipeline::execute()
+{
+    std::vector<RedisResult> results(argc.size());
+    if (argc.empty())
+        return results;
+
+    std::vector<const char *> argv(arguments.size());
+    std::vector<size_t> argvlen(arguments.size());
+    for (size_t i = 0; i < arguments.size(); ++i)
     {
-        Logger::error("Redis LRANGE命令失败: {}", context->errstr);
-        reconnect();
-        return result;
+        argv[i] = arguments[i].data();
+        argvlen[i] = arguments[i].size();
     }
 
-    if (reply->type == REDIS_REPLY_ARRAY)
+    RedisManager::Connection conn = manager->acquire();
+    if (conn)
     {
-        for (size_t i = 0; i < reply->elements; i++)
+        // 先全部追加到输出缓冲，读取第一条回复时一次写出
+        size_t appended = 0;
+        size_t offset = 0;
+        for (; appended < argc.size(); ++appended)
         {
-            redisReply *element = reply->element[i];
-            if (element->type == REDIS_REPLY_STRING)
+            if (redisAppendCommandArgv(conn.get(), static_cast<int>(argc[appended]), argv.data() + offset, argvlen.data() + offset) != REDIS_OK)
             {
-                result.push_back(std::string(element->str, element->len));
+                Logger::error("Redis流水线追加命令失败: {}", conn.get()->errstr);
+                break;
             }
+            offset += argc[appended];
         }
-    }
-    else if (reply->type != REDIS_REPLY_ERROR)
-    {
-        Logger::error("Redis LRANGE命令错误: 类型 {}", reply->type);
+
+        for (size_t i = 0; i < appended; ++i)
+        {
+            void *reply = nullptr;
+            if (redisGetReply(conn.get(), &reply) != REDIS_OK)
+            {
+                Logger::error("Redis流水线读取回复失败: {}", conn.get()->errstr);
+                conn.discard();
+                manager->recordFailure();
+                break;
+            }
+            results[i] = toResult(static_cast<redisReply *>(reply));
+        }
+        if (appended > 0 && conn.get())
+        {
+            manager->recordSuccess();
+        }
+
+        manager->pipelineBatchCount.fetch_add(1, std::memory_order_relaxed);
+        manager->pipelinedCommandCount.fetch_add(argc.size(), std::memory_order_relaxed);
     }
 
-    freeReplyObject(reply);
-    return result;
+    arguments.clear();
+    argc.clear();
+    return results;
 }
 
-bool RedisManager::sadd(const std::string &key, const std::string &member)
+bool RedisManager::set(const std::string &key, const std::string &value, int expireSeconds)
 {
-    if (!connected && !connect())
+    if (expireSeconds > 0)
     {
-        return false;
+        char seconds[24];
+        return replySucceeded(command({"SETEX", key, formatInt(seconds, expireSeconds), value}), "SETEX");
     }
+    return replySucceeded(command({"SET", key, value}), "SET");
+}
 
-    redisReply *reply = (redisReply *)redisCommand(context, "SADD %s %s", key.c_str(), member.c_str());
+bool RedisManager::setIfAbsent(std::string_view key, std::string_view value, int expireSeconds)
+{
+    char seconds[24];
+    redisReply *reply = expireSeconds > 0 ? command({"SET", key, value, "EX", formatInt(seconds, expireSeconds), "NX"})
+                                          : command({"SET", key, value, "NX"});
     if (reply == nullptr)
     {
-        Logger::error("Redis SADD命令失败: {}", context->errstr);
-        reconnect();
         return false;
     }
 
-    bool success = (reply->type != REDIS_REPLY_ERROR);
-    if (!success)
+    // 键已存在时回复nil，不视为错误
+    bool stored = reply->type == REDIS_REPLY_STATUS;
+    if (reply->type == REDIS_REPLY_ERROR)
     {
-        Logger::error("Redis SADD命令错误: {}", reply->str);
+        Logger::error("Redis SET NX命令错误: {}", std::string_view(reply->str, reply->len));
     }
-
     freeReplyObject(reply);
-    return success;
+    return stored;
 }
 
-bool RedisManager::srem(const std::string &key, const std::string &member)
+bool RedisManager::compareAndSet(std::string_view key, std::string_view expected, std::string_view value, int expireSeconds)
 {
-    if (!connected && !connect())
+    static constexpr std::string_view script =
+        "if redis.call('GET', KEYS[1]) ~= ARGV[1] then return false end "
+        "if ARGV[3] == '0' then return redis.call('SET', KEYS[1], ARGV[2]) end "
+        "return redis.call('SET', KEYS[1], ARGV[2], 'EX', ARGV[3])";
+
+    char seconds[24];
+    redisReply *reply = command({"EVAL", script, "1", key, expected, value, formatInt(seconds, expireSeconds > 0 ? expireSeconds : 0)});
+    if (reply == nullptr)
     {
         return false;
     }
 
-    redisReply *reply = (redisReply *)redisCommand(context, "SREM %s %s", key.c_str(), member.c_str());
+    // 值已改变时脚本返回false（nil），不视为错误
+    bool stored = reply->type == REDIS_REPLY_STATUS;
+    if (reply->type == REDIS_REPLY_ERROR)
+    {
+        Logger::error("Redis EVAL命令错误: {}", std::string_view(reply->str, reply->len));
+    }
+    freeReplyObject(reply);
+    return stored;
+}
+
+std::string RedisManager::get(const std::string &key)
+{
+    return stringReply(command({"GET", key}), "GET");
+}
+
+bool RedisManager::get(std::string_view key, const std::function<void(std::string_view)> &consumer)
+{
+    redisReply *reply = command({"GET", key});
     if (reply == nullptr)
     {
-        Logger::error("Redis SREM命令失败: {}", context->errstr);
-        reconnect();
         return false;
     }
 
-    bool success = (reply->type != REDIS_REPLY_ERROR);
-    if (!success)
+    bool found = reply->type == REDIS_REPLY_STRING;
+    if (found)
+    {
+        consumer(std::string_view(reply->str, reply->len));
+    }
+    else if (reply->type != REDIS_REPLY_NIL)
     {
-        Logger::error("Redis SREM命令错误: {}", reply->str);
+        Logger::error("Redis GET命令错误: 类型 {}", reply->type);
     }
 
     freeReplyObject(reply);
-    return success;
+    return found;
 }
 
-std::vector<std::string> RedisManager::smembers(const std::string &key)
+bool RedisManager::del(const std::string &key)
 {
-    std::vector<std::string> result;
-
-    if (!connected && !connect())
-    {
-        return result;
-    }
+    return replySucceeded(command({"DEL", key}), "DEL");
+}
 
-    redisReply *reply = (redisReply *)redisCommand(context, "SMEMBERS %s", key.c_str());
+bool RedisManager::exists(const std::string &key)
+{
+    redisReply *reply = command({"EXISTS", key});
     if (reply == nullptr)
     {
-        Logger::error("Redis SMEMBERS命令失败: {}", context->errstr);
-        reconnect();
-        return result;
+        return false;
     }
 
-    if (reply->type == REDIS_REPLY_ARRAY)
+    bool exists = false;
+    if (reply->type == REDIS_REPLY_INTEGER)
     {
-        for (size_t i = 0; i < reply->elements; i++)
-        {
-            redisReply *element = reply->element[i];
-            if (element->type == REDIS_REPLY_STRING)
-            {
-                result.push_back(std::string(element->str, element->len));
-            }
-        }
+        exists = (reply->integer == 1);
     }
-    else if (reply->type != REDIS_REPLY_ERROR)
+    else
     {
-        Logger::error("Redis SMEMBERS命令错误: 类型 {}", reply->type);
+        Logger::error("Redis EXISTS命令错误: 类型 {}", reply->type);
     }
 
     freeReplyObject(reply);
-    return result;
+    return exists;
 }
 
-bool RedisManager::ping()
+bool RedisManager::expire(const std::string &key, int seconds)
+{
+    char buffer[24];
+    return replySucceeded(command({"EXPIRE", key, formatInt(buffer, seconds)}), "EXPIRE");
+}
+
+bool RedisManager::incrBy(std::string_view key, long long delta, long long &value)
 {
-    if (!connected && !connect())
+    char buffer[24];
+    redisReply *reply = command({"INCRBY", key, formatInt(buffer, delta)});
+    if (reply == nullptr)
     {
         return false;
     }
 
-    redisReply *reply = (redisReply *)redisCommand(context, "PING");
+    bool success = reply->type == REDIS_REPLY_INTEGER;
+    if (success)
+    {
+        value = reply->integer;
+    }
+    else if (reply->type == REDIS_REPLY_ERROR)
+    {
+        Logger::error("Redis INCRBY命令错误: {}", std::string_view(reply->str, reply->len));
+    }
+    freeReplyObject(reply);
+    return success;
+}
+
+bool RedisManager::hset(const std::string &key, const std::string &field, const std::string &value)
+{
+    return replySucceeded(command({"HSET", key, field, value}), "HSET");
+}
+
+std::string RedisManager::hget(const std::string &key, const std::string &field)
+{
+    return stringReply(command({"HGET", key, field}), "HGET");
+}
+
+bool RedisManager::hdel(const std::string &key, const std::string &field)
+{
+    return replySucceeded(command({"HDEL", key, field}), "HDEL");
+}
+
+bool RedisManager::lpush(const std::string &key, const std::string &value)
+{
+    return replySucceeded(command({"LPUSH", key, value}), "LPUSH");
+}
+
+bool RedisManager::rpush(const std::string &key, const std::string &value)
+{
+    return replySucceeded(command({"RPUSH", key, value}), "RPUSH");
+}
+
+std::vector<std::string> RedisManager::lrange(const std::string &key, int start, int end)
+{
+    char startBuffer[24];
+    char endBuffer[24];
+    return arrayReply(command({"LRANGE", key, formatInt(startBuffer, start), formatInt(endBuffer, end)}), "LRANGE");
+}
+
+bool RedisManager::sadd(const std::string &key, const std::string &member)
+{
+    return replySucceeded(command({"SADD", key, member}), "SADD");
+}
+
+bool RedisManager::srem(const std::string &key, const std::string &member)
+{
+    return replySucceeded(command({"SREM", key, member}), "SREM");
+}
+
+std::vector<std::string> RedisManager::smembers(const std::string &key)
+{
+    return arrayReply(command({"SMEMBERS", key}), "SMEMBERS");
+}
+
+bool RedisManager::ping()
+{
+    redisReply *reply = command({"PING"});
     if (reply == nullptr)
     {
-        Logger::error("Redis PING命令失败: {}", context->errstr);
-        reconnect();
         return false;
     }
 
@@ -514,3 +1149,4 @@ bool RedisManager::ping()
     freeReplyObject(reply);
     return success;
 }
+
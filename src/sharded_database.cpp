@@ -0,0 +1,441 @@
+#include "sharded_database.h"
+#include <filesystem>
+#include <future>
+#include <algorithm>
+#include "logger.h"
+
+namespace
+{
+    // 批量导入时每批分发到各分片的行数
+    const size_t kImportBatchSize = 10000;
+}
+
+ShardedDatabase::ShardedDatabase(const ConfigManager &configManager)
+    : directory(configManager.getShardedDirectory()),
+      shardCount(std::min(std::max<size_t>(configManager.getShardCount(), 1), kMaxShards)),
+      threadCount(configManager.getShardThreads()),
+      nextShard(0)
+{
+    if (threadCount == 0)
+    {
+        threadCount = shardCount;
+    }
+}
+
+ShardedDatabase::~ShardedDatabase()
+{
+    close();
+}
+
+bool ShardedDatabase::open()
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        Logger::error("无法创建分片目录 {}: {}", directory, error.message());
+        return false;
+    }
+
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        auto shard = std::make_unique<Shard>();
+        std::string path = directory + "/students_" + std::to_string(i) + ".db";
+        shard->database = std::make_unique<SQLiteDatabase>(path, static_cast<int>(i) * kShardIdRange);
+        if (!shard->database->open())
+        {
+            Logger::error("打开分片 {} 失败", i);
+            close();
+            return false;
+        }
+        shards.push_back(std::move(shard));
+    }
+
+    pool = std::make_unique<ThreadPool>(threadCount);
+
+    Logger::info("分片数据库已打开，分片数: {}，线程数: {}", shardCount, threadCount);
+    return true;
+}
+
+void ShardedDatabase::close()
+{
+    if (pool)
+    {
+        pool->shutdown();
+        pool.reset();
+    }
+
+    for (auto &shard : shards)
+    {
+        shard->database->close();
+    }
+    shards.clear();
+}
+
+int ShardedDatabase::shardIndex(int id) const
+{
+    if (id <= 0)
+        return -1;
+
+    size_t index = static_cast<size_t>((id - 1) / kShardIdRange);
+    return index < shards.size() ? static_cast<int>(index) : -1;
+}
+
+std::vector<std::vector<int>> ShardedDatabase::groupByShard(const std::vector<int> &ids) const
+{
+    std::vector<std::vector<int>> groups(shards.size());
+    for (int id : ids)
+    {
+        int index = shardIndex(id);
+        if (index >= 0)
+        {
+            groups[index].push_back(id);
+        }
+    }
+    return groups;
+}
+
+int ShardedDatabase::insertInto(size_t index, const Student &student)
+{
+    Shard &shard = *shards[index];
+    std::lock_guard<std::mutex> lock(shard.writeMutex);
+
+    int id = shard.database->addStudent(student);
+    if (id > 0 && shardIndex(id) != static_cast<int>(index))
+    {
+        Logger::error("分片 {} 的id区间已耗尽，插入被回滚", index);
+        shard.database->deleteStudent(id);
+        return -1;
+    }
+    return id;
+}
+
+int ShardedDatabase::addStudent(const Student &student)
+{
+    if (shards.empty())
+    {
+        Logger::error("分片数据库未打开");
+        return -1;
+    }
+
+    // 新记录轮流写入各分片
+    return insertInto(nextShard++ % shards.size(), student);
+}
+
+bool ShardedDatabase::updateStudent(int id, const Student &student)
+{
+    int index = shardIndex(id);
+    if (index < 0)
+        return false;
+
+    Shard &shard = *shards[index];
+    std::lock_guard<std::mutex> lock(shard.writeMutex);
+    return shard.database->updateStudent(id, student);
+}
+
+bool ShardedDatabase::deleteStudent(int id)
+{
+    int index = shardIndex(id);
+    if (index < 0)
+        return false;
+
+    Shard &shard = *shards[index];
+    std::lock_guard<std::mutex> lock(shard.writeMutex);
+    return shard.database->deleteStudent(id);
+}
+
+Student ShardedDatabase::getStudent(int id)
+{
+    int index = shardIndex(id);
+    if (index < 0)
+        return Student();
+
+    return shards[index]->database->getStudent(id);
+}
+
+StudentBatch ShardedDatabase::getAllStudents()
+{
+    std::vector<std::future<StudentBatch>> futures;
+    futures.reserve(shards.size());
+    for (auto &shard : shards)
+    {
+        SQLiteDatabase *database = shard->database.get();
+        futures.push_back(pool->submit([database]()
+                                       { return database->getAllStudents(); }));
+    }
+
+    // 分片按id区间排列，依次拼接即为整体顺序
+    return mergeBatches(futures);
+}
+
+int ShardedDatabase::getStudentCount()
+{
+    std::vector<std::future<int>> futures;
+    futures.reserve(shards.size());
+    for (auto &shard : shards)
+    {
+        SQLiteDatabase *database = shard->database.get();
+        futures.push_back(pool->submit([database]()
+                                       { return database->getStudentCount(); }));
+    }
+
+    int total = 0;
+    bool failed = shards.empty();
+    for (auto &future : futures)
+    {
+        int count = future.get();
+        if (count < 0)
+            failed = true;
+        else
+            total += count;
+    }
+    return failed ? -1 : total;
+}
+
+long long ShardedDatabase::getMaxStudentId()
+{
+    std::vector<std::future<long long>> futures;
+    futures.reserve(shards.size());
+    for (auto &shard : shards)
+    {
+        SQLiteDatabase *database = shard->database.get();
+        futures.push_back(pool->submit([database]()
+                                       { return database->getMaxStudentId(); }));
+    }
+
+    long long maxId = shards.empty() ? -1 : 0;
+    for (auto &future : futures)
+    {
+        long long shardMax = future.get();
+        if (shardMax < 0 || maxId < 0)
+            maxId = -1;
+        else
+            maxId = std::max(maxId, shardMax);
+    }
+    return maxId;
+}
+
+StudentBatch ShardedDatabase::getStudents(const std::vector<int> &ids)
+{
+    std::vector<std::vector<int>> groups = groupByShard(ids);
+
+    std::vector<std::future<StudentBatch>> futures;
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        if (groups[i].empty())
+            continue;
+
+        SQLiteDatabase *database = shards[i]->database.get();
+        std::vector<int> group = std::move(groups[i]);
+        futures.push_back(pool->submit([database, group]()
+                                       { return database->getStudents(group); }));
+    }
+
+    return mergeBatches(futures);
+}
+
+std::vector<int> ShardedDatabase::addStudents(const std::vector<Student> &students)
+{
+    std::vector<int> ids(students.size(), -1);
+    if (students.empty() || shards.empty())
+        return ids;
+
+    // 轮流分配到各分片，每个分片在单个事务内批量插入
+    size_t start = nextShard.fetch_add(students.size());
+    std::vector<std::vector<size_t>> positions(shards.size());
+    for (size_t i = 0; i < students.size(); ++i)
+    {
+        positions[(start + i) % shards.size()].push_back(i);
+    }
+
+    std::vector<std::future<void>> futures;
+    for (size_t index = 0; index < shards.size(); ++index)
+    {
+        if (positions[index].empty())
+            continue;
+
+        futures.push_back(pool->submit([this, index, &positions, &students, &ids]()
+                                       {
+            Shard &shard = *shards[index];
+            std::vector<Student> batch;
+            batch.reserve(positions[index].size());
+            for (size_t position : positions[index])
+            {
+                batch.push_back(students[position]);
+            }
+
+            std::lock_guard<std::mutex> lock(shard.writeMutex);
+            std::vector<int> inserted = shard.database->addStudents(batch);
+            for (size_t i = 0; i < inserted.size() && i < positions[index].size(); ++i)
+            {
+                int id = inserted[i];
+                if (id > 0 && shardIndex(id) != static_cast<int>(index))
+                {
+                    Logger::error("分片 {} 的id区间已耗尽，插入被回滚", index);
+                    shard.database->deleteStudent(id);
+                    id = -1;
+                }
+                ids[positions[index][i]] = id;
+            } }));
+    }
+
+    for (auto &future : futures)
+    {
+        future.get();
+    }
+    return ids;
+}
+
+int ShardedDatabase::deleteStudents(const std::vector<int> &ids)
+{
+    std::vector<std::vector<int>> groups = groupByShard(ids);
+
+    std::vector<std::future<int>> futures;
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        if (groups[i].empty())
+            continue;
+
+        Shard *shard = shards[i].get();
+        std::vector<int> group = std::move(groups[i]);
+        futures.push_back(pool->submit([shard, group]()
+                                       {
+            std::lock_guard<std::mutex> lock(shard->writeMutex);
+            return shard->database->deleteStudents(group); }));
+    }
+
+    int deleted = 0;
+    for (auto &future : futures)
+    {
+        int count = future.get();
+        if (count > 0)
+        {
+            deleted += count;
+        }
+    }
+    return deleted;
+}
+
+long long ShardedDatabase::importStudents(const StudentSource &source)
+{
+    // 各分片按批独立提交；任一批失败时删除已导入的记录，不留下部分导入的数据
+    std::vector<int> inserted;
+    std::vector<Student> batch;
+    batch.reserve(kImportBatchSize);
+
+    auto flush = [this, &batch, &inserted]()
+    {
+        bool success = true;
+        for (int id : addStudents(batch))
+        {
+            if (id > 0)
+            {
+                inserted.push_back(id);
+            }
+            else
+            {
+                success = false;
+            }
+        }
+        batch.clear();
+        return success;
+    };
+
+    bool failed = false;
+    Student student;
+    while (!failed && source(student))
+    {
+        batch.push_back(student);
+        if (batch.size() >= kImportBatchSize)
+        {
+            failed = !flush();
+        }
+    }
+
+    if (!failed && !batch.empty())
+    {
+        failed = !flush();
+    }
+
+    if (failed)
+    {
+        int removed = deleteStudents(inserted);
+        Logger::error("分片批量导入失败，已删除已导入的 {}/{} 行", removed, inserted.size());
+        return -1;
+    }
+
+    Logger::info("分片批量导入完成，数量: {}", inserted.size());
+    return static_cast<long long>(inserted.size());
+}
+
+long long ShardedDatabase::exportStudents(const StudentSink &sink)
+{
+    // 接收方不保证线程安全，按分片顺序依次导出
+    long long exported = 0;
+    bool stopped = false;
+    for (auto &shard : shards)
+    {
+        long long count = shard->database->exportStudents([&sink, &stopped](int id, const Student &student)
+                                                          {
+            if (!sink(id, student))
+            {
+                stopped = true;
+                return false;
+            }
+            return true; });
+        if (count < 0)
+            return -1;
+
+        exported += count;
+        if (stopped)
+            break;
+    }
+    return exported;
+}
+
+bool ShardedDatabase::createStudentTable()
+{
+    for (auto &shard : shards)
+    {
+        if (!shard->database->createStudentTable())
+            return false;
+    }
+    return true;
+}
+
+json ShardedDatabase::getMetrics() const
+{
+    json metrics;
+    metrics["shards"] = shards.size();
+    metrics["threads"] = pool ? pool->size() : 0;
+    metrics["pending_tasks"] = pool ? pool->pending() : 0;
+    return metrics;
+}
+
+StudentBatch ShardedDatabase::mergeBatches(std::vector<std::future<StudentBatch>> &futures)
+{
+    std::vector<StudentBatch> parts;
+    parts.reserve(futures.size());
+    for (auto &future : futures)
+    {
+        parts.push_back(future.get());
+    }
+
+    // 只有一个分片返回数据时直接移交，否则一次预留后拼接
+    if (parts.size() == 1)
+        return std::move(parts.front());
+
+    size_t rows = 0;
+    for (const auto &part : parts)
+    {
+        rows += part.size();
+    }
+
+    StudentBatch students;
+    students.reserve(rows);
+    for (const auto &part : parts)
+    {
+        students.append(part);
+    }
+    return students;
+}
@@ -2,15 +2,21 @@
 #include <sqlite3.h>
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 #include "logger.h"
 
 SQLiteDatabase::SQLiteDatabase(const ConfigManager &configManager)
-    : db(nullptr), dbPath(configManager.getSqliteDatabasePath())
+    : db(nullptr), dbPath(configManager.getSqliteDatabasePath()), idBase(0)
 {
 }
 
 SQLiteDatabase::SQLiteDatabase(const std::string &path)
-    : db(nullptr), dbPath(path)
+    : db(nullptr), dbPath(path), idBase(0)
+{
+}
+
+SQLiteDatabase::SQLiteDatabase(const std::string &path, int idBase)
+    : db(nullptr), dbPath(path), idBase(idBase)
 {
 }
 
@@ -35,6 +41,12 @@ bool SQLiteDatabase::open()
         return false;
     }
 
+    if (idBase > 0 && !seedIdSequence())
+    {
+        Logger::error("初始化id序列失败");
+        return false;
+    }
+
     Logger::info("SQLite数据库连接成功: {}", dbPath);
     return true;
 }
@@ -48,6 +60,45 @@ void SQLiteDatabase::close()
     }
 }
 
+bool SQLiteDatabase::execute(const char *sql)
+{
+    char *errMsg = nullptr;
+    int rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK)
+    {
+        Logger::error("执行SQL语句失败: {} ({})", errMsg ? errMsg : sqlite3_errmsg(db), sql);
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::seedIdSequence()
+{
+    // 仅在序列不存在时写入，已有数据的库保持原序列
+    const char *sql = "INSERT INTO sqlite_sequence (name, seq) "
+                      "SELECT 'students', ? WHERE NOT EXISTS "
+                      "(SELECT 1 FROM sqlite_sequence WHERE name = 'students');";
+    sqlite3_stmt *stmt;
+
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK)
+    {
+        Logger::error("准备SQL语句失败: {}", sqlite3_errmsg(db));
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, idBase);
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE)
+    {
+        Logger::error("执行SQL语句失败: {}", sqlite3_errmsg(db));
+        return false;
+    }
+    return true;
+}
+
 bool SQLiteDatabase::createStudentTable()
 {
     const char *sql = "CREATE TABLE IF NOT EXISTS students ("
@@ -69,6 +120,7 @@ bool SQLiteDatabase::createStudentTable()
 
 int SQLiteDatabase::addStudent(const Student &student)
 {
+    std::lock_guard<std::mutex> lock(writeMutex);
     const char *sql = "INSERT INTO students (name, age, className) VALUES (?, ?, ?);";
     sqlite3_stmt *stmt;
 
@@ -79,9 +131,9 @@ int SQLiteDatabase::addStudent(const Student &student)
         return -1;
     }
 
-    sqlite3_bind_text(stmt, 1, student.getName().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 1, student.getName().c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 2, student.getAge());
-    sqlite3_bind_text(stmt, 3, student.getClassName().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, student.getClassName().c_str(), -1, SQLITE_TRANSIENT);
 
     rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE)
@@ -100,6 +152,7 @@ int SQLiteDatabase::addStudent(const Student &student)
 
 bool SQLiteDatabase::updateStudent(int id, const Student &student)
 {
+    std::lock_guard<std::mutex> lock(writeMutex);
     const char *sql = "UPDATE students SET name = ?, age = ?, className = ? WHERE id = ?;";
     sqlite3_stmt *stmt;
 
@@ -110,9 +163,9 @@ bool SQLiteDatabase::updateStudent(int id, const Student &student)
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, student.getName().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 1, student.getName().c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 2, student.getAge());
-    sqlite3_bind_text(stmt, 3, student.getClassName().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, student.getClassName().c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 4, id);
 
     rc = sqlite3_step(stmt);
@@ -136,6 +189,7 @@ bool SQLiteDatabase::updateStudent(int id, const Student &student)
 
 bool SQLiteDatabase::deleteStudent(int id)
 {
+    std::lock_guard<std::mutex> lock(writeMutex);
     const char *sql = "DELETE FROM students WHERE id = ?;";
     sqlite3_stmt *stmt;
 
@@ -197,9 +251,9 @@ Student SQLiteDatabase::getStudent(int id)
     return Student();
 }
 
-std::vector<std::pair<int, Student>> SQLiteDatabase::getAllStudents()
+StudentBatch SQLiteDatabase::getAllStudents()
 {
-    std::vector<std::pair<int, Student>> students;
+    StudentBatch students;
     const char *sql = "SELECT id, name, age, className FROM students;";
     sqlite3_stmt *stmt;
 
@@ -210,13 +264,20 @@ std::vector<std::pair<int, Student>> SQLiteDatabase::getAllStudents()
         return students;
     }
 
+    // 按当前行数预留，避免结果集反复扩容
+    int count = getStudentCount();
+    if (count > 0)
+    {
+        students.reserve(static_cast<size_t>(count));
+    }
+
     while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
     {
         int id = sqlite3_column_int(stmt, 0);
-        std::string name = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+        std::string_view name(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)), sqlite3_column_bytes(stmt, 1));
         int age = sqlite3_column_int(stmt, 2);
-        std::string className = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
-        students.emplace_back(id, Student(name, age, className));
+        std::string_view className(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3)), sqlite3_column_bytes(stmt, 3));
+        students.add(id, age, name, className);
     }
 
     sqlite3_finalize(stmt);
@@ -247,3 +308,235 @@ int SQLiteDatabase::getStudentCount()
     sqlite3_finalize(stmt);
     return -1;
 }
+
+long long SQLiteDatabase::getMaxStudentId()
+{
+    const char *sql = "SELECT COALESCE(MAX(id), 0) FROM students;";
+    sqlite3_stmt *stmt;
+
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK)
+    {
+        Logger::error("准备SQL语句失败: {}", sqlite3_errmsg(db));
+        return -1;
+    }
+
+    long long maxId = -1;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        maxId = sqlite3_column_int64(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+    return maxId;
+}
+
+std::vector<int> SQLiteDatabase::addStudents(const std::vector<Student> &students)
+{
+    std::vector<int> ids(students.size(), -1);
+    if (students.empty())
+        return ids;
+
+    const char *sql = "INSERT INTO students (name, age, className) VALUES (?, ?, ?);";
+    sqlite3_stmt *stmt;
+
+    // 事务期间独占连接上的写入，其他线程的写入不会并入或随之回滚
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK)
+    {
+        Logger::error("准备SQL语句失败: {}", sqlite3_errmsg(db));
+        return ids;
+    }
+
+    if (!execute("BEGIN TRANSACTION;"))
+    {
+        sqlite3_finalize(stmt);
+        return ids;
+    }
+
+    bool failed = false;
+    for (size_t i = 0; i < students.size(); ++i)
+    {
+        const Student &student = students[i];
+        std::string name = student.getName();
+        std::string className = student.getClassName();
+
+        sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 2, student.getAge());
+        sqlite3_bind_text(stmt, 3, className.c_str(), -1, SQLITE_STATIC);
+
+        rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE)
+        {
+            Logger::error("执行SQL语句失败: {}", sqlite3_errmsg(db));
+            failed = true;
+            break;
+        }
+
+        ids[i] = sqlite3_last_insert_rowid(db);
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+
+    // 提交失败时事务可能仍处于打开状态，回滚后整批视为失败
+    if (failed || !execute("COMMIT;"))
+    {
+        if (!sqlite3_get_autocommit(db))
+        {
+            execute("ROLLBACK;");
+        }
+        std::fill(ids.begin(), ids.end(), -1);
+        return ids;
+    }
+
+    Logger::info("批量添加学生成功，数量: {}", students.size());
+    return ids;
+}
+
+int SQLiteDatabase::deleteStudents(const std::vector<int> &ids)
+{
+    if (ids.empty())
+        return 0;
+
+    const char *sql = "DELETE FROM students WHERE id = ?;";
+    sqlite3_stmt *stmt;
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK)
+    {
+        Logger::error("准备SQL语句失败: {}", sqlite3_errmsg(db));
+        return -1;
+    }
+
+    if (!execute("BEGIN TRANSACTION;"))
+    {
+        sqlite3_finalize(stmt);
+        return -1;
+    }
+
+    int deleted = 0;
+    for (int id : ids)
+    {
+        sqlite3_bind_int(stmt, 1, id);
+
+        rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE)
+        {
+            Logger::error("执行SQL语句失败: {}", sqlite3_errmsg(db));
+            sqlite3_finalize(stmt);
+            execute("ROLLBACK;");
+            return -1;
+        }
+
+        deleted += sqlite3_changes(db);
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+    if (!execute("COMMIT;"))
+    {
+        if (!sqlite3_get_autocommit(db))
+        {
+            execute("ROLLBACK;");
+        }
+        return -1;
+    }
+
+    Logger::info("批量删除学生成功，数量: {}", deleted);
+    return deleted;
+}
+
+long long SQLiteDatabase::importStudents(const StudentSource &source)
+{
+    const char *sql = "INSERT INTO students (name, age, className) VALUES (?, ?, ?);";
+    sqlite3_stmt *stmt;
+
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK)
+    {
+        Logger::error("准备SQL语句失败: {}", sqlite3_errmsg(db));
+        return -1;
+    }
+
+    // 整个导入在一个事务内完成：避免逐行同步磁盘，失败时不留下部分提交的数据
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!execute("BEGIN TRANSACTION;"))
+    {
+        sqlite3_finalize(stmt);
+        return -1;
+    }
+
+    long long imported = 0;
+    bool failed = false;
+    Student student;
+    while (source(student))
+    {
+        std::string name = student.getName();
+        std::string className = student.getClassName();
+
+        sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 2, student.getAge());
+        sqlite3_bind_text(stmt, 3, className.c_str(), -1, SQLITE_STATIC);
+
+        rc = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+        if (rc != SQLITE_DONE)
+        {
+            Logger::error("执行SQL语句失败: {}", sqlite3_errmsg(db));
+            failed = true;
+            break;
+        }
+        ++imported;
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (failed || !execute("COMMIT;"))
+    {
+        if (!sqlite3_get_autocommit(db))
+        {
+            execute("ROLLBACK;");
+        }
+        Logger::error("批量导入学生失败，已回滚: {} 行", imported);
+        return -1;
+    }
+
+    Logger::info("批量导入学生完成，数量: {}", imported);
+    return imported;
+}
+
+long long SQLiteDatabase::exportStudents(const StudentSink &sink)
+{
+    const char *sql = "SELECT id, name, age, className FROM students;";
+    sqlite3_stmt *stmt;
+
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK)
+    {
+        Logger::error("准备SQL语句失败: {}", sqlite3_errmsg(db));
+        return -1;
+    }
+
+    long long exported = 0;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        int id = sqlite3_column_int(stmt, 0);
+        std::string name = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+        int age = sqlite3_column_int(stmt, 2);
+        std::string className = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
+
+        ++exported;
+        if (!sink(id, Student(name, age, className)))
+            break;
+    }
+
+    sqlite3_finalize(stmt);
+    Logger::info("批量导出学生完成，数量: {}", exported);
+    return exported;
+}
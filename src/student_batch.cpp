@@ -0,0 +1,139 @@
+#include "student_batch.h"
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+
+StudentBatch::StudentBatch(const StudentBatch &other)
+{
+    append(other);
+}
+
+StudentBatch &StudentBatch::operator=(const StudentBatch &other)
+{
+    if (this != &other)
+    {
+        clear();
+        append(other);
+    }
+    return *this;
+}
+
+void StudentBatch::reserve(size_t rows, size_t textBytes)
+{
+    ids.reserve(rows);
+    ages.reserve(rows);
+    names.reserve(rows);
+    classIds.reserve(rows);
+
+    // 当前块放不下时预先分配一个足够大的块
+    if (textBytes > chunkCapacity - chunkUsed)
+    {
+        chunks.emplace_back(new char[textBytes]);
+        chunkUsed = 0;
+        chunkCapacity = textBytes;
+    }
+}
+
+void StudentBatch::add(int id, int age, std::string_view name, std::string_view className)
+{
+    add(id, age, name, ClassNameTable::instance().intern(className));
+}
+
+void StudentBatch::add(int id, int age, std::string_view name, uint32_t classId)
+{
+    ids.push_back(id);
+    ages.push_back(age);
+    names.push_back(store(name));
+    classIds.push_back(classId);
+}
+
+void StudentBatch::add(int id, const Student &student)
+{
+    add(id, student.getAge(), student.getName(), student.getClassId());
+}
+
+void StudentBatch::append(const StudentBatch &other)
+{
+    size_t textBytes = 0;
+    for (size_t i = 0; i < other.size(); ++i)
+    {
+        textBytes += other.names[i].size();
+    }
+
+    reserve(size() + other.size(), textBytes);
+    for (size_t i = 0; i < other.size(); ++i)
+    {
+        add(other.ids[i], other.ages[i], other.names[i], other.classIds[i]);
+    }
+}
+
+void StudentBatch::sortById()
+{
+    if (std::is_sorted(ids.begin(), ids.end()))
+        return;
+
+    // 只重排定长列，字符串区内容不动
+    std::vector<size_t> order(ids.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b)
+              { return ids[a] < ids[b]; });
+
+    std::vector<int> sortedIds(ids.size());
+    std::vector<int> sortedAges(ids.size());
+    std::vector<std::string_view> sortedNames(ids.size());
+    std::vector<uint32_t> sortedClassIds(ids.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        sortedIds[i] = ids[order[i]];
+        sortedAges[i] = ages[order[i]];
+        sortedNames[i] = names[order[i]];
+        sortedClassIds[i] = classIds[order[i]];
+    }
+
+    ids.swap(sortedIds);
+    ages.swap(sortedAges);
+    names.swap(sortedNames);
+    classIds.swap(sortedClassIds);
+}
+
+void StudentBatch::clear()
+{
+    ids.clear();
+    ages.clear();
+    names.clear();
+    classIds.clear();
+    chunks.clear();
+    chunkUsed = 0;
+    chunkCapacity = 0;
+}
+
+long long StudentBatch::forEach(const StudentVisitor &visitor) const
+{
+    long long visited = 0;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        ++visited;
+        if (!visitor(view(i)))
+            break;
+    }
+    return visited;
+}
+
+std::string_view StudentBatch::store(std::string_view text)
+{
+    if (text.empty())
+        return std::string_view();
+
+    if (text.size() > chunkCapacity - chunkUsed)
+    {
+        size_t capacity = std::max(kChunkSize, text.size());
+        chunks.emplace_back(new char[capacity]);
+        chunkUsed = 0;
+        chunkCapacity = capacity;
+    }
+
+    char *destination = chunks.back().get() + chunkUsed;
+    std::memcpy(destination, text.data(), text.size());
+    chunkUsed += text.size();
+    return std::string_view(destination, text.size());
+}
@@ -0,0 +1,300 @@
+#include "student_cache.h"
+#include <algorithm>
+
+namespace
+{
+    // 哈希表节点与桶指针的近似开销
+    constexpr size_t kIndexOverhead = 32;
+
+    size_t roundUpPowerOfTwo(size_t value)
+    {
+        size_t result = 1;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+}
+
+struct StudentCache::Shard
+{
+    struct Entry
+    {
+        int id = 0;
+        bool used = false;
+        bool referenced = false;
+        std::chrono::steady_clock::time_point expires;
+        size_t bytes = 0;
+        Student student;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<int, uint32_t> index;
+    std::vector<Entry> entries;
+    std::vector<uint32_t> freeSlots;
+    size_t hand = 0;
+    size_t bytes = 0;
+
+    static size_t entryBytes(const Student &student)
+    {
+        // 短姓名存放在string内部，不另外计算
+        const std::string &name = student.getName();
+        size_t heap = name.capacity() > 15 ? name.capacity() + 1 : 0;
+        return sizeof(Entry) + kIndexOverhead + heap;
+    }
+
+    void remove(uint32_t slot)
+    {
+        Entry &entry = entries[slot];
+        index.erase(entry.id);
+        bytes -= entry.bytes;
+        entry.used = false;
+        entry.student = Student();
+        freeSlots.push_back(slot);
+    }
+
+    // 推进时钟指针淘汰一个条目；expired为true表示淘汰的是过期条目
+    bool evictOne(std::chrono::steady_clock::time_point now, bool &expired)
+    {
+        if (index.empty())
+            return false;
+
+        // 两圈之内必然找到访问位已清除的条目
+        for (size_t step = 0; step < entries.size() * 2 + 1; ++step)
+        {
+            if (hand >= entries.size())
+                hand = 0;
+            uint32_t slot = static_cast<uint32_t>(hand++);
+            Entry &entry = entries[slot];
+            if (!entry.used)
+                continue;
+            if (entry.expires <= now)
+            {
+                expired = true;
+                remove(slot);
+                return true;
+            }
+            if (entry.referenced)
+            {
+                entry.referenced = false;
+                continue;
+            }
+            expired = false;
+            remove(slot);
+            return true;
+        }
+        return false;
+    }
+};
+
+StudentCache::StudentCache() : StudentCache(Options())
+{
+}
+
+StudentCache::StudentCache(const Options &options)
+    : options(options), shardCount(0), shardBudget(0),
+      hitCount(0), missCount(0), evictionCount(0), expirationCount(0)
+{
+    if (options.capacityBytes == 0 || options.ttl.count() <= 0)
+        return;
+
+    shardCount = roundUpPowerOfTwo(std::max<size_t>(options.shards, 1));
+    shardBudget = options.capacityBytes / shardCount;
+    shards.reset(new Shard[shardCount]);
+}
+
+StudentCache::~StudentCache() = default;
+
+StudentCache::Shard &StudentCache::shardFor(int id) const
+{
+    // 相邻id分散到不同分片
+    uint32_t hash = static_cast<uint32_t>(id) * 0x9e3779b1u;
+    return shards[(hash >> 16) & (shardCount - 1)];
+}
+
+bool StudentCache::find(int id, Student &student)
+{
+    if (!enabled())
+        return false;
+
+    Shard &shard = shardFor(id);
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(id);
+        if (it != shard.index.end())
+        {
+            Shard::Entry &entry = shard.entries[it->second];
+            if (entry.expires > now)
+            {
+                entry.referenced = true;
+                student = entry.student;
+                ++hitCount;
+                return true;
+            }
+            shard.remove(it->second);
+            ++expirationCount;
+        }
+    }
+
+    ++missCount;
+    return false;
+}
+
+void StudentCache::insert(int id, const Student &student)
+{
+    if (!enabled())
+        return;
+
+    size_t bytes = Shard::entryBytes(student);
+    if (bytes > shardBudget)
+        return;
+
+    Shard &shard = shardFor(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    insertLocked(shard, id, student, bytes);
+}
+
+bool StudentCache::insert(int id, const Student &student, const std::atomic<uint64_t> &version, uint64_t expected)
+{
+    if (!enabled())
+        return false;
+
+    size_t bytes = Shard::entryBytes(student);
+    if (bytes > shardBudget)
+        return false;
+
+    // 版本在锁内检查：检查之后才递增版本的失效方，其erase必须等本次插入释放锁，随后将条目移除
+    Shard &shard = shardFor(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (version.load() != expected)
+        return false;
+
+    insertLocked(shard, id, student, bytes);
+    return true;
+}
+
+void StudentCache::insertLocked(Shard &shard, int id, const Student &student, size_t bytes)
+{
+    auto now = std::chrono::steady_clock::now();
+    auto it = shard.index.find(id);
+    if (it != shard.index.end())
+    {
+        Shard::Entry &entry = shard.entries[it->second];
+        shard.bytes = shard.bytes - entry.bytes + bytes;
+        entry.bytes = bytes;
+        entry.student = student;
+        entry.expires = now + options.ttl;
+        entry.referenced = true;
+        return;
+    }
+
+    while (shard.bytes + bytes > shardBudget)
+    {
+        bool expired = false;
+        if (!shard.evictOne(now, expired))
+            break;
+        if (expired)
+            ++expirationCount;
+        else
+            ++evictionCount;
+    }
+
+    uint32_t slot;
+    if (!shard.freeSlots.empty())
+    {
+        slot = shard.freeSlots.back();
+        shard.freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(shard.entries.size());
+        shard.entries.emplace_back();
+    }
+
+    // 新条目不置访问位，只被访问一次的条目在下一轮扫描时即可淘汰
+    Shard::Entry &entry = shard.entries[slot];
+    entry.id = id;
+    entry.used = true;
+    entry.referenced = false;
+    entry.expires = now + options.ttl;
+    entry.bytes = bytes;
+    entry.student = student;
+    shard.index.emplace(id, slot);
+    shard.bytes += bytes;
+}
+
+void StudentCache::erase(int id)
+{
+    if (!enabled())
+        return;
+
+    Shard &shard = shardFor(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(id);
+    if (it != shard.index.end())
+    {
+        shard.remove(it->second);
+    }
+}
+
+void StudentCache::clear()
+{
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        Shard &shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.entries.clear();
+        shard.freeSlots.clear();
+        shard.hand = 0;
+        shard.bytes = 0;
+    }
+}
+
+std::vector<int> StudentCache::hotIds(size_t limit) const
+{
+    std::vector<int> referenced;
+    std::vector<int> others;
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        Shard &shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const Shard::Entry &entry : shard.entries)
+        {
+            if (!entry.used || entry.expires <= now)
+                continue;
+            if (entry.referenced)
+                referenced.push_back(entry.id);
+            else if (others.size() < limit)
+                others.push_back(entry.id);
+        }
+    }
+
+    if (referenced.size() >= limit)
+    {
+        referenced.resize(limit);
+        return referenced;
+    }
+    others.resize(std::min(others.size(), limit - referenced.size()));
+    referenced.insert(referenced.end(), others.begin(), others.end());
+    return referenced;
+}
+
+StudentCache::Stats StudentCache::getStats() const
+{
+    Stats stats;
+    stats.capacityBytes = shardBudget * shardCount;
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        Shard &shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.entries += shard.index.size();
+        stats.bytes += shard.bytes;
+    }
+    stats.hits = hitCount.load();
+    stats.misses = missCount.load();
+    stats.evictions = evictionCount.load();
+    stats.expirations = expirationCount.load();
+    return stats;
+}
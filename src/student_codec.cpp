@@ -0,0 +1,83 @@
+#include "student_codec.h"
+
+namespace
+{
+    class Decoder
+    {
+    public:
+        explicit Decoder(std::string_view data) : cursor(data.data()), end(data.data() + data.size()) {}
+
+        bool varint(uint64_t &value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64 && cursor != end; shift += 7)
+            {
+                unsigned char byte = static_cast<unsigned char>(*cursor++);
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                    return true;
+            }
+            return false;
+        }
+
+        // 返回指向输入缓冲的视图，不复制
+        bool bytes(std::string_view &value)
+        {
+            uint64_t length;
+            if (!varint(length) || length > static_cast<uint64_t>(end - cursor))
+                return false;
+            value = std::string_view(cursor, static_cast<size_t>(length));
+            cursor += length;
+            return true;
+        }
+
+        bool done() const { return cursor == end; }
+
+    private:
+        const char *cursor;
+        const char *end;
+    };
+}
+
+bool decodeStudentCache(std::string_view data, Student &student, CacheStamp *stamp, std::string *error)
+{
+    if (data.empty())
+    {
+        if (error)
+            *error = "缓存值为空";
+        return false;
+    }
+
+    // 旧版本写入的JSON值在滚动升级期间仍然可读
+    if (data.front() == '{')
+    {
+        return parseStudentJson(data, student, error, stamp);
+    }
+
+    if (static_cast<unsigned char>(data.front()) != kStudentCodecV1)
+    {
+        if (error)
+            *error = "未知的缓存编码版本: " + std::to_string(static_cast<unsigned char>(data.front()));
+        return false;
+    }
+
+    Decoder decoder(data.substr(1));
+    uint64_t zigzagAge, softExpiresAt, loadMillis;
+    std::string_view name, className;
+    if (!decoder.varint(zigzagAge) || !decoder.bytes(name) || !decoder.bytes(className) ||
+        !decoder.varint(softExpiresAt) || !decoder.varint(loadMillis) || !decoder.done())
+    {
+        if (error)
+            *error = "缓存值格式错误";
+        return false;
+    }
+
+    int age = static_cast<int>(static_cast<int64_t>(zigzagAge >> 1) ^ -static_cast<int64_t>(zigzagAge & 1));
+    student = Student::withClassId(std::string(name), age, ClassNameTable::instance().intern(className));
+    if (stamp)
+    {
+        stamp->softExpiresAt = static_cast<long long>(softExpiresAt);
+        stamp->loadMillis = static_cast<int>(loadMillis);
+    }
+    return true;
+}
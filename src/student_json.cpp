@@ -0,0 +1,428 @@
+#include "student_json.h"
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+    constexpr int kMaxDepth = 64;
+
+    // 只关心顶层对象的name、age、className三个字段，其余值校验语法后跳过；
+    // 字段类型不符与json::value()的行为一致视为错误。
+    // 直接在输入上扫描，除写入结果字段外不分配内存
+    class StudentJsonReader
+    {
+    public:
+        StudentJsonReader(std::string_view text) : cursor(text.data()), begin(text.data()), end(text.data() + text.size()) {}
+
+        bool read(std::string &name, int &age, std::string &className, CacheStamp *stamp)
+        {
+            skipSpace();
+            if (!consume('{'))
+                return fail("顶层不是对象");
+
+            skipSpace();
+            if (!consume('}'))
+            {
+                std::string key;
+                while (true)
+                {
+                    skipSpace();
+                    if (!readString(key))
+                        return false;
+                    skipSpace();
+                    if (!consume(':'))
+                        return fail("缺少冒号");
+                    skipSpace();
+
+                    bool ok;
+                    if (key == "name")
+                        ok = readStringField(name);
+                    else if (key == "className")
+                        ok = readStringField(className);
+                    else if (key == "age")
+                        ok = readNumberField(age, "age 字段必须是数字");
+                    else if (stamp && key == "_soft")
+                        ok = readNumberField(stamp->softExpiresAt, "_soft 字段必须是数字");
+                    else if (stamp && key == "_cost")
+                        ok = readNumberField(stamp->loadMillis, "_cost 字段必须是数字");
+                    else
+                        ok = skipValue(1);
+                    if (!ok)
+                        return false;
+
+                    skipSpace();
+                    if (consume('}'))
+                        break;
+                    if (!consume(','))
+                        return fail("缺少逗号或右花括号");
+                }
+            }
+
+            skipSpace();
+            return cursor == end || fail("对象之后存在多余内容");
+        }
+
+        const std::string &error() const { return message; }
+
+    private:
+        const char *cursor;
+        const char *begin;
+        const char *end;
+        std::string message;
+
+        bool fail(const char *what)
+        {
+            message = std::string(what) + "（位置 " + std::to_string(cursor - begin) + "）";
+            return false;
+        }
+
+        bool consume(char expected)
+        {
+            if (cursor != end && *cursor == expected)
+            {
+                ++cursor;
+                return true;
+            }
+            return false;
+        }
+
+        bool consumeLiteral(std::string_view literal)
+        {
+            if (static_cast<size_t>(end - cursor) < literal.size() || std::string_view(cursor, literal.size()) != literal)
+                return fail("无效的字面量");
+            cursor += literal.size();
+            return true;
+        }
+
+        void skipSpace()
+        {
+            while (cursor != end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r'))
+                ++cursor;
+        }
+
+        bool readStringField(std::string &out)
+        {
+            if (cursor == end || *cursor != '"')
+                return fail("字段类型不符");
+            return readString(out);
+        }
+
+        template <typename Integer>
+        bool readNumberField(Integer &out, const char *typeError)
+        {
+            if (cursor == end || (*cursor != '-' && (*cursor < '0' || *cursor > '9')))
+                return fail(typeError);
+            double value;
+            if (!readNumber(&value))
+                return false;
+            out = std::isfinite(value) ? static_cast<Integer>(value) : 0;
+            return true;
+        }
+
+        static void appendUtf8(std::string &out, uint32_t code)
+        {
+            if (code < 0x80)
+            {
+                out += static_cast<char>(code);
+            }
+            else if (code < 0x800)
+            {
+                out += static_cast<char>(0xc0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3f));
+            }
+            else if (code < 0x10000)
+            {
+                out += static_cast<char>(0xe0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (code & 0x3f));
+            }
+            else
+            {
+                out += static_cast<char>(0xf0 | (code >> 18));
+                out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (code & 0x3f));
+            }
+        }
+
+        bool readHex4(uint32_t &code)
+        {
+            if (end - cursor < 4)
+                return fail("无效的\\u转义");
+            code = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                char c = *cursor++;
+                code <<= 4;
+                if (c >= '0' && c <= '9')
+                    code |= static_cast<uint32_t>(c - '0');
+                else if (c >= 'a' && c <= 'f')
+                    code |= static_cast<uint32_t>(c - 'a' + 10);
+                else if (c >= 'A' && c <= 'F')
+                    code |= static_cast<uint32_t>(c - 'A' + 10);
+                else
+                    return fail("无效的\\u转义");
+            }
+            return true;
+        }
+
+        // 校验一个UTF-8多字节序列并原样追加，out为空指针时只校验
+        bool copyUtf8(std::string *out)
+        {
+            unsigned char lead = static_cast<unsigned char>(*cursor);
+            int length = 0;
+            if (lead >= 0xc2 && lead <= 0xdf)
+                length = 2;
+            else if (lead >= 0xe0 && lead <= 0xef)
+                length = 3;
+            else if (lead >= 0xf0 && lead <= 0xf4)
+                length = 4;
+            if (length == 0 || end - cursor < length)
+                return fail("无效的UTF-8编码");
+            for (int i = 1; i < length; ++i)
+            {
+                if ((static_cast<unsigned char>(cursor[i]) & 0xc0) != 0x80)
+                    return fail("无效的UTF-8编码");
+            }
+            if (out)
+                out->append(cursor, length);
+            cursor += length;
+            return true;
+        }
+
+        bool readString(std::string &out) { return scanString(&out); }
+
+        // 读取字符串（cursor位于引号处），out为空指针时只校验并跳过
+        bool scanString(std::string *out)
+        {
+            if (!consume('"'))
+                return fail("应为字符串");
+            if (out)
+                out->clear();
+
+            while (true)
+            {
+                // 连续的普通字节整段追加
+                const char *run = cursor;
+                while (cursor != end && *cursor != '"' && *cursor != '\\' &&
+                       static_cast<unsigned char>(*cursor) >= 0x20 && static_cast<unsigned char>(*cursor) < 0x80)
+                    ++cursor;
+                if (out)
+                    out->append(run, cursor);
+
+                if (cursor == end)
+                    return fail("字符串未结束");
+
+                unsigned char c = static_cast<unsigned char>(*cursor);
+                if (c == '"')
+                {
+                    ++cursor;
+                    return true;
+                }
+                if (c < 0x20)
+                    return fail("字符串中含有控制字符");
+                if (c >= 0x80)
+                {
+                    if (!copyUtf8(out))
+                        return false;
+                    continue;
+                }
+
+                // 转义序列
+                ++cursor;
+                if (cursor == end)
+                    return fail("字符串未结束");
+                char escaped = *cursor++;
+                char plain;
+                switch (escaped)
+                {
+                case '"':
+                    plain = '"';
+                    break;
+                case '\\':
+                    plain = '\\';
+                    break;
+                case '/':
+                    plain = '/';
+                    break;
+                case 'b':
+                    plain = '\b';
+                    break;
+                case 'f':
+                    plain = '\f';
+                    break;
+                case 'n':
+                    plain = '\n';
+                    break;
+                case 'r':
+                    plain = '\r';
+                    break;
+                case 't':
+                    plain = '\t';
+                    break;
+                case 'u':
+                {
+                    uint32_t code;
+                    if (!readHex4(code))
+                        return false;
+                    if (code >= 0xd800 && code <= 0xdbff)
+                    {
+                        uint32_t low;
+                        if (!consume('\\') || !consume('u') || !readHex4(low) || low < 0xdc00 || low > 0xdfff)
+                            return fail("无效的代理对");
+                        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                    }
+                    else if (code >= 0xdc00 && code <= 0xdfff)
+                    {
+                        return fail("无效的代理对");
+                    }
+                    if (out)
+                        appendUtf8(*out, code);
+                    continue;
+                }
+                default:
+                    return fail("无效的转义字符");
+                }
+                if (out)
+                    *out += plain;
+            }
+        }
+
+        bool readNumber(double *value)
+        {
+            const char *start = cursor;
+            consume('-');
+            if (!consume('0'))
+            {
+                if (cursor == end || *cursor < '1' || *cursor > '9')
+                    return fail("无效的数字");
+                while (cursor != end && *cursor >= '0' && *cursor <= '9')
+                    ++cursor;
+            }
+
+            if (consume('.'))
+            {
+                if (cursor == end || *cursor < '0' || *cursor > '9')
+                    return fail("无效的数字");
+                while (cursor != end && *cursor >= '0' && *cursor <= '9')
+                    ++cursor;
+            }
+            if (cursor != end && (*cursor == 'e' || *cursor == 'E'))
+            {
+                ++cursor;
+                if (!consume('+'))
+                    consume('-');
+                if (cursor == end || *cursor < '0' || *cursor > '9')
+                    return fail("无效的数字");
+                while (cursor != end && *cursor >= '0' && *cursor <= '9')
+                    ++cursor;
+            }
+
+            if (value)
+            {
+                // 数字片段很短，复制到栈上补上结尾再转换
+                char digits[64];
+                size_t length = static_cast<size_t>(cursor - start);
+                if (length >= sizeof(digits))
+                    return fail("数字过长");
+                std::string_view(start, length).copy(digits, length);
+                digits[length] = '\0';
+                *value = std::strtod(digits, nullptr);
+            }
+            return true;
+        }
+
+        bool skipValue(int depth)
+        {
+            if (depth > kMaxDepth)
+                return fail("嵌套层数过深");
+            if (cursor == end)
+                return fail("缺少值");
+
+            switch (*cursor)
+            {
+            case '"':
+                return scanString(nullptr);
+            case '{':
+            case '[':
+            {
+                char close = *cursor == '{' ? '}' : ']';
+                bool object = close == '}';
+                ++cursor;
+                skipSpace();
+                if (consume(close))
+                    return true;
+                while (true)
+                {
+                    skipSpace();
+                    if (object)
+                    {
+                        if (!scanString(nullptr))
+                            return false;
+                        skipSpace();
+                        if (!consume(':'))
+                            return fail("缺少冒号");
+                        skipSpace();
+                    }
+                    if (!skipValue(depth + 1))
+                        return false;
+                    skipSpace();
+                    if (consume(close))
+                        return true;
+                    if (!consume(','))
+                        return fail("缺少逗号");
+                }
+            }
+            case 't':
+                return consumeLiteral("true");
+            case 'f':
+                return consumeLiteral("false");
+            case 'n':
+                return consumeLiteral("null");
+            default:
+                return readNumber(nullptr);
+            }
+        }
+    };
+}
+
+bool parseStudentJson(std::string_view text, Student &student, std::string *error, CacheStamp *stamp)
+{
+    std::string name;
+    std::string className;
+    int age = 0;
+
+    StudentJsonReader reader(text);
+    if (!reader.read(name, age, className, stamp))
+    {
+        if (error)
+            *error = reader.error();
+        return false;
+    }
+
+    student = Student(name, age, className);
+    return true;
+}
+
+bool parseStudentRequestJson(std::string_view text, Student &student, std::string *error)
+{
+    std::string name;
+    std::string className;
+    int age = 0;
+
+    StudentJsonReader reader(text);
+    if (!reader.read(name, age, className, nullptr))
+    {
+        if (error)
+            *error = reader.error();
+        return false;
+    }
+
+    uint32_t classId;
+    if (!ClassNameTable::instance().internForWrite(className, classId))
+        throw std::length_error("班级名称数量已达上限");
+
+    student = Student::withClassId(std::move(name), age, classId);
+    return true;
+}
@@ -0,0 +1,199 @@
+#include <memory>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+#include "student_routes.h"
+#include "student_json.h"
+#include "logger.h"
+#include "timer.h"
+
+using json = nlohmann::json;
+
+// 解析JSON格式的学生信息（SAX解析，不构建json DOM）
+Student parseStudentFromJson(const std::string &jsonStr)
+{
+    Student student;
+    std::string error;
+    if (!parseStudentRequestJson(jsonStr, student, &error))
+    {
+        Logger::error("JSON解析错误: {}", error);
+        throw std::runtime_error("无效的JSON格式");
+    }
+    return student;
+}
+
+RouteResponse errorResponse(int status, const std::string &message)
+{
+    json errorJson;
+    errorJson["error"] = message;
+    return RouteResponse{status, errorJson.dump()};
+}
+
+// 将Student对象转换为JSON字符串
+std::string studentToJson(const Student &student, int id)
+{
+    std::string out;
+    out.reserve(64 + student.getName().size() + student.getClassName().size());
+    appendStudentJson(out, id, student.getName(), student.getAge(), student.getClassId());
+    return out;
+}
+
+Task<RouteResponse> handleAddStudent(DatabaseManager &dbManager, std::string body, std::string clientId)
+{
+    Logger::info("收到添加学生请求: {}", body);
+
+    Student student;
+    try
+    {
+        student = parseStudentFromJson(body);
+    }
+    catch (const std::length_error &e)
+    {
+        Logger::error("添加学生失败: {}", e.what());
+        co_return errorResponse(503, "班级名称数量已达上限");
+    }
+    catch (const std::exception &e)
+    {
+        Logger::error("添加学生失败: {}", e.what());
+        co_return errorResponse(400, "无效的学生数据");
+    }
+
+    int studentId = co_await dbManager.addStudentTask(student, std::move(clientId));
+    if (studentId <= 0)
+    {
+        Logger::error("添加学生失败");
+        co_return errorResponse(500, "数据库操作失败");
+    }
+
+    Logger::info("成功添加学生，ID: {}", studentId);
+    co_return RouteResponse{200, studentToJson(student, studentId)};
+}
+
+Task<RouteResponse> handleListStudents(DatabaseManager &dbManager, std::string clientId)
+{
+    Timer timer;
+    Logger::info("收到获取所有学生请求");
+
+    // 缓存的是最终响应体，命中时原样返回，不解析也不重新拼接
+    StudentListCache cached = co_await dbManager.getStudentListCacheTask(clientId);
+    if (cached.hit)
+    {
+        Logger::info("从缓存返回学生列表，代数: {}", cached.generation);
+        co_return RouteResponse{200, std::move(cached.body)};
+    }
+
+    // 逐条扫描直接拼接JSON文本，避免中间的学生列表与json对象；
+    // 扫描在I/O执行器上进行，输出缓冲由访问者共同持有
+    auto body = std::make_shared<std::string>("[");
+    StudentVisitor collect = [body](const StudentView &student)
+    {
+        if (body->size() > 1)
+            *body += ',';
+        appendStudentJson(*body, student.id, student.name, student.age, student.classId);
+        return true;
+    };
+    long long count = co_await dbManager.scanStudentsTask(collect, std::move(clientId), cached.generation >= 0);
+    if (count < 0)
+    {
+        // 扫描中途失败时已拼接的内容不完整，既不返回也不缓存
+        co_return errorResponse(500, "数据库查询失败");
+    }
+    *body += ']';
+
+    Logger::info("返回 {} 个学生信息", count);
+
+    // 以扫描前读取的代数异步写回：扫描期间若有写入，代数已递增，写回的条目不会再被读取。
+    // 写回仍持有body，响应使用副本
+    dbManager.storeStudentListCache(cached.generation, body);
+    co_return RouteResponse{200, *body};
+}
+
+Task<RouteResponse> handleGetStudent(DatabaseManager &dbManager, int studentId, std::string clientId)
+{
+    Logger::info("收到获取学生请求，ID: {}", studentId);
+
+    Student student = co_await dbManager.getStudentTask(studentId, std::move(clientId));
+    // 检查学生是否存在，确保所有字段都有有效值
+    if (student.getName() != "" && student.getAge() > 0 && student.getClassName() != "")
+    {
+        Logger::info("成功返回学生信息");
+        co_return RouteResponse{200, studentToJson(student, studentId)};
+    }
+
+    Logger::warn("学生不存在，ID: {}", studentId);
+    co_return errorResponse(404, "学生不存在");
+}
+
+Task<RouteResponse> handleUpdateStudent(DatabaseManager &dbManager, int studentId, std::string body, std::string clientId)
+{
+    Logger::info("收到更新学生请求，ID: {} 数据: {}", studentId, body);
+
+    Student student;
+    try
+    {
+        student = parseStudentFromJson(body);
+    }
+    catch (const std::length_error &e)
+    {
+        Logger::error("更新学生失败: {}", e.what());
+        co_return errorResponse(503, "班级名称数量已达上限");
+    }
+    catch (const std::exception &e)
+    {
+        Logger::error("更新学生失败: {}", e.what());
+        co_return errorResponse(400, "无效的学生数据");
+    }
+
+    bool success = co_await dbManager.updateStudentTask(studentId, student, std::move(clientId));
+    if (!success)
+    {
+        Logger::warn("学生不存在，ID: {}", studentId);
+        co_return errorResponse(404, "学生不存在");
+    }
+
+    Logger::info("成功更新学生信息");
+    co_return RouteResponse{200, studentToJson(student, studentId)};
+}
+
+Task<RouteResponse> handleDeleteStudent(DatabaseManager &dbManager, int studentId, std::string clientId)
+{
+    Logger::info("收到删除学生请求，ID: {}", studentId);
+
+    bool success = co_await dbManager.deleteStudentTask(studentId, std::move(clientId));
+    if (!success)
+    {
+        Logger::warn("学生不存在，ID: {}", studentId);
+        co_return errorResponse(404, "学生不存在");
+    }
+
+    json successJson;
+    successJson["message"] = "学生删除成功";
+    Logger::info("成功删除学生");
+    co_return RouteResponse{200, successJson.dump()};
+}
+
+Task<RouteResponse> handleHealth(DatabaseManager &dbManager, std::string clientId)
+{
+    int count = co_await dbManager.getStudentCountTask(std::move(clientId));
+    if (count < 0)
+    {
+        co_return errorResponse(500, "数据库查询失败");
+    }
+
+    json j;
+    j["status"] = "ok";
+    j["students_count"] = count;
+    co_return RouteResponse{200, j.dump()};
+}
+
+RouteResponse handleReady(const DatabaseManager &dbManager)
+{
+    json j;
+    if (!dbManager.isReady())
+    {
+        j["status"] = "warming";
+        return RouteResponse{503, j.dump()};
+    }
+
+    j["status"] = "ready";
+    return RouteResponse{200, j.dump()};
+}
@@ -0,0 +1,343 @@
+#include "student_snapshot.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <numeric>
+#include "logger.h"
+
+namespace
+{
+    const uint32_t kSnapshotMagic = 0x43535348;
+    const uint32_t kSnapshotVersion = 1;
+
+    // 各列起始偏移按8字节对齐
+    struct SnapshotHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t rowCount;
+        int64_t createdAt;
+        uint64_t dictionaryCount;
+        uint64_t idsOffset;
+        uint64_t agesOffset;
+        uint64_t classCodesOffset;
+        uint64_t nameOffsetsOffset;
+        uint64_t nameHeapOffset;
+        uint64_t dictionaryOffsetsOffset;
+        uint64_t dictionaryHeapOffset;
+        uint64_t fileSize;
+        uint32_t headerChecksum;
+        uint32_t reserved;
+    };
+
+    uint32_t headerChecksum(const SnapshotHeader &header)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&header);
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < offsetof(SnapshotHeader, headerChecksum); ++i)
+        {
+            hash ^= static_cast<unsigned char>(bytes[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // 逐列追加到文件缓冲，返回该列的起始偏移
+    uint64_t appendSection(std::string &file, const void *data, size_t size)
+    {
+        file.append((8 - file.size() % 8) % 8, '\0');
+        uint64_t offset = file.size();
+        file.append(static_cast<const char *>(data), size);
+        return offset;
+    }
+
+    bool sectionFits(uint64_t offset, uint64_t size, uint64_t fileSize)
+    {
+        return offset % 8 == 0 && offset <= fileSize && size <= fileSize - offset;
+    }
+
+    // 偏移数组须从0开始单调不减，且不越过字符串堆
+    bool offsetsValid(const uint64_t *offsets, size_t count, uint64_t heapSize)
+    {
+        if (offsets[0] != 0)
+            return false;
+        for (size_t i = 1; i <= count; ++i)
+        {
+            if (offsets[i] < offsets[i - 1])
+                return false;
+        }
+        return offsets[count] <= heapSize;
+    }
+}
+
+void StudentSnapshot::Builder::add(int id, const Student &student)
+{
+    auto it = dictionaryIndex.find(student.getClassId());
+    if (it == dictionaryIndex.end())
+    {
+        it = dictionaryIndex.emplace(student.getClassId(), static_cast<uint32_t>(dictionary.size())).first;
+        dictionary.push_back(student.getClassName());
+    }
+
+    ids.push_back(id);
+    ages.push_back(student.getAge());
+    classCodes.push_back(it->second);
+    nameHeap += student.getName();
+    nameOffsets.push_back(nameHeap.size());
+}
+
+bool StudentSnapshot::Builder::write(const std::string &path) const
+{
+    // 按id排序后写出各列
+    size_t rows = ids.size();
+    std::vector<size_t> order(rows);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b)
+              { return ids[a] < ids[b]; });
+
+    std::vector<int32_t> sortedIds(rows);
+    std::vector<int32_t> sortedAges(rows);
+    std::vector<uint32_t> sortedCodes(rows);
+    std::vector<uint64_t> sortedNameOffsets{0};
+    std::string sortedNames;
+    sortedNameOffsets.reserve(rows + 1);
+    sortedNames.reserve(nameHeap.size());
+    for (size_t i = 0; i < rows; ++i)
+    {
+        size_t row = order[i];
+        sortedIds[i] = ids[row];
+        sortedAges[i] = ages[row];
+        sortedCodes[i] = classCodes[row];
+        sortedNames.append(nameHeap, nameOffsets[row], nameOffsets[row + 1] - nameOffsets[row]);
+        sortedNameOffsets.push_back(sortedNames.size());
+    }
+
+    std::vector<uint64_t> dictionaryOffsets{0};
+    std::string dictionaryHeap;
+    for (const auto &value : dictionary)
+    {
+        dictionaryHeap += value;
+        dictionaryOffsets.push_back(dictionaryHeap.size());
+    }
+
+    SnapshotHeader header{};
+    header.magic = kSnapshotMagic;
+    header.version = kSnapshotVersion;
+    header.rowCount = rows;
+    header.createdAt = static_cast<int64_t>(std::time(nullptr));
+    header.dictionaryCount = dictionary.size();
+
+    std::string file(sizeof(SnapshotHeader), '\0');
+    header.idsOffset = appendSection(file, sortedIds.data(), rows * sizeof(int32_t));
+    header.agesOffset = appendSection(file, sortedAges.data(), rows * sizeof(int32_t));
+    header.classCodesOffset = appendSection(file, sortedCodes.data(), rows * sizeof(uint32_t));
+    header.nameOffsetsOffset = appendSection(file, sortedNameOffsets.data(), sortedNameOffsets.size() * sizeof(uint64_t));
+    header.nameHeapOffset = appendSection(file, sortedNames.data(), sortedNames.size());
+    header.dictionaryOffsetsOffset = appendSection(file, dictionaryOffsets.data(), dictionaryOffsets.size() * sizeof(uint64_t));
+    header.dictionaryHeapOffset = appendSection(file, dictionaryHeap.data(), dictionaryHeap.size());
+    header.fileSize = file.size();
+    header.headerChecksum = headerChecksum(header);
+    std::memcpy(&file[0], &header, sizeof(header));
+
+    std::string tempPath = path + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        Logger::error("无法创建快照文件 {}: {}", tempPath, std::strerror(errno));
+        return false;
+    }
+
+    const char *cursor = file.data();
+    size_t remaining = file.size();
+    bool ok = true;
+    while (ok && remaining > 0)
+    {
+        ssize_t written = ::write(fd, cursor, remaining);
+        if (written < 0 && errno == EINTR)
+            continue;
+        ok = written > 0;
+        if (ok)
+        {
+            cursor += written;
+            remaining -= static_cast<size_t>(written);
+        }
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        Logger::error("写入快照文件失败 {}: {}", path, std::strerror(errno));
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+StudentSnapshot::StudentSnapshot()
+    : data(nullptr), length(0), rowCount(0), dictionaryCount(0), created(0),
+      ids(nullptr), ages(nullptr), classCodes(nullptr), nameOffsets(nullptr), nameHeap(nullptr),
+      dictionaryOffsets(nullptr), dictionaryHeap(nullptr)
+{
+}
+
+StudentSnapshot::~StudentSnapshot()
+{
+    close();
+}
+
+bool StudentSnapshot::open(const std::string &path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        if (errno != ENOENT)
+        {
+            Logger::warn("无法打开快照文件 {}: {}", path, std::strerror(errno));
+        }
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader))
+    {
+        Logger::warn("快照文件无效: {}", path);
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        Logger::warn("映射快照文件失败 {}: {}", path, std::strerror(errno));
+        return false;
+    }
+    madvise(mapping, size, MADV_WILLNEED);
+
+    const char *base = static_cast<const char *>(mapping);
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    uint64_t rows = header.rowCount;
+    uint64_t words = header.dictionaryCount;
+    bool valid = header.magic == kSnapshotMagic && header.version == kSnapshotVersion &&
+                 header.headerChecksum == headerChecksum(header) && header.fileSize == size &&
+                 rows < (1ULL << 32) && words < (1ULL << 32) &&
+                 sectionFits(header.idsOffset, rows * sizeof(int32_t), size) &&
+                 sectionFits(header.agesOffset, rows * sizeof(int32_t), size) &&
+                 sectionFits(header.classCodesOffset, rows * sizeof(uint32_t), size) &&
+                 sectionFits(header.nameOffsetsOffset, (rows + 1) * sizeof(uint64_t), size) &&
+                 sectionFits(header.dictionaryOffsetsOffset, (words + 1) * sizeof(uint64_t), size) &&
+                 header.nameHeapOffset <= size && header.dictionaryHeapOffset <= size;
+
+    if (valid)
+    {
+        data = base;
+        length = size;
+        rowCount = rows;
+        dictionaryCount = words;
+        created = static_cast<std::time_t>(header.createdAt);
+        ids = reinterpret_cast<const int32_t *>(base + header.idsOffset);
+        ages = reinterpret_cast<const int32_t *>(base + header.agesOffset);
+        classCodes = reinterpret_cast<const uint32_t *>(base + header.classCodesOffset);
+        nameOffsets = reinterpret_cast<const uint64_t *>(base + header.nameOffsetsOffset);
+        nameHeap = base + header.nameHeapOffset;
+        dictionaryOffsets = reinterpret_cast<const uint64_t *>(base + header.dictionaryOffsetsOffset);
+        dictionaryHeap = base + header.dictionaryHeapOffset;
+
+        // 校验变长部分，之后的访问无需再做边界检查
+        valid = offsetsValid(nameOffsets, rowCount, size - header.nameHeapOffset) &&
+                offsetsValid(dictionaryOffsets, dictionaryCount, size - header.dictionaryHeapOffset) &&
+                std::all_of(classCodes, classCodes + rowCount, [this](uint32_t code)
+                            { return code < dictionaryCount; }) &&
+                std::is_sorted(ids, ids + rowCount);
+    }
+
+    if (!valid)
+    {
+        Logger::warn("快照文件格式无效或已损坏: {}", path);
+        data = base;
+        length = size;
+        close();
+        return false;
+    }
+
+    classIds.reserve(dictionaryCount);
+    for (size_t code = 0; code < dictionaryCount; ++code)
+    {
+        classIds.push_back(ClassNameTable::instance().intern(
+            std::string_view(dictionaryHeap + dictionaryOffsets[code], dictionaryOffsets[code + 1] - dictionaryOffsets[code])));
+    }
+
+    return true;
+}
+
+void StudentSnapshot::close()
+{
+    if (data)
+    {
+        munmap(const_cast<char *>(data), length);
+    }
+
+    data = nullptr;
+    length = 0;
+    rowCount = 0;
+    dictionaryCount = 0;
+    created = 0;
+    ids = nullptr;
+    ages = nullptr;
+    classCodes = nullptr;
+    nameOffsets = nullptr;
+    nameHeap = nullptr;
+    dictionaryOffsets = nullptr;
+    dictionaryHeap = nullptr;
+    classIds.clear();
+}
+
+bool StudentSnapshot::find(int id, StudentView &view) const
+{
+    if (!data)
+        return false;
+
+    const int32_t *end = ids + rowCount;
+    const int32_t *it = std::lower_bound(ids, end, id);
+    if (it == end || *it != id)
+        return false;
+
+    view = viewAt(static_cast<size_t>(it - ids));
+    return true;
+}
+
+long long StudentSnapshot::forEach(const StudentVisitor &visitor) const
+{
+    long long visited = 0;
+    for (size_t row = 0; row < rowCount; ++row)
+    {
+        ++visited;
+        if (!visitor(viewAt(row)))
+            break;
+    }
+    return visited;
+}
+
+StudentView StudentSnapshot::viewAt(size_t row) const
+{
+    uint32_t code = classCodes[row];
+    StudentView view;
+    view.id = ids[row];
+    view.age = ages[row];
+    view.name = std::string_view(nameHeap + nameOffsets[row], nameOffsets[row + 1] - nameOffsets[row]);
+    view.className = std::string_view(dictionaryHeap + dictionaryOffsets[code], dictionaryOffsets[code + 1] - dictionaryOffsets[code]);
+    view.classId = classIds[code];
+    return view;
+}
@@ -0,0 +1,115 @@
+// 请求路径分配计数测试：替换全局operator new统计调用次数，
+// 检查一级缓存命中、响应序列化与缓存值编解码在稳态下（复用输出缓冲）的全局分配次数
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "student.h"
+#include "student_cache.h"
+#include "student_codec.h"
+#include "student_json.h"
+
+namespace
+{
+    std::atomic<size_t> allocationCount{0};
+
+    constexpr int kIterations = 1000;
+    int failures = 0;
+
+    // 返回body执行kIterations次的平均分配次数
+    template <typename Body>
+    double allocationsPerCall(Body body)
+    {
+        // 预热：首次调用允许分配（缓冲扩容、字典登记等）
+        body();
+        size_t before = allocationCount.load();
+        for (int i = 0; i < kIterations; ++i)
+        {
+            body();
+        }
+        return static_cast<double>(allocationCount.load() - before) / kIterations;
+    }
+
+    void expectAtMost(const char *name, double actual, double limit)
+    {
+        bool passed = actual <= limit;
+        std::printf("%-28s 每次分配 %.3f（上限 %.0f）%s\n", name, actual, limit, passed ? "" : "  失败");
+        if (!passed)
+            ++failures;
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void *pointer = std::malloc(size ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+int main()
+{
+    const Student stored("张三", 18, "计算机一班");
+    // 超出短字符串优化长度的姓名，解码时需要复制
+    const Student longName("Alexander Maximilian Fitzgerald", 20, "计算机一班");
+
+    StudentCache::Options options;
+    options.capacityBytes = 1024 * 1024;
+    StudentCache cache(options);
+    cache.insert(1, stored);
+
+    // GET /students/{id}一级缓存命中：查找并序列化响应体
+    Student student;
+    std::string body;
+    body.reserve(256);
+    expectAtMost("一级缓存命中+响应序列化", allocationsPerCall([&]()
+                                                              {
+        cache.find(1, student);
+        body.clear();
+        appendStudentJson(body, 1, student.getName(), student.getAge(), student.getClassId()); }),
+                 0);
+
+    // 回填Redis时的编码
+    std::string encoded;
+    encoded.reserve(256);
+    CacheStamp stamp;
+    stamp.softExpiresAt = 1700000000000;
+    stamp.loadMillis = 3;
+    expectAtMost("二进制编码", allocationsPerCall([&]()
+                                                  {
+        encoded.clear();
+        encodeStudentCache(encoded, stored.getName(), stored.getAge(), stored.getClassId(), stamp); }),
+                 0);
+
+    // Redis命中时的解码：直接读取回复缓冲，只有构造Student时复制姓名
+    std::string value;
+    encodeStudentCache(value, stored.getName(), stored.getAge(), stored.getClassId(), stamp);
+    expectAtMost("二进制解码", allocationsPerCall([&]()
+                                                  { decodeStudentCache(value, student, &stamp); }),
+                 0);
+
+    std::string longValue;
+    encodeStudentCache(longValue, longName.getName(), longName.getAge(), longName.getClassId(), stamp);
+    expectAtMost("二进制解码（长姓名）", allocationsPerCall([&]()
+                                                        { decodeStudentCache(longValue, student, &stamp); }),
+                 1);
+
+    if (failures > 0)
+    {
+        std::printf("%d 项超出分配上限\n", failures);
+        return 1;
+    }
+    std::printf("全部通过\n");
+    return 0;
+}